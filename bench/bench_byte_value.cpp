@@ -0,0 +1,99 @@
+#include "byte_value.h"
+#include "bench_support.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace Bluetooth;
+
+// ByteValue与std::vector<uint8_t>的构造、拷贝和追加开销，以及每次操作的堆分配次数
+
+static std::atomic<size_t> allocation_count(0);
+
+void* operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+template <typename Function>
+static void measure(const char* name, size_t iterations, Function body) {
+    size_t before = allocation_count.load();
+    double ns = BenchSupport::measureNs(iterations, body);
+    // measureNs另外执行十分之一的预热
+    size_t calls = iterations + iterations / 10;
+    double allocations = static_cast<double>(allocation_count.load() - before) / static_cast<double>(calls);
+    std::printf("%-40s %10.1f ns/op %8.2f allocs/op\n", name, ns, allocations);
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = BenchSupport::iterations(argc, argv, 1000000);
+
+    for (size_t size : { 4, 20, 23, 64, 244 }) {
+        std::vector<uint8_t> source(size, 0x42);
+        ByteValue value(source.data(), source.size());
+        std::vector<uint8_t> vector_value(source);
+        std::printf("value size %zu bytes (inline capacity %zu), %zu iterations\n",
+                    size, ByteValue::INLINE_CAPACITY, iterations);
+
+        measure("construct: std::vector", iterations, [&](size_t) {
+            std::vector<uint8_t> copy(source.data(), source.data() + size);
+            doNotOptimize(copy);
+        });
+        measure("construct: ByteValue", iterations, [&](size_t) {
+            ByteValue copy(source.data(), size);
+            doNotOptimize(copy);
+        });
+        measure("copy: std::vector", iterations, [&](size_t) {
+            std::vector<uint8_t> copy(vector_value);
+            doNotOptimize(copy);
+        });
+        measure("copy: ByteValue", iterations, [&](size_t) {
+            ByteValue copy(value);
+            doNotOptimize(copy);
+        });
+
+        // 复用同一对象逐字节追加，模拟接收缓冲
+        std::vector<uint8_t> vector_buffer;
+        measure("append bytes: std::vector (reused)", iterations / 10, [&](size_t) {
+            vector_buffer.clear();
+            for (size_t i = 0; i < size; ++i) {
+                vector_buffer.push_back(static_cast<uint8_t>(i));
+            }
+            doNotOptimize(vector_buffer);
+        });
+        ByteValue buffer;
+        measure("append bytes: ByteValue (reused)", iterations / 10, [&](size_t) {
+            buffer.clear();
+            for (size_t i = 0; i < size; ++i) {
+                buffer.push_back(static_cast<uint8_t>(i));
+            }
+            doNotOptimize(buffer);
+        });
+    }
+
+    return 0;
+}
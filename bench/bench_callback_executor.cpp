@@ -0,0 +1,125 @@
+#include "callback_executor.h"
+#include "bench_support.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Bluetooth;
+
+// 慢速读写回调（sleep模拟传感器读取）期间主循环的空闲源延迟：
+// 回调直接在主循环中调用 / 经CallbackExecutor在工作线程中调用
+
+// 探测线程按固定间隔向主上下文添加空闲源，记录添加到执行的间隔；
+// 探测独立于主循环产生，主循环被回调阻塞时延迟如实累积
+struct Probe {
+    std::vector<double> latencies_us;
+    std::atomic<bool> stop{ false };
+};
+
+struct ProbeEvent {
+    Probe* probe;
+    gint64 scheduled_at;
+};
+
+static gboolean onProbeIdle(gpointer user_data) {
+    ProbeEvent* event = static_cast<ProbeEvent*>(user_data);
+    event->probe->latencies_us.push_back(static_cast<double>(g_get_monotonic_time() - event->scheduled_at));
+    delete event;
+    return G_SOURCE_REMOVE;
+}
+
+static void probeThread(Probe* probe) {
+    while (!probe->stop.load(std::memory_order_acquire)) {
+        g_idle_add(onProbeIdle, new ProbeEvent{ probe, g_get_monotonic_time() });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+struct Load {
+    CallbackExecutor* executor = nullptr;
+    guint callback_ms = 0;
+    uint64_t completed = 0;
+};
+
+static void slowCallback(guint callback_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(callback_ms));
+}
+
+// 模拟ReadValue请求到达：没有执行器时在主循环中同步调用回调
+static gboolean onRequestTimer(gpointer user_data) {
+    Load* load = static_cast<Load*>(user_data);
+    guint callback_ms = load->callback_ms;
+    if (!load->executor) {
+        slowCallback(callback_ms);
+        load->completed++;
+    } else {
+        load->executor->submit([callback_ms]() { slowCallback(callback_ms); }, [load]() { load->completed++; });
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean onDeadline(gpointer user_data) {
+    *static_cast<bool*>(user_data) = true;
+    return G_SOURCE_REMOVE;
+}
+
+// callback_ms为0时没有请求，只测空载的基线
+static void run(const char* name, CallbackExecutor* executor, guint callback_ms, guint duration_ms) {
+    Probe probe;
+    Load load;
+    load.executor = executor;
+    load.callback_ms = callback_ms;
+
+    std::thread prober(probeThread, &probe);
+    guint request_id = callback_ms > 0 ? g_timeout_add(callback_ms * 2, onRequestTimer, &load) : 0;
+    bool expired = false;
+    g_timeout_add(duration_ms, onDeadline, &expired);
+
+    while (!expired) {
+        g_main_context_iteration(nullptr, TRUE);
+    }
+    probe.stop.store(true, std::memory_order_release);
+    prober.join();
+    if (request_id != 0) {
+        g_source_remove(request_id);
+    }
+
+    // 收尾：等待执行器中的回调完成，剩余的探测照常计入
+    while (executor && executor->getStatistics().queued + executor->getStatistics().running > 0) {
+        g_main_context_iteration(nullptr, FALSE);
+    }
+    while (g_main_context_iteration(nullptr, FALSE)) {
+    }
+
+    std::vector<double>& samples = probe.latencies_us;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    double mean = samples.empty() ? 0.0 : sum / static_cast<double>(samples.size());
+    double p99 = samples.empty() ? 0.0 : samples[samples.size() * 99 / 100];
+    double max = samples.empty() ? 0.0 : samples.back();
+    std::printf("%-40s mean %8.1f us  p99 %8.1f us  max %8.1f us  (%llu callbacks)\n", name, mean, p99, max,
+                static_cast<unsigned long long>(load.completed));
+}
+
+int main(int argc, char** argv) {
+    guint duration_ms = static_cast<guint>(BenchSupport::iterations(argc, argv, 1000));
+
+    run("idle latency: no requests", nullptr, 0, duration_ms);
+
+    ExecutorConfig config;
+    config.max_threads = 4;
+    CallbackExecutor executor(config);
+
+    for (guint callback_ms : { 2, 10 }) {
+        std::printf("callback sleeps %u ms, one request every %u ms, %u ms per run\n",
+                    callback_ms, callback_ms * 2, duration_ms);
+        run("idle latency: callbacks on main loop", nullptr, callback_ms, duration_ms);
+        run("idle latency: callbacks on executor", &executor, callback_ms, duration_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "coroutine_support.h"
+#include "async_completion.h"
+#include "bench_support.h"
+#include <chrono>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace Bluetooth;
+
+// 协程处理函数与同步回调的对比：
+// 每个请求需要等待外设若干毫秒，同步回调阻塞主循环，协程挂起期间其他请求继续处理；
+// 以及外设已就绪时（fd可读）每个请求的协程和完成状态开销
+
+// 同步读取回调：阻塞等待外设
+static ByteValue syncRead(guint delay_ms, uint8_t byte) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+    return ByteValue{ byte };
+}
+
+// 协程读取处理函数：挂起等待外设
+static CoTask coroutineRead(guint delay_ms, uint8_t byte, ReadCompletion completion) {
+    co_await sleepFor(delay_ms);
+    completion.complete(ByteValue{ byte });
+}
+
+// 协程读取处理函数：等待fd可读后读取一个字节
+static CoTask coroutineReadFd(int fd, ReadCompletion completion) {
+    GIOCondition ready = co_await waitForFd(fd, G_IO_IN);
+    uint8_t byte = 0;
+    if ((ready & G_IO_IN) && read(fd, &byte, 1) == 1) {
+        completion.complete(ByteValue{ byte });
+    } else {
+        completion.fail(AttError::FAILED);
+    }
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = BenchSupport::iterations(argc, argv, 100000);
+    const guint delay_ms = 5;
+
+    // 并发请求：N个请求各等待delay_ms
+    std::printf("%u ms peripheral wait per request\n", delay_ms);
+    for (size_t count : { 1, 8, 64, 256 }) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            ByteValue value = syncRead(delay_ms, static_cast<uint8_t>(i));
+            doNotOptimize(value);
+        }
+        double sync_ms = elapsedMs(start);
+
+        size_t finished = 0;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            auto state = CompletionState::create([&finished](const CompletionResult& result) {
+                doNotOptimize(result);
+                ++finished;
+            }, ASYNC_CALLBACK_DEFAULT_TIMEOUT_MS);
+            coroutineRead(delay_ms, static_cast<uint8_t>(i), ReadCompletion(state));
+        }
+        while (finished < count) {
+            g_main_context_iteration(nullptr, TRUE);
+        }
+        double coroutine_ms = elapsedMs(start);
+
+        std::printf("%4zu requests: synchronous %9.1f ms, coroutine %7.1f ms\n", count, sync_ms, coroutine_ms);
+    }
+
+    // 外设已就绪：逐个请求的开销，包括协程帧、fd源和主循环中交付完成结果
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        return 1;
+    }
+    uint8_t byte = 0x42;
+
+    BenchSupport::report("synchronous callback", BenchSupport::measureNs(iterations, [&](size_t i) {
+        ByteValue value{ static_cast<uint8_t>(i) };
+        doNotOptimize(value);
+    }));
+
+    BenchSupport::report("coroutine: fd ready -> completion delivered", BenchSupport::measureNs(iterations, [&](size_t) {
+        bool done = false;
+        auto state = CompletionState::create([&done](const CompletionResult&) { done = true; }, 0);
+        if (write(fds[1], &byte, 1) != 1) {
+            return;
+        }
+        coroutineReadFd(fds[0], ReadCompletion(state));
+        while (!done) {
+            g_main_context_iteration(nullptr, TRUE);
+        }
+    }));
+
+    close(fds[0]);
+    close(fds[1]);
+    return 0;
+}
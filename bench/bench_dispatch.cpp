@@ -0,0 +1,136 @@
+#include "dbus_dispatch.h"
+#include "bench_support.h"
+#include <glib-2.0/glib.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Bluetooth;
+
+// 属性分派开销：g_strcmp0链 + 按路径后缀查找对象 vs 完美哈希表 + 注册时的user_data，
+// 对象数从几十到几千，请求按对象和属性名轮换
+
+enum class Property {
+    UUID,
+    FLAGS,
+    NOTIFYING,
+    VALUE,
+    WRITE_ACQUIRED,
+    NOTIFY_ACQUIRED
+};
+
+static constexpr auto PROPERTIES = makeNameTable<Property>({
+    { "UUID", Property::UUID },
+    { "Flags", Property::FLAGS },
+    { "Notifying", Property::NOTIFYING },
+    { "Value", Property::VALUE },
+    { "WriteAcquired", Property::WRITE_ACQUIRED },
+    { "NotifyAcquired", Property::NOTIFY_ACQUIRED }
+});
+static_assert(PROPERTIES.isValid(), "No perfect hash seed for benchmark properties");
+
+static const char* const PROPERTY_NAMES[] = {
+    "UUID", "Flags", "Notifying", "Value", "WriteAcquired", "NotifyAcquired"
+};
+static const size_t PROPERTY_COUNT = sizeof(PROPERTY_NAMES) / sizeof(PROPERTY_NAMES[0]);
+
+struct Object {
+    std::string path;
+    std::string suffix;
+    int values[PROPERTY_COUNT];
+};
+
+static int readProperty(const Object& object, Property property) {
+    return object.values[static_cast<size_t>(property)];
+}
+
+// 旧的分派方式：属性名逐个比较，对象按路径后缀逐个匹配
+static int dispatchByStrcmp(const std::vector<Object>& objects, const char* object_path, const char* property_name) {
+    Property property;
+    if (g_strcmp0(property_name, "UUID") == 0) {
+        property = Property::UUID;
+    } else if (g_strcmp0(property_name, "Flags") == 0) {
+        property = Property::FLAGS;
+    } else if (g_strcmp0(property_name, "Notifying") == 0) {
+        property = Property::NOTIFYING;
+    } else if (g_strcmp0(property_name, "Value") == 0) {
+        property = Property::VALUE;
+    } else if (g_strcmp0(property_name, "WriteAcquired") == 0) {
+        property = Property::WRITE_ACQUIRED;
+    } else if (g_strcmp0(property_name, "NotifyAcquired") == 0) {
+        property = Property::NOTIFY_ACQUIRED;
+    } else {
+        return -1;
+    }
+
+    for (const auto& object : objects) {
+        if (g_str_has_suffix(object_path, object.suffix.c_str())) {
+            return readProperty(object, property);
+        }
+    }
+    return -1;
+}
+
+// 中间方案：名称查完美哈希表，对象仍按完整路径查哈希表
+static int dispatchByPathMap(const std::unordered_map<std::string, const Object*>& by_path,
+                             const char* object_path, const char* property_name) {
+    Property property;
+    if (!PROPERTIES.find(property_name, property)) {
+        return -1;
+    }
+
+    auto it = by_path.find(object_path);
+    return it != by_path.end() ? readProperty(*it->second, property) : -1;
+}
+
+// 当前的分派方式：对象来自注册时的user_data，名称查完美哈希表
+static int dispatchByNameTable(const void* user_data, const char* property_name) {
+    Property property;
+    if (!PROPERTIES.find(property_name, property)) {
+        return -1;
+    }
+    return readProperty(*static_cast<const Object*>(user_data), property);
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = BenchSupport::iterations(argc, argv, 200000);
+
+    for (size_t object_count : { 16, 256, 1024, 4096 }) {
+        std::vector<Object> objects(object_count);
+        std::unordered_map<std::string, const Object*> by_path;
+        for (size_t i = 0; i < object_count; ++i) {
+            Object& object = objects[i];
+            object.suffix = "service" + std::to_string(i / 8) + "/char" + std::to_string(i % 8);
+            object.path = "/org/bluez/example/" + object.suffix;
+            for (size_t p = 0; p < PROPERTY_COUNT; ++p) {
+                object.values[p] = static_cast<int>(i * PROPERTY_COUNT + p);
+            }
+        }
+        for (const auto& object : objects) {
+            by_path.emplace(object.path, &object);
+        }
+
+        // 按固定步长遍历对象，避免请求集中在表头
+        auto objectIndex = [object_count](size_t i) { return (i * 7919) % object_count; };
+        std::printf("%zu objects, %zu iterations\n", object_count, iterations);
+
+        // 线性查找的代价随对象数增长，迭代次数按比例缩减
+        size_t strcmp_iterations = std::max<size_t>(iterations / (object_count / 16), 1000);
+        BenchSupport::report("g_strcmp0 chain + path suffix scan",
+                             BenchSupport::measureNs(strcmp_iterations, [&](size_t i) {
+            const Object& object = objects[objectIndex(i)];
+            doNotOptimize(dispatchByStrcmp(objects, object.path.c_str(), PROPERTY_NAMES[i % PROPERTY_COUNT]));
+        }));
+        BenchSupport::report("name table + path hash map", BenchSupport::measureNs(iterations, [&](size_t i) {
+            const Object& object = objects[objectIndex(i)];
+            doNotOptimize(dispatchByPathMap(by_path, object.path.c_str(), PROPERTY_NAMES[i % PROPERTY_COUNT]));
+        }));
+        BenchSupport::report("name table + user_data", BenchSupport::measureNs(iterations, [&](size_t i) {
+            const Object& object = objects[objectIndex(i)];
+            doNotOptimize(dispatchByNameTable(&object, PROPERTY_NAMES[i % PROPERTY_COUNT]));
+        }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "payload_codec.h"
+#include "bench_support.h"
+#include <cmath>
+#include <vector>
+
+using namespace Bluetooth;
+
+// 负载编码的压缩率和每帧编解码耗时（编码端延迟 + 参考解码器延迟）
+
+// 模拟固定格式采样帧：若干16位小端字段，数值缓慢变化，其余字节为不变的状态和保留位
+static std::vector<ByteValue> makeFrames(size_t frame_size, size_t count) {
+    std::vector<ByteValue> frames;
+    frames.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        ByteValue frame(frame_size, 0);
+        for (size_t field = 0; field < 4 && field * 2 + 1 < frame_size; ++field) {
+            int value = 1000 + static_cast<int>(200.0 * std::sin((i + field * 7) * 0.05));
+            frame[field * 2] = static_cast<uint8_t>(value);
+            frame[field * 2 + 1] = static_cast<uint8_t>(value >> 8);
+        }
+        frame[frame_size - 1] = static_cast<uint8_t>(i / 100);
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+static void run(const char* name, PayloadEncoding mode, const std::vector<ByteValue>& frames, size_t iterations) {
+    PayloadEncodingConfig config;
+    config.mode = mode;
+    config.word_size = 2;
+
+    // 压缩率：一遍完整的帧序列
+    PayloadEncoder ratio_encoder(config);
+    for (const auto& frame : frames) {
+        doNotOptimize(ratio_encoder.encode(frame));
+    }
+    const PayloadEncodingStatistics& stats = ratio_encoder.getStatistics();
+    double ratio = stats.raw_bytes ? static_cast<double>(stats.encoded_bytes) / stats.raw_bytes : 1.0;
+
+    PayloadEncoder encoder(config);
+    std::vector<ByteValue> encoded(frames.size());
+    double encode_ns = BenchSupport::measureNs(iterations, [&](size_t i) {
+        size_t index = i % frames.size();
+        encoded[index] = encoder.encode(frames[index]);
+    });
+
+    // 解码端按顺序解码同一编码流
+    PayloadEncoder stream_encoder(config);
+    std::vector<ByteValue> stream;
+    for (const auto& frame : frames) {
+        stream.push_back(stream_encoder.encode(frame));
+    }
+    PayloadDecoder decoder(config);
+    std::vector<uint8_t> value;
+    double decode_ns = BenchSupport::measureNs(iterations, [&](size_t i) {
+        const ByteValue& frame = stream[i % stream.size()];
+        doNotOptimize(decoder.decode(frame.data(), frame.size(), value));
+    });
+
+    std::printf("%-8s encoded/raw %5.1f%%  keyframes %6llu  ", name, ratio * 100.0,
+                static_cast<unsigned long long>(stats.keyframes));
+    std::printf("encode %8.1f ns/frame  decode %8.1f ns/frame\n", encode_ns, decode_ns);
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = BenchSupport::iterations(argc, argv, 200000);
+
+    for (size_t frame_size : { 20, 64, 244 }) {
+        std::vector<ByteValue> frames = makeFrames(frame_size, 1000);
+        std::printf("frame size %zu bytes, %zu iterations\n", frame_size, iterations);
+        run("NONE", PayloadEncoding::NONE, frames, iterations);
+        run("XOR", PayloadEncoding::XOR, frames, iterations);
+        run("DELTA", PayloadEncoding::DELTA, frames, iterations);
+    }
+
+    return 0;
+}
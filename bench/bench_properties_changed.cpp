@@ -0,0 +1,62 @@
+#include "properties_changed_template.h"
+#include "bench_support.h"
+#include <vector>
+
+using namespace Bluetooth;
+
+// PropertiesChanged构建开销：逐次按格式串构建 vs 复制模板消息并拼接消息体；
+// 同时给出包含序列化（g_dbus_message_send实际执行的部分）的端到端开销
+
+static const char* const OBJECT_PATH = "/org/bluez/example/service0/char0";
+static const char* const INTERFACE_NAME = "org.bluez.GattCharacteristic1";
+
+static GVariant* valueVariant(const std::vector<uint8_t>& value) {
+    return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, value.data(), value.size(), sizeof(uint8_t));
+}
+
+static GDBusMessage* buildFromFormat(const std::vector<uint8_t>& value) {
+    GDBusMessage* message = g_dbus_message_new_signal(OBJECT_PATH, "org.freedesktop.DBus.Properties",
+                                                      "PropertiesChanged");
+    GVariantBuilder changed;
+    g_variant_builder_init(&changed, G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(&changed, "{sv}", "Value", valueVariant(value));
+    g_dbus_message_set_body(message, g_variant_new("(sa{sv}as)", INTERFACE_NAME, &changed, nullptr));
+    return message;
+}
+
+static void serialize(GDBusMessage* message, size_t serial) {
+    gsize size = 0;
+    g_dbus_message_set_serial(message, static_cast<guint32>(serial + 1));
+    guchar* blob = g_dbus_message_to_blob(message, &size, G_DBUS_CAPABILITY_FLAGS_NONE, nullptr);
+    doNotOptimize(size);
+    g_free(blob);
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = BenchSupport::iterations(argc, argv, 100000);
+    PropertiesChangedTemplate signal_template(OBJECT_PATH, INTERFACE_NAME, "Value");
+
+    for (size_t value_size : { 20, 244 }) {
+        std::vector<uint8_t> value(value_size, 0x5a);
+        std::printf("value size %zu bytes, %zu iterations\n", value_size, iterations);
+
+        BenchSupport::report("build: format string", BenchSupport::measureNs(iterations, [&](size_t) {
+            g_object_unref(buildFromFormat(value));
+        }));
+        BenchSupport::report("build: template copy", BenchSupport::measureNs(iterations, [&](size_t) {
+            g_object_unref(signal_template.build(valueVariant(value)));
+        }));
+        BenchSupport::report("build+serialize: format string", BenchSupport::measureNs(iterations, [&](size_t i) {
+            GDBusMessage* message = buildFromFormat(value);
+            serialize(message, i);
+            g_object_unref(message);
+        }));
+        BenchSupport::report("build+serialize: template copy", BenchSupport::measureNs(iterations, [&](size_t i) {
+            GDBusMessage* message = signal_template.build(valueVariant(value));
+            serialize(message, i);
+            g_object_unref(message);
+        }));
+    }
+
+    return 0;
+}
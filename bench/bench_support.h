@@ -0,0 +1,62 @@
+#ifndef BENCH_SUPPORT_H
+#define BENCH_SUPPORT_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+
+// 基准辅助：不依赖基准框架，每个基准是独立的可执行文件，结果打印到标准输出
+
+namespace BenchSupport {
+
+/**
+ * @brief 从命令行读取迭代次数
+ * @param argc 参数个数
+ * @param argv 参数
+ * @param default_iterations 未指定时的迭代次数
+ * @return 迭代次数
+ */
+inline size_t iterations(int argc, char** argv, size_t default_iterations) {
+    if (argc > 1) {
+        long value = std::strtol(argv[1], nullptr, 10);
+        if (value > 0) {
+            return static_cast<size_t>(value);
+        }
+    }
+    return default_iterations;
+}
+
+/**
+ * @brief 测量每次调用的平均耗时，先以十分之一的次数预热
+ * @param iterations 迭代次数
+ * @param body 被测函数，参数为迭代序号
+ * @return 每次调用的纳秒数
+ */
+template <typename Function>
+double measureNs(size_t iterations, Function body) {
+    for (size_t i = 0; i < iterations / 10; ++i) {
+        body(i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+inline void report(const char* name, double ns_per_op) {
+    std::printf("%-48s %12.1f ns/op\n", name, ns_per_op);
+}
+
+} // namespace BenchSupport
+
+// 防止编译器优化掉基准结果
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif // BENCH_SUPPORT_H
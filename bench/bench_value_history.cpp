@@ -0,0 +1,106 @@
+#include "value_history.h"
+#include "bench_support.h"
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <vector>
+
+using namespace Bluetooth;
+
+// 环形历史记录的追加吞吐和回放耗时，对照按样本分配的std::deque<std::vector<uint8_t>>
+
+static std::atomic<size_t> allocation_count(0);
+
+void* operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+template <typename Function>
+static void measure(const char* name, size_t iterations, Function body) {
+    size_t before = allocation_count.load();
+    double ns = BenchSupport::measureNs(iterations, body);
+    // measureNs另外执行十分之一的预热
+    size_t calls = iterations + iterations / 10;
+    double allocations = static_cast<double>(allocation_count.load() - before) / static_cast<double>(calls);
+    std::printf("%-40s %10.1f ns/op %8.2f allocs/op\n", name, ns, allocations);
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = BenchSupport::iterations(argc, argv, 1000000);
+    const size_t capacity = 1024;
+    const size_t replay_count = 32;
+
+    for (size_t size : { 20, 244 }) {
+        std::vector<uint8_t> sample(size, 0x42);
+        std::printf("value size %zu bytes, capacity %zu, %zu iterations\n", size, capacity, iterations);
+
+        // 追加：预先写满，测量的是稳定状态下覆盖最旧样本的开销
+        ValueHistory history(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            history.append(sample.data(), size, static_cast<gint64>(i));
+        }
+        gint64 timestamp = static_cast<gint64>(capacity);
+        measure("append: ValueHistory", iterations, [&](size_t) {
+            doNotOptimize(history.append(sample.data(), size, timestamp++));
+        });
+
+        std::deque<std::vector<uint8_t>> baseline;
+        std::deque<gint64> baseline_timestamps;
+        for (size_t i = 0; i < capacity; ++i) {
+            baseline.emplace_back(sample);
+            baseline_timestamps.push_back(static_cast<gint64>(i));
+        }
+        gint64 baseline_timestamp = static_cast<gint64>(capacity);
+        measure("append: deque<vector> (baseline)", iterations, [&](size_t) {
+            baseline.pop_front();
+            baseline_timestamps.pop_front();
+            baseline.emplace_back(sample);
+            baseline_timestamps.push_back(baseline_timestamp++);
+            doNotOptimize(baseline.back());
+        });
+
+        // 回放：新订阅者加入时访问最近的若干样本
+        size_t replayed_bytes = 0;
+        HistoryVisitor visitor = [&replayed_bytes](gint64, const uint8_t* data, size_t length) {
+            replayed_bytes += length;
+            doNotOptimize(data);
+        };
+        measure("replay latest 32: visitLatest", iterations / 10, [&](size_t) {
+            doNotOptimize(history.visitLatest(replay_count, visitor));
+        });
+
+        // 时间范围查询：二分定位后访问同样数量的样本
+        measure("query 32-sample range", iterations / 10, [&](size_t i) {
+            gint64 to = timestamp - 1 - static_cast<gint64>(i % (capacity - replay_count));
+            doNotOptimize(history.query(to - static_cast<gint64>(replay_count) + 1, to, visitor));
+        });
+        doNotOptimize(replayed_bytes);
+    }
+
+    return 0;
+}
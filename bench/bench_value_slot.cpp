@@ -0,0 +1,84 @@
+#include "value_slot.h"
+#include "bench_support.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+using namespace Bluetooth;
+
+// 值槽的发布开销（唤醒已挂起 / 每次都唤醒主循环）和生产者发布到主循环回调的往返延迟
+
+static void encodeCounter(uint64_t counter, uint8_t* buffer) {
+    std::memcpy(buffer, &counter, sizeof(counter));
+}
+
+static uint64_t decodeCounter(const ByteValue& value) {
+    uint64_t counter = 0;
+    if (value.size() == sizeof(counter)) {
+        std::memcpy(&counter, value.data(), sizeof(counter));
+    }
+    return counter;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = BenchSupport::iterations(argc, argv, 1000000);
+
+    for (size_t size : { 8, 20, 244 }) {
+        GMainContext* context = g_main_context_new();
+        auto slot = std::make_shared<ValueSlot>(size);
+        ValueSlotWatch watch(slot, nullptr, context);
+        uint8_t payload[512] = {};
+        std::printf("value size %zu bytes, %zu iterations\n", size, iterations);
+
+        // 主循环不迭代，第一次发布之后唤醒一直挂起，只测seqlock写入
+        BenchSupport::report("publish: wakeup pending", BenchSupport::measureNs(iterations, [&](size_t i) {
+            payload[0] = static_cast<uint8_t>(i);
+            slot->publish(payload, size);
+        }));
+
+        // 每次发布前清除标记，模拟主循环已处理完上一次唤醒
+        BenchSupport::report("publish: with g_main_context_wakeup", BenchSupport::measureNs(iterations / 10, [&](size_t i) {
+            payload[0] = static_cast<uint8_t>(i);
+            slot->clearWakeup();
+            slot->publish(payload, size);
+        }));
+
+        g_main_context_unref(context);
+    }
+
+    // 往返：生产者发布后等待主循环回调确认，再发布下一个值
+    GMainContext* context = g_main_context_new();
+    auto slot = std::make_shared<ValueSlot>(sizeof(uint64_t));
+    std::atomic<uint64_t> acknowledged(0);
+    ValueSlotWatch watch(slot, [&acknowledged](const ByteValue& value) {
+        acknowledged.store(decodeCounter(value), std::memory_order_release);
+    }, context);
+
+    const uint64_t rounds = iterations / 10;
+    std::atomic<bool> done(false);
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        uint8_t buffer[sizeof(uint64_t)];
+        for (uint64_t round = 1; round <= rounds; ++round) {
+            encodeCounter(round, buffer);
+            slot->publish(buffer, sizeof(buffer));
+            while (acknowledged.load(std::memory_order_acquire) != round) {
+                std::this_thread::yield();
+            }
+        }
+        done.store(true, std::memory_order_release);
+        g_main_context_wakeup(context);
+    });
+
+    while (!done.load(std::memory_order_acquire)) {
+        g_main_context_iteration(context, TRUE);
+    }
+    producer.join();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    BenchSupport::report("publish -> callback round trip", elapsed.count() / static_cast<double>(rounds));
+
+    g_main_context_unref(context);
+    return 0;
+}
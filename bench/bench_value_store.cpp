@@ -0,0 +1,120 @@
+#include "value_store.h"
+#include "bench_support.h"
+#include <chrono>
+#include <string>
+#include <unistd.h>
+
+using namespace Bluetooth;
+
+// 持久化的写入吞吐（每条记录一次提交 / 组提交）和大日志的启动恢复耗时
+
+static const char* const UUIDS[] = {
+    "0000e000-0000-1000-8000-00805f9b34fb",
+    "0000e001-0000-1000-8000-00805f9b34fb",
+    "0000e002-0000-1000-8000-00805f9b34fb",
+    "0000e003-0000-1000-8000-00805f9b34fb",
+};
+static const size_t UUID_COUNT = sizeof(UUIDS) / sizeof(UUIDS[0]);
+
+static std::string makeDirectory() {
+    gchar* temp = g_dir_make_tmp("bench-value-store-XXXXXX", nullptr);
+    if (!temp) {
+        std::fprintf(stderr, "Failed to create temporary directory\n");
+        std::exit(1);
+    }
+    std::string directory(temp);
+    g_free(temp);
+    return directory;
+}
+
+static void removeDirectory(const std::string& directory) {
+    unlink((directory + "/values.log").c_str());
+    unlink((directory + "/values.snapshot").c_str());
+    rmdir(directory.c_str());
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = BenchSupport::iterations(argc, argv, 20000);
+
+    // 提交由基准显式调用，不依赖主循环中的提交定时器；不触发压缩
+    ValueStoreConfig config;
+    config.commit_interval_ms = 60000;
+    config.max_batch_bytes = SIZE_MAX;
+    config.compaction_threshold_bytes = SIZE_MAX;
+
+    for (size_t size : { 20, 244 }) {
+        ByteValue value(size, 0x5a);
+        std::printf("value size %zu bytes, %zu iterations\n", size, iterations);
+
+        // 每批记录共用一次write+fdatasync，批量为1即每次写入都落盘
+        for (size_t batch : { 1, 16, 256 }) {
+            std::string directory = makeDirectory();
+            ValueStore store(directory, config);
+            if (!store.open()) {
+                return 1;
+            }
+
+            size_t appends = batch == 1 ? iterations / 10 : iterations;
+            double ns = BenchSupport::measureNs(appends, [&](size_t i) {
+                value[0] = static_cast<uint8_t>(i);
+                store.append(UUIDS[i % UUID_COUNT], value.data(), value.size());
+                if ((i + 1) % batch == 0) {
+                    store.commit();
+                }
+            });
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "append + commit every %zu", batch);
+            BenchSupport::report(name, ns);
+
+            store.close();
+            removeDirectory(directory);
+        }
+    }
+
+    // 恢复：写出数MB的日志后重新打开，open()按记录回放整个日志
+    for (size_t log_mb : { 4, 16 }) {
+        std::string directory = makeDirectory();
+        ByteValue value(244, 0x33);
+        uint64_t records = 0;
+        {
+            ValueStore store(directory, config);
+            if (!store.open()) {
+                return 1;
+            }
+            size_t target = log_mb * 1024 * 1024;
+            size_t written = 0;
+            while (written < target) {
+                value[0] = static_cast<uint8_t>(records);
+                store.append(UUIDS[records % UUID_COUNT], value.data(), value.size());
+                written += value.size();
+                if (++records % 4096 == 0) {
+                    store.commit();
+                }
+            }
+            store.close();
+        }
+
+        ValueStore reopened(directory, config);
+        auto start = std::chrono::steady_clock::now();
+        bool opened = reopened.open();
+        double ms = elapsedMs(start);
+        doNotOptimize(opened);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "open(): replay %zu MB log", log_mb);
+        std::printf("%-48s %12.1f ms (%llu records, %.0f ns/record)\n", name, ms,
+                    static_cast<unsigned long long>(reopened.getStatistics().recovered),
+                    ms * 1e6 / static_cast<double>(records));
+
+        reopened.close();
+        removeDirectory(directory);
+    }
+
+    return 0;
+}
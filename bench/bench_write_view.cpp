@@ -0,0 +1,109 @@
+#include "gatt_characteristic.h"
+#include "bench_support.h"
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+using namespace Bluetooth;
+
+// WriteValue处理开销：WriteCallback（请求数据复制为ByteValue） vs WriteViewCallback（直接引用请求中的数组），
+// 分别给出接受和拒绝时的耗时与每次写入的堆分配次数
+
+// 替换malloc族函数计数，GLib内部的分配同样计入
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+extern "C" void __libc_free(void* pointer);
+
+static std::atomic<size_t> allocation_count(0);
+
+extern "C" void* malloc(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void free(void* pointer) {
+    __libc_free(pointer);
+}
+
+// 公开受保护的WriteValue处理入口，跳过D-Bus消息收发
+class BenchCharacteristic : public GattCharacteristic {
+public:
+    BenchCharacteristic()
+        : GattCharacteristic("0000bbbb-0000-1000-8000-00805f9b34fb",
+                             { CharacteristicFlags::READ, CharacteristicFlags::WRITE }) {
+    }
+
+    bool write(GVariant* value, GVariant* options) {
+        return handleWriteValue(value, options);
+    }
+};
+
+template <typename Function>
+static void measure(const char* name, size_t iterations, Function body) {
+    size_t before = allocation_count.load();
+    double ns = BenchSupport::measureNs(iterations, body);
+    // measureNs另外执行十分之一的预热
+    size_t calls = iterations + iterations / 10;
+    double allocations = static_cast<double>(allocation_count.load() - before) / static_cast<double>(calls);
+    std::printf("%-40s %10.1f ns/op %8.2f allocs/op\n", name, ns, allocations);
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = BenchSupport::iterations(argc, argv, 200000);
+
+    // 两种回调解析选项的开销相同且由GLib的字典查找主导，这里不传选项，只比较值的处理
+    GVariant* options = nullptr;
+
+    // handleWriteValue每次写入都打印日志，测量时关闭标准输出，只计算处理本身
+    std::cout.setstate(std::ios::failbit);
+
+    for (size_t size : { 20, 244 }) {
+        std::vector<uint8_t> payload(size, 0x3c);
+        GVariant* value = g_variant_ref_sink(
+            g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, payload.data(), payload.size(), sizeof(uint8_t)));
+        std::printf("value size %zu bytes, %zu iterations\n", size, iterations);
+
+        for (bool accept : { true, false }) {
+            BenchCharacteristic copy_characteristic;
+            copy_characteristic.setWriteCallback([accept](const std::string&, const ByteValue& data) {
+                doNotOptimize(data);
+                return accept;
+            });
+            BenchCharacteristic view_characteristic;
+            view_characteristic.setWriteViewCallback([accept](const ByteView& data, const AccessOptions&) {
+                doNotOptimize(data);
+                return accept;
+            });
+
+            // 拒绝时handleWriteValue打印到标准错误，同样关闭
+            if (!accept) {
+                std::cerr.setstate(std::ios::failbit);
+            }
+            measure(accept ? "accept: WriteCallback (copy)" : "reject: WriteCallback (copy)",
+                    iterations, [&](size_t) {
+                doNotOptimize(copy_characteristic.write(value, options));
+            });
+            measure(accept ? "accept: WriteViewCallback (view)" : "reject: WriteViewCallback (view)",
+                    iterations, [&](size_t) {
+                doNotOptimize(view_characteristic.write(value, options));
+            });
+            std::cerr.clear();
+        }
+
+        g_variant_unref(value);
+    }
+
+    std::cout.clear();
+    return 0;
+}
@@ -121,24 +121,23 @@ private:
     uint16_t max_advertising_interval_;
 
     // D-Bus方法处理
-    static GVariant* methodRelease(GDBusConnection* connection,
-                                  const gchar* sender,
-                                  const gchar* object_path,
-                                  const gchar* interface_name,
-                                  const gchar* method_name,
-                                  GVariant* parameters,
-                                  gpointer user_data,
-                                  GDBusMethodInvocation* invocation);
+    static void methodRelease(GDBusConnection* connection,
+                              const gchar* sender,
+                              const gchar* object_path,
+                              const gchar* interface_name,
+                              const gchar* method_name,
+                              GVariant* parameters,
+                              GDBusMethodInvocation* invocation,
+                              gpointer user_data);
 
     // D-Bus属性处理
-    static gboolean onGetProperty(GDBusConnection* connection,
-                                 const gchar* sender,
-                                 const gchar* object_path,
-                                 const gchar* interface_name,
-                                 const gchar* property_name,
-                                 GVariant** value,
-                                 GError** error,
-                                 gpointer user_data);
+    static GVariant* onGetProperty(GDBusConnection* connection,
+                                   const gchar* sender,
+                                   const gchar* object_path,
+                                   const gchar* interface_name,
+                                   const gchar* property_name,
+                                   GError** error,
+                                   gpointer user_data);
 
     // 辅助函数
     std::vector<std::string> getTypeFlags() const;
@@ -147,9 +146,7 @@ private:
     std::map<std::string, GVariant*> getServiceDataVariant() const;
 
     // D-Bus接口定义
-    static const GDBusMethodInfo interface_methods[];
-    static const GDBusPropertyInfo interface_properties[];
-    static const GDBusInterfaceInfo interface_info_;
+    static GDBusInterfaceInfo* interfaceInfo();
     static const GDBusInterfaceVTable interface_vtable_;
 };
 
@@ -0,0 +1,144 @@
+#ifndef ASYNC_COMPLETION_H
+#define ASYNC_COMPLETION_H
+
+#include <gio/gio.h>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include "byte_value.h"
+
+namespace Bluetooth {
+
+// 异步回调的默认超时（毫秒），应小于BlueZ等待D-Bus回复的超时
+constexpr guint ASYNC_CALLBACK_DEFAULT_TIMEOUT_MS = 10000;
+
+// 异步回调可返回的ATT错误，BlueZ把对应的D-Bus错误转换为ATT错误码
+enum class AttError {
+    FAILED,                // org.bluez.Error.Failed（Unlikely Error）
+    IN_PROGRESS,           // org.bluez.Error.InProgress
+    NOT_PERMITTED,         // org.bluez.Error.NotPermitted
+    NOT_AUTHORIZED,        // org.bluez.Error.NotAuthorized
+    NOT_SUPPORTED,         // org.bluez.Error.NotSupported
+    INVALID_OFFSET,        // org.bluez.Error.InvalidOffset
+    INVALID_VALUE_LENGTH   // org.bluez.Error.InvalidValueLength
+};
+
+/**
+ * @brief 获取ATT错误对应的BlueZ D-Bus错误名
+ * @param error ATT错误
+ * @return D-Bus错误名
+ */
+const char* attErrorName(AttError error);
+
+// 完成结果
+struct CompletionResult {
+    bool success = false;
+    ByteValue value;                  // 读取成功时的值
+    AttError error = AttError::FAILED;
+    bool timed_out = false;           // 超时前没有完成
+};
+
+/**
+ * @brief 异步请求的共享完成状态
+ * 可在任意线程完成，只有第一次完成（或超时）生效；结果总是在主循环线程中交给finish函数
+ */
+class CompletionState : public std::enable_shared_from_this<CompletionState> {
+public:
+    using FinishFunction = std::function<void(const CompletionResult& result)>;
+
+    /**
+     * @brief 创建完成状态（在主循环线程中调用）
+     * @param finish 在主循环线程中处理结果，只调用一次
+     * @param timeout_ms 超时（毫秒），0表示不超时（此时必须完成，否则请求一直挂起）
+     * @return 完成状态
+     */
+    static std::shared_ptr<CompletionState> create(FinishFunction finish, guint timeout_ms);
+
+    // 禁用拷贝构造和赋值
+    CompletionState(const CompletionState&) = delete;
+    CompletionState& operator=(const CompletionState&) = delete;
+
+    /**
+     * @brief 完成请求（任意线程）
+     * @param result 结果
+     * @return true表示本次完成生效，false表示已经完成或超时
+     */
+    bool complete(CompletionResult result);
+
+    bool isDone() const { return done_.load(std::memory_order_acquire); }
+
+private:
+    struct Delivery {
+        std::shared_ptr<CompletionState> state;
+        CompletionResult result;
+    };
+
+    std::atomic<bool> done_;
+    FinishFunction finish_;
+    guint timeout_id_;
+
+    explicit CompletionState(FinishFunction finish);
+    void finish(const CompletionResult& result);
+
+    static gboolean onTimeout(gpointer user_data);
+    static gboolean onDeliver(gpointer user_data);
+    static void onDeliveryDestroy(gpointer user_data);
+    static void onTimeoutDestroy(gpointer user_data);
+};
+
+/**
+ * @brief 异步读取的完成句柄，可复制、可跨线程传递，只有第一次完成生效
+ */
+class ReadCompletion {
+public:
+    explicit ReadCompletion(std::shared_ptr<CompletionState> state) : state_(state) {}
+
+    /**
+     * @brief 以读取到的值完成
+     * @param value 特征值数据
+     * @return true表示生效，false表示已经完成或超时
+     */
+    bool complete(const ByteValue& value);
+
+    /**
+     * @brief 以ATT错误完成
+     * @param error ATT错误
+     * @return true表示生效，false表示已经完成或超时
+     */
+    bool fail(AttError error);
+
+    bool isDone() const { return state_->isDone(); }
+
+private:
+    std::shared_ptr<CompletionState> state_;
+};
+
+/**
+ * @brief 异步写入的完成句柄，可复制、可跨线程传递，只有第一次完成生效
+ */
+class WriteCompletion {
+public:
+    explicit WriteCompletion(std::shared_ptr<CompletionState> state) : state_(state) {}
+
+    /**
+     * @brief 接受写入，特征值随后保存写入的值
+     * @return true表示生效，false表示已经完成或超时
+     */
+    bool accept();
+
+    /**
+     * @brief 以ATT错误拒绝写入
+     * @param error ATT错误
+     * @return true表示生效，false表示已经完成或超时
+     */
+    bool reject(AttError error = AttError::NOT_PERMITTED);
+
+    bool isDone() const { return state_->isDone(); }
+
+private:
+    std::shared_ptr<CompletionState> state_;
+};
+
+} // namespace Bluetooth
+
+#endif // ASYNC_COMPLETION_H
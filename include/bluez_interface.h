@@ -6,6 +6,7 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include "context_handoff.h"
 
 namespace Bluetooth {
 
@@ -84,12 +85,44 @@ public:
      */
     GDBusConnection* getConnection() const { return connection_; }
 
+    /**
+     * @brief 启动D-Bus分发线程，之后默认主循环上下文（导出对象的方法调用、属性读取，
+     * 以及特征值的定时器和套接字监视）只在该线程中迭代。
+     * 调用线程此后不能再迭代默认上下文，应用逻辑应运行在自己的主循环上下文中，
+     * 通过post()或应用上下文模式的CallbackExecutor与导出对象交互
+     * @return true表示成功，false表示已经在运行
+     */
+    bool startDispatchThread();
+
+    /**
+     * @brief 停止D-Bus分发线程并等待其退出（不能在分发线程中调用）
+     */
+    void stopDispatchThread();
+
+    /**
+     * @brief 检查D-Bus分发线程是否在运行
+     * @return true表示在运行
+     */
+    bool isDispatchThreadRunning() const { return dispatch_thread_ != nullptr; }
+
+    /**
+     * @brief 把任务交给导出对象所在的默认上下文执行（任意线程，无锁）
+     * 应用线程修改特征值（如setValue）时使用
+     * @param task 任务
+     */
+    void post(ContextHandoff::Task task) { dispatch_handoff_->post(task); }
+
 private:
     GDBusConnection* connection_;
     GDBusObjectManager* object_manager_;
     GDBusObjectProxy* adapter_proxy_;
     bool initialized_;
     ErrorCallback error_callback_;
+    GThread* dispatch_thread_;
+    GMainLoop* dispatch_loop_;
+    std::unique_ptr<ContextHandoff> dispatch_handoff_;
+
+    static gpointer dispatchThreadMain(gpointer user_data);
 
     // D-Bus方法调用回调
     static void onRegisterApplicationReply(GDBusConnection* connection,
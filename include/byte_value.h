@@ -0,0 +1,149 @@
+#ifndef BYTE_VALUE_H
+#define BYTE_VALUE_H
+
+#include <vector>
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
+
+namespace Bluetooth {
+
+/**
+ * @brief 特征值字节序列
+ * 不超过默认ATT MTU（23字节）的值直接存放在对象内部，不分配堆内存；
+ * 更长的值退回到堆上。可由std::vector和初始化列表隐式构造
+ */
+class ByteValue {
+public:
+    static constexpr size_t INLINE_CAPACITY = 23;
+
+    using value_type = uint8_t;
+    using iterator = uint8_t*;
+    using const_iterator = const uint8_t*;
+
+    ByteValue() noexcept : size_(0), capacity_(INLINE_CAPACITY) {}
+    ByteValue(const uint8_t* data, size_t size);
+    explicit ByteValue(size_t size, uint8_t fill = 0);
+    ByteValue(const std::vector<uint8_t>& bytes);
+    ByteValue(std::initializer_list<uint8_t> bytes);
+    ~ByteValue();
+
+    ByteValue(const ByteValue& other);
+    ByteValue(ByteValue&& other) noexcept;
+    ByteValue& operator=(const ByteValue& other);
+    ByteValue& operator=(ByteValue&& other) noexcept;
+
+    uint8_t* data() { return isInline() ? storage_.inline_bytes : storage_.heap; }
+    const uint8_t* data() const { return isInline() ? storage_.inline_bytes : storage_.heap; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief 是否使用内部存储
+     * @return true表示没有堆内存
+     */
+    bool isInline() const { return capacity_ <= INLINE_CAPACITY; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+
+    uint8_t& operator[](size_t index) { return data()[index]; }
+    const uint8_t& operator[](size_t index) const { return data()[index]; }
+
+    /**
+     * @brief 替换内容，容量足够时复用已有存储
+     * @param data 数据
+     * @param size 长度
+     */
+    void assign(const uint8_t* data, size_t size);
+
+    /**
+     * @brief 追加数据
+     * @param data 数据
+     * @param size 长度
+     */
+    void append(const uint8_t* data, size_t size);
+
+    void push_back(uint8_t byte) {
+        // 容量足够时内联写入，只有扩容才走append
+        if (size_ < capacity_) {
+            data()[size_++] = byte;
+        } else {
+            append(&byte, 1);
+        }
+    }
+    void resize(size_t size, uint8_t fill = 0);
+    void reserve(size_t capacity);
+    void clear() { size_ = 0; }
+    void swap(ByteValue& other) noexcept;
+
+    /**
+     * @brief 复制为std::vector（用于尚未迁移的接口）
+     * @return 字节向量
+     */
+    std::vector<uint8_t> toVector() const { return std::vector<uint8_t>(begin(), end()); }
+
+    bool operator==(const ByteValue& other) const;
+    bool operator!=(const ByteValue& other) const { return !(*this == other); }
+
+private:
+    size_t size_;
+    size_t capacity_;
+    union Storage {
+        uint8_t inline_bytes[INLINE_CAPACITY];
+        uint8_t* heap;
+    } storage_;
+
+    void grow(size_t capacity);
+    void release();
+};
+
+/**
+ * @brief 不持有数据的只读字节视图（指针 + 长度）
+ * 用于把请求消息或接收缓冲中的数据直接交给回调，调用结束后视图失效
+ */
+class ByteView {
+public:
+    using value_type = uint8_t;
+    using const_iterator = const uint8_t*;
+
+    ByteView() noexcept : data_(nullptr), size_(0) {}
+    ByteView(const uint8_t* data, size_t size) noexcept : data_(data), size_(size) {}
+    ByteView(const ByteValue& value) noexcept : data_(value.data()), size_(value.size()) {}
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    const uint8_t& operator[](size_t index) const { return data_[index]; }
+
+    /**
+     * @brief 截取子视图
+     * @param offset 起始偏移（不超过size()）
+     * @param length 长度，超出部分被截掉
+     * @return 子视图
+     */
+    ByteView subview(size_t offset, size_t length) const {
+        return ByteView(data_ + offset, length < size_ - offset ? length : size_ - offset);
+    }
+
+    /**
+     * @brief 复制为持有数据的字节序列
+     * @return 字节序列
+     */
+    ByteValue toByteValue() const { return ByteValue(data_, size_); }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+} // namespace Bluetooth
+
+#endif // BYTE_VALUE_H
@@ -0,0 +1,117 @@
+#ifndef CALLBACK_EXECUTOR_H
+#define CALLBACK_EXECUTOR_H
+
+#include <gio/gio.h>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "context_handoff.h"
+
+namespace Bluetooth {
+
+// 回调执行器配置
+struct ExecutorConfig {
+    size_t max_threads = 4;        // 工作线程上限
+    size_t max_queue_depth = 64;   // 排队中（尚未开始执行）的任务上限，超过时拒绝提交
+};
+
+// 回调执行器统计
+struct ExecutorStatistics {
+    size_t queued = 0;              // 当前排队的任务数
+    size_t running = 0;             // 当前执行中的任务数
+    size_t peak_queued = 0;         // 排队深度峰值
+    uint64_t completed = 0;         // 已完成的任务数
+    uint64_t rejected = 0;          // 队列已满被拒绝的任务数
+    double average_wait_ms = 0.0;   // 平均排队时间（毫秒）
+};
+
+/**
+ * @brief 在有界线程池中执行读写回调
+ * 任务在工作线程中执行，完成后的处理（回复D-Bus请求、更新特征值）通过g_main_context_invoke
+ * 回到主循环线程，慢速的传感器读取不会阻塞其他D-Bus请求和通知。
+ * 也可以把任务交给应用的主循环上下文执行（D-Bus在独立分发线程中处理时）。
+ * 析构时等待执行中的任务结束，已排队的任务同样会被执行
+ */
+class CallbackExecutor {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param config 执行器配置
+     * @param context 完成处理所在的主循环上下文，nullptr表示默认上下文
+     */
+    explicit CallbackExecutor(const ExecutorConfig& config = ExecutorConfig(), GMainContext* context = nullptr);
+
+    /**
+     * @brief 创建在应用主循环上下文中执行任务的执行器（不使用线程池，max_threads不起作用）
+     * 任务和完成处理都通过无锁队列交接，D-Bus分发线程与应用线程互不阻塞。
+     * 析构前应用上下文应停止分发，尚未执行的任务被丢弃
+     * @param work_context 执行任务的应用主循环上下文
+     * @param config 执行器配置
+     * @param context 完成处理所在的主循环上下文，nullptr表示默认上下文
+     */
+    CallbackExecutor(GMainContext* work_context, const ExecutorConfig& config = ExecutorConfig(),
+                     GMainContext* context = nullptr);
+    ~CallbackExecutor();
+
+    // 禁用拷贝构造和赋值
+    CallbackExecutor(const CallbackExecutor&) = delete;
+    CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+
+    /**
+     * @brief 提交任务
+     * @param work 在工作线程中执行
+     * @param completion work结束后在主循环线程中执行，可为空
+     * @return true表示已提交，false表示队列已满
+     */
+    bool submit(Task work, Task completion);
+
+    /**
+     * @brief 调整工作线程上限（排队上限同时更新）
+     * @param config 执行器配置
+     */
+    void setConfig(const ExecutorConfig& config);
+
+    /**
+     * @brief 获取执行器配置
+     * @return 执行器配置
+     */
+    const ExecutorConfig& getConfig() const { return config_; }
+
+    /**
+     * @brief 获取统计信息（可在任意线程调用）
+     * @return 统计信息
+     */
+    ExecutorStatistics getStatistics() const;
+
+private:
+    struct Job {
+        Task work;
+        Task completion;
+        gint64 queued_at;
+    };
+
+    ExecutorConfig config_;
+    GThreadPool* pool_;
+    GMainContext* context_;
+    std::unique_ptr<ContextHandoff> work_handoff_;        // 应用上下文模式下的任务队列
+    std::unique_ptr<ContextHandoff> completion_handoff_;  // 应用上下文模式下的完成处理队列
+    std::atomic<size_t> queued_;
+    std::atomic<size_t> running_;
+    std::atomic<size_t> peak_queued_;
+    std::atomic<uint64_t> completed_;
+    std::atomic<uint64_t> rejected_;
+    std::atomic<uint64_t> total_wait_us_;
+
+    void runJob(Job& job);
+
+    static void onWork(gpointer data, gpointer user_data);
+    static gboolean onComplete(gpointer user_data);
+    static void onJobDestroy(gpointer user_data);
+};
+
+} // namespace Bluetooth
+
+#endif // CALLBACK_EXECUTOR_H
@@ -0,0 +1,84 @@
+#ifndef CONTEXT_HANDOFF_H
+#define CONTEXT_HANDOFF_H
+
+#include <gio/gio.h>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+
+namespace Bluetooth {
+
+// 每次分发最多执行的任务数，其余任务留到下一次主循环迭代，避免饿死同一上下文中的其他源
+constexpr size_t CONTEXT_HANDOFF_BATCH_LIMIT = 64;
+
+/**
+ * @brief 把任务从任意线程交给指定主循环上下文执行的无锁队列
+ * 生产者把任务压入多生产者/单消费者链表，不加锁；消费端是附加在目标上下文的自定义GSource，
+ * 生产者通过g_main_context_wakeup唤醒目标线程，连续投递只唤醒一次。
+ * 析构时尚未执行的任务被丢弃，析构时不能有其他线程投递或目标上下文正在分发
+ */
+class ContextHandoff {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param context 执行任务的主循环上下文，nullptr表示默认上下文
+     */
+    explicit ContextHandoff(GMainContext* context = nullptr);
+    ~ContextHandoff();
+
+    // 禁用拷贝构造和赋值
+    ContextHandoff(const ContextHandoff&) = delete;
+    ContextHandoff& operator=(const ContextHandoff&) = delete;
+
+    /**
+     * @brief 投递任务（任意线程）
+     * @param task 在目标上下文的线程中执行的任务
+     */
+    void post(Task task);
+
+    /**
+     * @brief 获取待执行的任务数（任意线程，近似值）
+     * @return 任务数
+     */
+    size_t getPendingCount() const { return pending_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 获取执行任务的主循环上下文
+     * @return 主循环上下文
+     */
+    GMainContext* getContext() const { return context_; }
+
+private:
+    struct Node {
+        std::atomic<Node*> next;
+        Task task;
+    };
+
+    struct HandoffSource {
+        GSource source;
+        ContextHandoff* handoff;
+    };
+
+    GMainContext* context_;
+    GSource* source_;
+    std::atomic<Node*> head_;       // 生产者端，最后压入的节点
+    Node* tail_;                    // 消费者端，只在目标线程访问
+    Node stub_;
+    std::atomic<size_t> pending_;
+    std::atomic<bool> wakeup_pending_;
+
+    void push(Node* node);
+    Node* pop();
+    bool hasPendingTasks();
+    void dispatch();
+
+    static gboolean onPrepare(GSource* source, gint* timeout);
+    static gboolean onCheck(GSource* source);
+    static gboolean onDispatch(GSource* source, GSourceFunc callback, gpointer user_data);
+    static GSourceFuncs source_funcs_;
+};
+
+} // namespace Bluetooth
+
+#endif // CONTEXT_HANDOFF_H
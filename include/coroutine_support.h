@@ -0,0 +1,205 @@
+#ifndef COROUTINE_SUPPORT_H
+#define COROUTINE_SUPPORT_H
+
+// C++20协程支持，只在以ENABLE_COROUTINES构建（定义BLUETOOTH_COROUTINES）时可用
+#ifdef BLUETOOTH_COROUTINES
+
+#include <gio/gio.h>
+#include <coroutine>
+#include <string>
+
+namespace Bluetooth {
+
+/**
+ * @brief 分离执行的协程返回类型
+ * 调用后立即执行到第一个co_await，挂起期间由主循环中的源恢复，结束时自动释放协程帧。
+ * 协程的参数应按值传递：引用参数在第一次挂起后可能已经失效
+ */
+class CoTask {
+public:
+    struct promise_type {
+        CoTask get_return_object() noexcept { return CoTask(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept;
+    };
+};
+
+/**
+ * @brief 定时器等待：挂起协程，interval_ms毫秒后在主循环中恢复
+ */
+class SleepAwaitable {
+public:
+    SleepAwaitable(guint interval_ms, GMainContext* context);
+    ~SleepAwaitable();
+
+    // 禁用拷贝构造和赋值
+    SleepAwaitable(const SleepAwaitable&) = delete;
+    SleepAwaitable& operator=(const SleepAwaitable&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const noexcept {}
+
+private:
+    guint interval_ms_;
+    GMainContext* context_;
+    GSource* source_;
+    std::coroutine_handle<> handle_;
+
+    static gboolean onTimeout(gpointer user_data);
+};
+
+/**
+ * @brief 文件描述符就绪等待：挂起协程，直到fd满足condition或超时
+ * co_await的结果为实际就绪的条件，超时时为0
+ */
+class FdAwaitable {
+public:
+    FdAwaitable(int fd, GIOCondition condition, guint timeout_ms, GMainContext* context);
+    ~FdAwaitable();
+
+    // 禁用拷贝构造和赋值
+    FdAwaitable(const FdAwaitable&) = delete;
+    FdAwaitable& operator=(const FdAwaitable&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    GIOCondition await_resume() const noexcept { return result_; }
+
+private:
+    int fd_;
+    GIOCondition condition_;
+    guint timeout_ms_;
+    GMainContext* context_;
+    GSource* fd_source_;
+    GSource* timeout_source_;
+    GIOCondition result_;
+    std::coroutine_handle<> handle_;
+
+    void resume(GIOCondition result);
+
+    static gboolean onFdReady(gint fd, GIOCondition condition, gpointer user_data);
+    static gboolean onTimeout(gpointer user_data);
+};
+
+/**
+ * @brief D-Bus调用结果，持有回复或错误
+ */
+class DBusReply {
+public:
+    DBusReply() : reply_(nullptr), error_(nullptr) {}
+    DBusReply(GVariant* reply, GError* error) : reply_(reply), error_(error) {}
+    DBusReply(DBusReply&& other) noexcept;
+    DBusReply& operator=(DBusReply&& other) noexcept;
+    ~DBusReply();
+
+    // 禁用拷贝构造和赋值
+    DBusReply(const DBusReply&) = delete;
+    DBusReply& operator=(const DBusReply&) = delete;
+
+    bool ok() const { return reply_ != nullptr; }
+
+    /**
+     * @brief 获取回复元组，仍由DBusReply持有
+     * @return 回复，失败时为nullptr
+     */
+    GVariant* value() const { return reply_; }
+
+    /**
+     * @brief 获取错误信息
+     * @return 错误信息，成功时为空
+     */
+    std::string errorMessage() const { return error_ ? error_->message : ""; }
+
+    const GError* error() const { return error_; }
+
+private:
+    GVariant* reply_;
+    GError* error_;
+};
+
+/**
+ * @brief D-Bus方法调用等待：发出调用后挂起协程，回复到达后恢复
+ * co_await的结果为DBusReply
+ */
+class DBusCallAwaitable {
+public:
+    DBusCallAwaitable(GDBusConnection* connection, const std::string& bus_name,
+                      const std::string& object_path, const std::string& interface_name,
+                      const std::string& method_name, GVariant* parameters,
+                      const GVariantType* reply_type, gint timeout_ms);
+    ~DBusCallAwaitable();
+
+    // 禁用拷贝构造和赋值
+    DBusCallAwaitable(const DBusCallAwaitable&) = delete;
+    DBusCallAwaitable& operator=(const DBusCallAwaitable&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    DBusReply await_resume() noexcept { return std::move(reply_); }
+
+private:
+    GDBusConnection* connection_;
+    std::string bus_name_;
+    std::string object_path_;
+    std::string interface_name_;
+    std::string method_name_;
+    GVariant* parameters_;
+    const GVariantType* reply_type_;
+    gint timeout_ms_;
+    DBusReply reply_;
+    std::coroutine_handle<> handle_;
+
+    static void onCallReady(GObject* source, GAsyncResult* result, gpointer user_data);
+};
+
+/**
+ * @brief 等待一段时间，不阻塞主循环
+ * @param interval_ms 等待时间（毫秒）
+ * @param context 恢复协程的主循环上下文，nullptr表示默认上下文
+ * @return 可co_await的定时器
+ */
+inline SleepAwaitable sleepFor(guint interval_ms, GMainContext* context = nullptr) {
+    return SleepAwaitable(interval_ms, context);
+}
+
+/**
+ * @brief 等待文件描述符就绪，不阻塞主循环
+ * @param fd 文件描述符
+ * @param condition 等待的条件，如G_IO_IN或G_IO_OUT（G_IO_HUP/G_IO_ERR总会报告）
+ * @param timeout_ms 超时（毫秒），0表示不超时
+ * @param context 恢复协程的主循环上下文，nullptr表示默认上下文
+ * @return 可co_await的等待，结果为就绪条件，超时为0
+ */
+inline FdAwaitable waitForFd(int fd, GIOCondition condition, guint timeout_ms = 0,
+                             GMainContext* context = nullptr) {
+    return FdAwaitable(fd, condition, timeout_ms, context);
+}
+
+/**
+ * @brief 异步调用D-Bus方法，回复在发起调用线程的默认上下文中处理
+ * @param connection D-Bus连接
+ * @param bus_name 目标总线名
+ * @param object_path 目标对象路径
+ * @param interface_name 接口名
+ * @param method_name 方法名
+ * @param parameters 参数元组，可以为nullptr；浮动引用会被接管
+ * @param reply_type 期望的回复类型，nullptr表示不检查
+ * @param timeout_ms 超时（毫秒），-1表示默认超时
+ * @return 可co_await的调用，结果为DBusReply
+ */
+inline DBusCallAwaitable callDBus(GDBusConnection* connection, const std::string& bus_name,
+                                  const std::string& object_path, const std::string& interface_name,
+                                  const std::string& method_name, GVariant* parameters = nullptr,
+                                  const GVariantType* reply_type = nullptr, gint timeout_ms = -1) {
+    return DBusCallAwaitable(connection, bus_name, object_path, interface_name, method_name,
+                             parameters, reply_type, timeout_ms);
+}
+
+} // namespace Bluetooth
+
+#endif // BLUETOOTH_COROUTINES
+
+#endif // COROUTINE_SUPPORT_H
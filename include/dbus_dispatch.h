@@ -0,0 +1,129 @@
+#ifndef DBUS_DISPATCH_H
+#define DBUS_DISPATCH_H
+
+#include <array>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace Bluetooth {
+
+// 编译期搜索完美哈希种子的上限
+constexpr uint32_t NAME_TABLE_MAX_SEED = 4096;
+
+/**
+ * @brief 带种子的FNV-1a字符串哈希（附加末尾混合）
+ * @param name 名称
+ * @param seed 种子
+ * @return 哈希值
+ */
+constexpr uint32_t hashName(std::string_view name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+
+    // FNV的低位只受输入低位影响，混合高位后再按掩码取槽位
+    hash ^= hash >> 16;
+    hash *= 0x7feb352du;
+    hash ^= hash >> 15;
+    return hash;
+}
+
+// 名称与分派标识的对应
+template <typename Id>
+struct NameEntry {
+    const char* name;
+    Id id;
+};
+
+/**
+ * @brief D-Bus方法名/属性名的编译期完美哈希表
+ * 构造时在编译期搜索一个种子，使所有名称落在互不相同的槽位；
+ * 查找只需计算一次哈希并与槽位中的唯一候选比较一次，代价与名称数量无关。
+ * 用constexpr变量定义并以static_assert(table.isValid())确认种子已找到
+ */
+template <typename Id, size_t N>
+class NameTable {
+public:
+    // 槽位数：不小于2N的2的幂，负载不超过一半，种子很快就能找到
+    static constexpr size_t SLOT_COUNT = [] {
+        size_t count = 1;
+        while (count < 2 * N) {
+            count <<= 1;
+        }
+        return count;
+    }();
+
+    constexpr explicit NameTable(const NameEntry<Id> (&entries)[N])
+        : entries_(), slots_(), seed_(0), valid_(false) {
+        for (size_t i = 0; i < N; ++i) {
+            entries_[i] = entries[i];
+        }
+
+        for (uint32_t seed = 0; seed < NAME_TABLE_MAX_SEED && !valid_; ++seed) {
+            valid_ = tryFill(seed);
+        }
+    }
+
+    /**
+     * @brief 查找名称
+     * @param name 方法名或属性名，可以为nullptr
+     * @param id 输出分派标识
+     * @return true表示找到，false表示未知名称
+     */
+    constexpr bool find(const char* name, Id& id) const {
+        if (!name) {
+            return false;
+        }
+
+        std::string_view key(name);
+        size_t index = slots_[hashName(key, seed_) & (SLOT_COUNT - 1)];
+        if (index == N || key != entries_[index].name) {
+            return false;
+        }
+
+        id = entries_[index].id;
+        return true;
+    }
+
+    constexpr bool isValid() const { return valid_; }
+
+private:
+    std::array<NameEntry<Id>, N> entries_;
+    std::array<size_t, SLOT_COUNT> slots_;  // 名称下标，N表示空槽
+    uint32_t seed_;
+    bool valid_;
+
+    constexpr bool tryFill(uint32_t seed) {
+        for (size_t slot = 0; slot < SLOT_COUNT; ++slot) {
+            slots_[slot] = N;
+        }
+
+        for (size_t i = 0; i < N; ++i) {
+            size_t slot = hashName(entries_[i].name, seed) & (SLOT_COUNT - 1);
+            if (slots_[slot] != N) {
+                return false;
+            }
+            slots_[slot] = i;
+        }
+
+        seed_ = seed;
+        return true;
+    }
+};
+
+/**
+ * @brief 创建名称表（推导名称数量）
+ * @param entries 名称与分派标识
+ * @return 名称表
+ */
+template <typename Id, size_t N>
+constexpr NameTable<Id, N> makeNameTable(const NameEntry<Id> (&entries)[N]) {
+    return NameTable<Id, N>(entries);
+}
+
+} // namespace Bluetooth
+
+#endif // DBUS_DISPATCH_H
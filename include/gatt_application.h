@@ -72,21 +72,19 @@ private:
     guint registration_id_;
     std::vector<std::shared_ptr<GattService>> services_;
 
-    // D-Bus接口vtable
-    static GVariant* methodGetServices(GDBusConnection* connection,
-                                      const gchar* sender,
-                                      const gchar* object_path,
-                                      const gchar* interface_name,
-                                      const gchar* method_name,
-                                      GVariant* parameters,
-                                      gpointer user_data,
-                                      GDBusMethodInvocation* invocation);
+    // D-Bus方法处理
+    static void methodGetServices(GDBusConnection* connection,
+                                  const gchar* sender,
+                                  const gchar* object_path,
+                                  const gchar* interface_name,
+                                  const gchar* method_name,
+                                  GVariant* parameters,
+                                  GDBusMethodInvocation* invocation,
+                                  gpointer user_data);
 
     // D-Bus接口定义
+    static GDBusInterfaceInfo* interfaceInfo();
     static const GDBusInterfaceVTable interface_vtable_;
-    static const GDBusArgInfo method_get_services_args[];
-    static const GDBusMethodInfo interface_methods[];
-    static const GDBusInterfaceInfo interface_info_;
 };
 
 } // namespace Bluetooth
@@ -8,9 +8,27 @@
 #include <memory>
 #include <cstdint>
 #include <algorithm>
+#include <map>
+#include "byte_value.h"
+#include "value_snapshot.h"
+#include "value_slot.h"
+#include "value_history.h"
+#include "value_store.h"
+#include "write_assembler.h"
+#include "stream_framing.h"
+#include "callback_executor.h"
+#include "async_completion.h"
+#include "coroutine_support.h"
+#include "subscriber_session.h"
+#include "indication_queue.h"
+#include "properties_changed_template.h"
+#include "payload_codec.h"
+#include "notification_dispatcher.h"
 
 namespace Bluetooth {
 
+class NotificationScheduler;
+
 // GATT特征值标志
 enum class CharacteristicFlags {
     READ = 0x0001,
@@ -22,11 +40,57 @@ enum class CharacteristicFlags {
     INDICATE = 0x0040
 };
 
+// ATT默认MTU及通知头部长度（操作码1字节 + 句柄2字节）
+constexpr uint16_t DEFAULT_ATT_MTU = 23;
+constexpr uint16_t ATT_NOTIFICATION_HEADER_SIZE = 3;
+
+// AcquireWrite套接字每次唤醒最多处理的写入数
+constexpr size_t WRITE_SOCKET_BATCH_LIMIT = 64;
+
 // 特征值读写回调函数类型
-using ReadCallback = std::function<std::vector<uint8_t>(const std::string& device_path)>;
-using WriteCallback = std::function<bool(const std::string& device_path, const std::vector<uint8_t>& value)>;
+using ReadCallback = std::function<ByteValue(const std::string& device_path)>;
+using WriteCallback = std::function<bool(const std::string& device_path, const ByteValue& value)>;
 using NotifyCallback = std::function<void(const std::string& device_path, bool subscribing)>;
 
+// ReadValue/WriteValue的options字典
+struct AccessOptions {
+    std::string device;   // 发起请求的设备对象路径，BlueZ未提供时为空
+    uint16_t offset = 0;  // 长读/长写偏移
+    uint16_t mtu = 0;     // 链路ATT MTU，0表示BlueZ未提供
+    std::string type;     // 写入类型："command"、"request"或"reliable"（Execute Write），仅WriteValue
+    bool prepare_authorize = false;  // Prepare Write阶段的授权请求，仅WriteValue
+};
+
+/**
+ * @brief 解析ReadValue/WriteValue的options字典
+ * @param options a{sv}字典，可以为nullptr
+ * @return 解析结果，缺失的键保持默认值
+ */
+AccessOptions parseAccessOptions(GVariant* options);
+
+// 零复制写入回调：value直接指向请求消息或接收缓冲，只在回调期间有效；
+// 返回true后特征值才保存该值
+using WriteViewCallback = std::function<bool(const ByteView& value, const AccessOptions& options)>;
+
+// 异步读写回调：通过完成句柄在任意线程、任意时刻给出结果，回调本身立即返回；
+// 异步写入回调的value在完成之前一直有效
+using AsyncReadCallback = std::function<void(const AccessOptions& options, ReadCompletion completion)>;
+using AsyncWriteCallback = std::function<void(const ByteView& value, const AccessOptions& options, WriteCompletion completion)>;
+
+#ifdef BLUETOOTH_COROUTINES
+// 协程处理函数：参数按值传入协程帧，可以co_await定时器、fd就绪和D-Bus调用而不阻塞主循环；
+// 写入的value在完成之前一直有效。处理函数（包括lambda的捕获）在挂起期间必须保持有效，不要在此期间替换
+using CoroutineReadHandler = std::function<CoTask(AccessOptions options, ReadCompletion completion)>;
+using CoroutineWriteHandler = std::function<CoTask(ByteView value, AccessOptions options, WriteCompletion completion)>;
+using CoroutineNotifyHandler = std::function<CoTask(std::string device_path, bool subscribing)>;
+#endif
+
+// 通知统计
+struct NotificationStatistics {
+    uint64_t sent_updates = 0;      // 实际发出的通知数
+    uint64_t coalesced_updates = 0; // 被合并掉的更新数
+};
+
 /**
  * @brief GATT特征值类
  * 实现org.bluez.GattCharacteristic1 D-Bus接口
@@ -56,22 +120,270 @@ public:
     void unexportInterface();
 
     /**
-     * @brief 设置初始值
+     * @brief 设置特征值并通知订阅者（所属服务处于事务中时只暂存，提交时生效）
      * @param value 特征值数据
+     * @return true表示已更新，false表示BLOCK_PRODUCER订阅者队列已满，更新被拒绝
+     */
+    bool setValue(const ByteValue& value);
+
+    /**
+     * @brief 绑定生产者线程的值槽，主循环取出最新值后按setValue()处理
+     * @param slot 值槽，生产者线程调用其publish()发布新值
+     * @param context 主循环上下文，nullptr表示默认上下文
+     */
+    void attachValueSlot(std::shared_ptr<ValueSlot> slot, GMainContext* context = nullptr);
+
+    /**
+     * @brief 解除值槽绑定
+     */
+    void detachValueSlot() { slot_watch_.reset(); }
+
+    /**
+     * @brief 启用历史记录，之后每次值更新都带时间戳写入环形缓冲区（内存一次性预分配）
+     * @param capacity 保存的样本数
+     * @param max_value_size 单个值的最大长度
+     */
+    void enableHistory(size_t capacity, size_t max_value_size = HISTORY_DEFAULT_MAX_VALUE_SIZE);
+
+    /**
+     * @brief 关闭并释放历史记录
+     */
+    void disableHistory();
+
+    /**
+     * @brief 获取历史记录，用于按时间范围查询
+     * @return 历史记录，未启用时为nullptr
+     */
+    const ValueHistory* getHistory() const { return history_.get(); }
+
+    /**
+     * @brief 设置新订阅者的历史回放数量（需先启用历史记录）
+     * @param count 订阅时回放最近的count个值，0表示不回放
      */
-    void setValue(const std::vector<uint8_t>& value);
+    void setHistoryReplay(size_t count) { history_replay_count_ = count; }
 
     /**
-     * @brief 获取当前值
+     * @brief 设置持久化存储，客户端写入被接受后追加到日志；
+     * 存储中已有该UUID的值时立即恢复（不发送通知），应在注册GATT应用之前调用
+     * @param store 已打开的持久化存储，nullptr表示不持久化
+     */
+    void setValueStore(std::shared_ptr<ValueStore> store);
+
+    /**
+     * @brief 获取当前值的副本
      * @return 特征值数据
      */
-    const std::vector<uint8_t>& getValue() const { return value_; }
+    ByteValue getValue() const { return value_.toByteValue(); }
+
+    /**
+     * @brief 获取当前值的快照（只增加引用计数，不复制）
+     * @return 特征值快照
+     */
+    const ValueSnapshot& getSnapshot() const { return value_; }
 
     /**
      * @brief 通知值已更改（用于NOTIFY/INDICATE）
      */
     void notifyValueChanged();
 
+    /**
+     * @brief 发送一个指示（INDICATE），在未确认窗口内流水线发送
+     * 服务事务中只暂存值，提交时以提交的值发送一次指示，回滚时以CANCELLED完成
+     * @param value 指示数据，同时成为特征值的当前值
+     * @param callback 完成回调（确认、超时或取消），可为空
+     * @return 指示ID，0表示不支持指示、无订阅者或排队已满
+     */
+    uint64_t indicate(const ByteValue& value, IndicationCallback callback = nullptr);
+
+    /**
+     * @brief 设置指示窗口、超时和重发次数
+     * @param config 指示配置
+     */
+    void setIndicationConfig(const IndicationConfig& config);
+
+    /**
+     * @brief 获取指示统计
+     * @return 统计信息
+     */
+    IndicationStatistics getIndicationStatistics() const;
+
+    /**
+     * @brief 设置长写组装的超时和缓冲上限（仅WRITE/RELIABLE_WRITE特征值）
+     *
+     * RELIABLE_WRITE特征值始终组装；WRITE特征值在首次调用时启用组装，
+     * 此后Flags带authorize，应在注册对象之前调用
+     * @param config 组装配置
+     */
+    void setWriteAssemblyConfig(const WriteAssemblyConfig& config);
+
+    /**
+     * @brief 获取长写组装统计
+     * @return 统计信息
+     */
+    WriteAssemblyStatistics getWriteAssemblyStatistics() const;
+
+    /**
+     * @brief 获取通知套接字（AcquireNotify），之后setValue直接写入套接字
+     * @param device_path 设备路径
+     * @param mtu 协商的ATT MTU
+     * @return 交给BlueZ的一端的文件描述符（调用者负责关闭），失败返回-1
+     */
+    int acquireNotify(const std::string& device_path, uint16_t mtu);
+
+    /**
+     * @brief 释放设备的通知套接字
+     * @param device_path 设备路径
+     */
+    void releaseNotify(const std::string& device_path);
+
+    /**
+     * @brief 是否有订阅者持有通知套接字
+     * @return true表示至少一个订阅者经由套接字接收通知
+     */
+    bool isNotifyAcquired() const;
+
+    /**
+     * @brief 获取设备通知套接字的MTU
+     * @param device_path 设备路径
+     * @return ATT MTU，未持有套接字时返回默认MTU
+     */
+    uint16_t getNotifyMtu(const std::string& device_path) const;
+
+    /**
+     * @brief 获取设备的ATT MTU（从ReadValue/WriteValue选项和AcquireNotify/AcquireWrite中获知）
+     * @param device_path 设备路径
+     * @return ATT MTU，未知时返回默认MTU
+     */
+    uint16_t getDeviceMtu(const std::string& device_path) const;
+
+    /**
+     * @brief 以分块通知发送一段大数据，每块按订阅者中最小的MTU填满并带1字节序号头部，
+     * 按StreamConfig的节奏绕过合并、限速和负载编码直接发出；接收端用StreamReassembler重组。
+     * 同一时刻只能有一个流
+     * @param data 数据（内部复制一次）
+     * @param callback 完成回调，可为空
+     * @return true表示已开始，false表示没有订阅者或已有流在发送
+     */
+    bool streamValue(const ByteValue& data, StreamCallback callback = nullptr);
+
+    /**
+     * @brief 以分块通知发送生产者按需给出的数据
+     * @param producer 数据生产者，在主循环线程中按块调用
+     * @param callback 完成回调，可为空
+     * @return true表示已开始，false表示没有订阅者或已有流在发送
+     */
+    bool streamValue(StreamProducer producer, StreamCallback callback = nullptr);
+
+    /**
+     * @brief 取消正在发送的流，完成回调以completed为false调用
+     */
+    void cancelStream();
+
+    /**
+     * @brief 是否有流在发送
+     * @return true表示有
+     */
+    bool isStreaming() const { return stream_chunker_ != nullptr; }
+
+    /**
+     * @brief 设置流发送节奏
+     * @param config 节奏配置
+     */
+    void setStreamConfig(const StreamConfig& config) { stream_config_ = config; }
+
+    /**
+     * @brief 是否有订阅者
+     * @return true表示至少一个订阅者
+     */
+    bool isNotifying() const { return !subscribers_.empty(); }
+
+    /**
+     * @brief 设置订阅者队列配置（作为新订阅者的默认值，并应用到现有订阅者）
+     * @param config 队列配置
+     */
+    void setSubscriberQueueConfig(const SubscriberQueueConfig& config);
+
+    /**
+     * @brief 设置单个订阅者的队列配置
+     * @param device_path 设备路径
+     * @param config 队列配置
+     * @return true表示成功，false表示订阅者不存在
+     */
+    bool setSubscriberQueueConfig(const std::string& device_path, const SubscriberQueueConfig& config);
+
+    /**
+     * @brief 设置特征值级限速，可在运行时调用
+     * @param config 令牌桶配置（rate为0表示不限速）
+     */
+    void setRateLimit(const RateLimitConfig& config);
+
+    /**
+     * @brief 获取特征值级限速配置
+     * @return 令牌桶配置
+     */
+    const RateLimitConfig& getRateLimit() const { return rate_limiter_.getConfig(); }
+
+    /**
+     * @brief 获取特征值级限速统计
+     * @return 放行、推迟和丢弃计数
+     */
+    const RateLimitStatistics& getRateLimitStatistics() const { return rate_limiter_.getStatistics(); }
+
+    /**
+     * @brief 设置订阅者级限速（作为新订阅者的默认值，并应用到现有订阅者）
+     * 只对套接字订阅者生效；PropertiesChanged由BlueZ统一扇出，只受特征值级限速约束
+     * @param config 令牌桶配置
+     */
+    void setSubscriberRateLimit(const RateLimitConfig& config);
+
+    /**
+     * @brief 设置单个订阅者的限速
+     * @param device_path 设备路径
+     * @param config 令牌桶配置
+     * @return true表示成功，false表示订阅者不存在
+     */
+    bool setSubscriberRateLimit(const std::string& device_path, const RateLimitConfig& config);
+
+    /**
+     * @brief 设置订阅者队列水位回调，生产者据此限流
+     * @param callback 回调函数
+     */
+    void setWatermarkCallback(WatermarkCallback callback);
+
+    /**
+     * @brief 获取订阅者列表
+     * @return 设备路径列表
+     */
+    std::vector<std::string> getSubscribers() const;
+
+    /**
+     * @brief 获取订阅者统计
+     * @param device_path 设备路径
+     * @param stats 输出统计信息
+     * @return true表示成功，false表示订阅者不存在
+     */
+    bool getSubscriberStatistics(const std::string& device_path, SubscriberStatistics& stats) const;
+
+    /**
+     * @brief 获取写入套接字（AcquireWrite），客户端写入直接从套接字读取，
+     * 与WriteValue使用同一套写入回调（异步写入回调、回调执行器或同步回调）
+     * @param device_path 设备路径
+     * @param mtu 协商的ATT MTU
+     * @return 交给BlueZ的一端的文件描述符（调用者负责关闭），失败返回-1
+     */
+    int acquireWrite(const std::string& device_path, uint16_t mtu);
+
+    /**
+     * @brief 释放写入套接字
+     */
+    void releaseWrite();
+
+    /**
+     * @brief 是否持有写入套接字
+     * @return true表示写入经由套接字接收
+     */
+    bool isWriteAcquired() const { return write_fd_ >= 0; }
+
     /**
      * @brief 获取特征值UUID
      * @return 特征值UUID
@@ -102,25 +414,156 @@ public:
      */
     void setWriteCallback(WriteCallback callback) { write_callback_ = callback; }
 
+    /**
+     * @brief 设置零复制写入回调，设置后代替WriteCallback；被拒绝的写入不复制、不生成快照
+     * @param callback 写入回调函数
+     */
+    void setWriteViewCallback(WriteViewCallback callback) { write_view_callback_ = callback; }
+
+    /**
+     * @brief 设置回调执行器，之后ReadValue/WriteValue的读写回调在执行器的工作线程中调用，
+     * D-Bus请求在回调完成后从主循环中回复；回调不能访问特征值，需自行保证线程安全。
+     * 多个工作线程时同一特征值的写入可能乱序完成，需要保序时使用单线程执行器
+     * @param executor 回调执行器，nullptr表示在主循环中同步调用
+     */
+    void setCallbackExecutor(std::shared_ptr<CallbackExecutor> executor) { executor_ = executor; }
+
+    /**
+     * @brief 设置异步读取回调，设置后代替ReadCallback和回调执行器；
+     * 回调只在offset为0的首个请求时调用，Read Blob从完成时的值中截取
+     * @param callback 异步读取回调
+     */
+    void setAsyncReadCallback(AsyncReadCallback callback) { async_read_callback_ = callback; }
+
+    /**
+     * @brief 设置异步写入回调，设置后代替WriteCallback/WriteViewCallback和回调执行器；
+     * 长写以完整的值调用一次，在回复执行阶段的第一个片段之前，拒绝作为该片段的错误返回给客户端
+     * @param callback 异步写入回调
+     */
+    void setAsyncWriteCallback(AsyncWriteCallback callback) { async_write_callback_ = callback; }
+
+    /**
+     * @brief 设置异步回调的超时，超时未完成的请求以org.bluez.Error.Failed回复
+     * @param timeout_ms 超时（毫秒），0表示不超时
+     */
+    void setAsyncCallbackTimeout(guint timeout_ms) { async_timeout_ms_ = timeout_ms; }
+
+#ifdef BLUETOOTH_COROUTINES
+    /**
+     * @brief 设置协程读取处理函数，作为异步读取回调使用（同样受异步回调超时约束）
+     * @param handler 协程读取处理函数
+     */
+    void setCoroutineReadHandler(CoroutineReadHandler handler) {
+        async_read_callback_ = [handler](const AccessOptions& options, ReadCompletion completion) {
+            handler(options, completion);
+        };
+    }
+
+    /**
+     * @brief 设置协程写入处理函数，作为异步写入回调使用（同样受异步回调超时约束）
+     * @param handler 协程写入处理函数
+     */
+    void setCoroutineWriteHandler(CoroutineWriteHandler handler) {
+        async_write_callback_ = [handler](const ByteView& value, const AccessOptions& options,
+                                          WriteCompletion completion) {
+            handler(value, options, completion);
+        };
+    }
+
+    /**
+     * @brief 设置协程通知处理函数，StartNotify/StopNotify在处理函数第一次挂起时即回复
+     * @param handler 协程通知处理函数
+     */
+    void setCoroutineNotifyHandler(CoroutineNotifyHandler handler) {
+        notify_callback_ = [handler](const std::string& device_path, bool subscribing) {
+            handler(device_path, subscribing);
+        };
+    }
+#endif
+
     /**
      * @brief 设置通知回调
      * @param callback 通知回调函数
      */
     void setNotifyCallback(NotifyCallback callback) { notify_callback_ = callback; }
 
+    /**
+     * @brief 设置通知合并调度器
+     * @param scheduler 调度器实例，nullptr表示每次setValue立即通知
+     */
+    void setNotificationScheduler(std::shared_ptr<NotificationScheduler> scheduler);
+
+    /**
+     * @brief 设置优先级分发器
+     * @param dispatcher 分发器实例，nullptr表示不经排队直接发送
+     */
+    void setNotificationDispatcher(std::shared_ptr<NotificationDispatcher> dispatcher);
+
+    /**
+     * @brief 设置通知优先级，CRITICAL特征值同时跳过合并窗口
+     * @param priority 优先级
+     */
+    void setPriority(NotificationPriority priority);
+
+    /**
+     * @brief 获取通知优先级
+     * @return 优先级
+     */
+    NotificationPriority getPriority() const { return priority_; }
+
+    /**
+     * @brief 启用或禁用通知合并（"每个采样都重要"的特征值应禁用）
+     * @param enabled true表示合并，false表示每次setValue立即通知
+     */
+    void setCoalescingEnabled(bool enabled);
+
+    /**
+     * @brief 是否启用通知合并
+     * @return true表示启用
+     */
+    bool isCoalescingEnabled() const { return coalescing_enabled_; }
+
+    /**
+     * @brief 获取通知统计
+     * @return 已发送和已合并的更新计数
+     */
+    const NotificationStatistics& getNotificationStatistics() const { return notification_stats_; }
+
+    /**
+     * @brief 清零通知统计
+     */
+    void resetNotificationStatistics() { notification_stats_ = NotificationStatistics(); }
+
+    /**
+     * @brief 设置通知负载编码（可选），启用后通知和指示发送带帧头的关键帧/差分帧，
+     * ReadValue仍返回完整值；客户端需用相同配置的PayloadDecoder解码
+     * @param config 编码配置，mode为NONE时关闭编码
+     */
+    void setPayloadEncoding(const PayloadEncodingConfig& config);
+
+    /**
+     * @brief 获取通知负载编码统计
+     * @return 编码前后字节数和帧计数
+     */
+    PayloadEncodingStatistics getPayloadEncodingStatistics() const;
+
 protected:
     /**
      * @brief D-Bus方法处理：读取值
+     * 按options中的offset和mtu只返回请求的一段；读取回调只在offset为0时调用，
+     * 同一次长读的后续请求从首次读取的快照中截取，不复制
      * @param options 读取选项
-     * @return 读取的值
+     * @return 读取的值，offset超出值长度时返回nullptr
      */
     virtual GVariant* handleReadValue(GVariant* options);
 
     /**
      * @brief D-Bus方法处理：写入值
+     * 带offset或类型为reliable的写入是长写的片段，按设备组装后只调用一次写入回调；
+     * prepare-authorize请求只做授权，不修改值
      * @param value 要写入的值
      * @param options 写入选项
-     * @return true表示成功，false表示失败
+     * @return true表示成功，false表示失败（错误名见write_error_）
      */
     virtual bool handleWriteValue(GVariant* value, GVariant* options);
 
@@ -136,71 +579,191 @@ protected:
      */
     virtual void handleStopNotify(const std::string& device_path);
 
+    /**
+     * @brief D-Bus方法处理：指示已被确认
+     * @param caller Confirm调用者（与StartNotify调用者对应）
+     */
+    virtual void handleConfirm(const std::string& caller);
+
+    /**
+     * @brief D-Bus方法处理：获取通知套接字
+     * @param options 选项（device、mtu）
+     * @param invocation 方法调用，返回fd和mtu
+     */
+    virtual void handleAcquireNotify(GVariant* options, GDBusMethodInvocation* invocation);
+
+    /**
+     * @brief D-Bus方法处理：获取写入套接字
+     * @param options 选项（device、mtu）
+     * @param invocation 方法调用，返回fd和mtu
+     */
+    virtual void handleAcquireWrite(GVariant* options, GDBusMethodInvocation* invocation);
+
 private:
     std::string uuid_;
     std::vector<CharacteristicFlags> flags_;
     std::string object_path_;
     GDBusConnection* connection_;
     guint registration_id_;
-    std::vector<uint8_t> value_;
-    bool notifying_;
-    std::vector<std::string> notified_devices_;
+    ValueSnapshot value_;
+
+    // 订阅者会话表（StartNotify发送者或AcquireNotify设备）
+    std::map<std::string, std::unique_ptr<SubscriberSession>> subscribers_;
+    SubscriberQueueConfig default_queue_config_;
+    WatermarkCallback watermark_callback_;
+    RateLimitConfig default_subscriber_rate_limit_;
 
     // 回调函数
     ReadCallback read_callback_;
     WriteCallback write_callback_;
+    WriteViewCallback write_view_callback_;
     NotifyCallback notify_callback_;
 
-    // D-Bus方法和属性处理
-    static GVariant* methodReadValue(GDBusConnection* connection,
-                                    const gchar* sender,
-                                    const gchar* object_path,
-                                    const gchar* interface_name,
-                                    const gchar* method_name,
-                                    GVariant* parameters,
-                                    gpointer user_data,
-                                    GDBusMethodInvocation* invocation);
-
-    static GVariant* methodWriteValue(GDBusConnection* connection,
-                                     const gchar* sender,
-                                     const gchar* object_path,
-                                     const gchar* interface_name,
-                                     const gchar* method_name,
-                                     GVariant* parameters,
-                                     gpointer user_data,
-                                     GDBusMethodInvocation* invocation);
-
-    static GVariant* methodStartNotify(GDBusConnection* connection,
-                                      const gchar* sender,
-                                      const gchar* object_path,
-                                      const gchar* interface_name,
-                                      const gchar* method_name,
-                                      GVariant* parameters,
-                                      gpointer user_data,
-                                      GDBusMethodInvocation* invocation);
-
-    static GVariant* methodStopNotify(GDBusConnection* connection,
-                                     const gchar* sender,
-                                     const gchar* object_path,
-                                     const gchar* interface_name,
-                                     const gchar* method_name,
-                                     GVariant* parameters,
-                                     gpointer user_data,
-                                     GDBusMethodInvocation* invocation);
-
-    static gboolean onGetProperty(GDBusConnection* connection,
-                                 const gchar* sender,
-                                 const gchar* object_path,
-                                 const gchar* interface_name,
-                                 const gchar* property_name,
-                                 GVariant** value,
-                                 GError** error,
-                                 gpointer user_data);
+    // 服务事务暂存
+    friend class GattService;
+    bool staging_;
+    bool has_staged_value_;
+    ValueSnapshot staged_value_;
+
+    // 事务中发起的指示：预留的ID和完成回调，提交时合并为一次指示
+    struct StagedIndication {
+        uint64_t id;
+        IndicationCallback callback;
+    };
+    std::vector<StagedIndication> staged_indications_;
+
+    // 事务期间完成的客户端写入（异步回调或写入套接字），事务结束后生效
+    bool has_deferred_write_;
+    ValueSnapshot deferred_write_;
+
+    void beginStaging();
+    bool commitStaging();
+    void discardStaging();
+    void flushStagedNotification();
+    void storeWrittenValue(const ValueSnapshot& value);
+    void applyDeferredWrite();
+
+    // 通知合并
+    friend class NotificationScheduler;
+    std::shared_ptr<NotificationScheduler> scheduler_;
+    bool coalescing_enabled_;
+    bool notification_pending_;
+    NotificationStatistics notification_stats_;
+
+    // 优先级分发
+    friend class NotificationDispatcher;
+    std::shared_ptr<NotificationDispatcher> dispatcher_;
+    NotificationPriority priority_;
+    bool dispatch_pending_;
+
+    // 特征值级限速
+    RateLimiter rate_limiter_;
+
+    // PropertiesChanged信号模板（按属性名缓存）
+    std::map<std::string, std::unique_ptr<PropertiesChangedTemplate>> signal_templates_;
+
+    // 指示窗口（仅INDICATE特征值）
+    std::unique_ptr<IndicationQueue> indication_queue_;
+
+    // 历史记录
+    std::unique_ptr<ValueHistory> history_;
+    size_t history_replay_count_;
+    void recordHistory();
+    void replayHistory(SubscriberSession* session);
+
+    // 长读：每个设备首个ReadValue（offset为0）时的快照，后续Read Blob从中截取
+    std::map<std::string, ValueSnapshot> long_reads_;
+
+    // 各设备的ATT MTU
+    std::map<std::string, uint16_t> device_mtus_;
+    void learnMtu(const std::string& device_path, uint16_t mtu);
+
+    // 分块流
+    std::unique_ptr<StreamChunker> stream_chunker_;
+    StreamCallback stream_callback_;
+    StreamConfig stream_config_;
+    guint stream_source_id_;
+    uint16_t streamMtu() const;
+    uint16_t signalMtu() const;
+    bool streamSinkReady() const;
+    void emitStreamChunk(const ValueSnapshot& chunk);
+    bool pumpStream();
+    void finishStream(bool completed);
+    static gboolean onStreamTick(gpointer user_data);
+
+    // 长写组装（仅WRITE/RELIABLE_WRITE特征值）
+    std::unique_ptr<WriteAssembler> write_assembler_;
+    const char* write_error_;
+    bool assembleWrite(const AccessOptions& access, GVariant* value);
+    bool executeWrite(const AccessOptions& access, GVariant* value);
+    bool submitExecuteWrite(GVariant* value, const AccessOptions& access, GDBusMethodInvocation* invocation);
+    bool fragmentAccepted(WriteFragmentStatus status);
+    bool commitAssembledWrite(const AccessOptions& access, const ByteValue& value);
+    void applyAssembledValue(const ByteValue& value);
+
+    // 回调执行器和异步回调；完成处理持有alive_的弱引用，特征值销毁后不再访问
+    std::shared_ptr<CallbackExecutor> executor_;
+    std::shared_ptr<bool> alive_;
+    AsyncReadCallback async_read_callback_;
+    AsyncWriteCallback async_write_callback_;
+    guint async_timeout_ms_;
+    void startAsyncRead(const AccessOptions& access, GDBusMethodInvocation* invocation);
+    void startAsyncWrite(GVariant* value, const AccessOptions& access, GDBusMethodInvocation* invocation);
+    bool submitReadValue(GVariant* options, GDBusMethodInvocation* invocation);
+    bool submitWriteValue(GVariant* value, GVariant* options, GDBusMethodInvocation* invocation);
+    GVariant* readSlice(const AccessOptions& access);
+    void applyWrittenValue(GVariant* value);
+    static void returnReadValue(GDBusMethodInvocation* invocation, GVariant* result);
+
+    // 写入持久化
+    std::shared_ptr<ValueStore> value_store_;
+    void persistValue();
+
+    // 生产者线程值槽
+    std::unique_ptr<ValueSlotWatch> slot_watch_;
+
+    // 通知负载编码：广播（信号和指示）共享的编码器，为空表示发送完整值；套接字订阅者各自编码
+    PayloadEncodingConfig payload_encoding_;
+    std::unique_ptr<PayloadEncoder> payload_encoder_;
+    ValueSnapshot encodePayload(const ValueSnapshot& value);
+
+    // AcquireWrite套接字
+    int write_fd_;
+    uint16_t write_mtu_;
+    guint write_watch_id_;
+    std::string write_device_;
+    std::vector<uint8_t> write_buffer_;
+    uint64_t write_sequence_;          // 已接收的数据报序号
+    uint64_t applied_write_sequence_;  // 最近保存的数据报序号
+    void startAsyncSocketWrite(const ByteView& datagram, const AccessOptions& access, uint64_t sequence);
+    void submitSocketWrites(std::shared_ptr<std::vector<ByteValue>> batch, const AccessOptions& access,
+                            uint64_t first_sequence);
+    void applySocketWrite(uint64_t sequence, const ByteValue& value);
+
+    // D-Bus属性处理
+    static GVariant* onGetProperty(GDBusConnection* connection,
+                                   const gchar* sender,
+                                   const gchar* object_path,
+                                   const gchar* interface_name,
+                                   const gchar* property_name,
+                                   GError** error,
+                                   gpointer user_data);
 
     // 辅助函数
-    void emitPropertyChanged(const std::string& property_name, GVariant* value);
-    std::vector<uint8_t> gvariantToBytes(GVariant* variant);
-    GVariant* bytesToGvariant(const std::vector<uint8_t>& bytes);
+    void scheduleNotification();
+    bool createSocketPair(int fds[2]);
+    bool returnAcquiredSocket(GDBusMethodInvocation* invocation, int remote_fd, uint16_t mtu);
+    void dispatchNotification();
+    void deliverNotification();
+    bool emitValue(const ValueSnapshot& value);
+    bool hasFlag(CharacteristicFlags flag) const;
+    SubscriberSession* addSubscriber(const std::string& device_path);
+    void removeSubscriber(const std::string& device_path);
+    bool drainWriteSocket();
+    static gboolean onWriteSocketEvent(gint fd, GIOCondition condition, gpointer user_data);
+    bool emitPropertyChanged(const std::string& property_name, GVariant* value);
+    ByteValue gvariantToBytes(GVariant* variant);
+    GVariant* bytesToGvariant(const ValueSnapshot& bytes);
 
     // D-Bus方法处理器（静态）
     static void methodCallHandler(GDBusConnection* connection,
@@ -209,16 +772,11 @@ private:
                                  const gchar* interface_name,
                                  const gchar* method_name,
                                  GVariant* parameters,
-                                 gpointer user_data,
-                                 GDBusMethodInvocation* invocation);
+                                 GDBusMethodInvocation* invocation,
+                                 gpointer user_data);
 
     // D-Bus接口定义
-    static const GDBusArgInfo method_read_value_args[];
-    static const GDBusArgInfo method_read_value_result[];
-    static const GDBusArgInfo method_write_value_args[];
-    static const GDBusMethodInfo interface_methods[];
-    static const GDBusPropertyInfo interface_properties[];
-    static const GDBusInterfaceInfo interface_info_;
+    static GDBusInterfaceInfo* interfaceInfo();
     static const GDBusInterfaceVTable interface_vtable_;
 };
 
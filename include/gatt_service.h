@@ -45,6 +45,29 @@ public:
      */
     bool addCharacteristic(std::shared_ptr<GattCharacteristic> characteristic);
 
+    /**
+     * @brief 开始事务：之后各特征值的setValue只暂存，读取仍看到事务前的值
+     * 支持嵌套，最外层commitTransaction时生效
+     */
+    void beginTransaction();
+
+    /**
+     * @brief 提交事务：先原子地替换所有暂存值，再在同一轮分发中集中发送通知
+     * @return true表示已提交，false表示没有进行中的事务
+     */
+    bool commitTransaction();
+
+    /**
+     * @brief 回滚事务，丢弃所有暂存值
+     */
+    void rollbackTransaction();
+
+    /**
+     * @brief 是否有进行中的事务
+     * @return true表示事务进行中
+     */
+    bool inTransaction() const { return transaction_depth_ > 0; }
+
     /**
      * @brief 获取所有特征值
      * @return 特征值列表
@@ -85,20 +108,19 @@ private:
     GDBusConnection* connection_;
     guint registration_id_;
     std::vector<std::shared_ptr<GattCharacteristic>> characteristics_;
+    unsigned transaction_depth_;
 
     // D-Bus属性获取回调
-    static gboolean onGetProperty(GDBusConnection* connection,
-                                 const gchar* sender,
-                                 const gchar* object_path,
-                                 const gchar* interface_name,
-                                 const gchar* property_name,
-                                 GVariant** value,
-                                 GError** error,
-                                 gpointer user_data);
+    static GVariant* onGetProperty(GDBusConnection* connection,
+                                   const gchar* sender,
+                                   const gchar* object_path,
+                                   const gchar* interface_name,
+                                   const gchar* property_name,
+                                   GError** error,
+                                   gpointer user_data);
 
     // D-Bus接口定义
-    static const GDBusPropertyInfo interface_properties[];
-    static const GDBusInterfaceInfo interface_info_;
+    static GDBusInterfaceInfo* interfaceInfo();
     static const GDBusInterfaceVTable interface_vtable_;
 };
 
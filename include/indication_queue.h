@@ -0,0 +1,150 @@
+#ifndef INDICATION_QUEUE_H
+#define INDICATION_QUEUE_H
+
+#include <gio/gio.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "value_snapshot.h"
+
+namespace Bluetooth {
+
+// 指示完成状态
+enum class IndicationStatus {
+    CONFIRMED,  // 收到Confirm
+    TIMED_OUT,  // 重发次数用尽仍未确认
+    CANCELLED   // 订阅取消或特征值注销
+};
+
+// 指示完成回调
+using IndicationCallback = std::function<void(uint64_t indication_id, IndicationStatus status)>;
+
+// 指示发送配置
+struct IndicationConfig {
+    size_t window = 4;          // 同时未确认的指示上限
+    guint timeout_ms = 1000;    // 等待Confirm的超时（毫秒）
+    unsigned max_retries = 2;   // 超时后的重发次数
+    size_t max_pending = 64;    // 窗口已满时允许排队的指示上限
+    // 每个接收方每个指示应答的Confirm次数。BlueZ经同一个调用者为每个启用指示的设备各转发一次Confirm，
+    // 且不携带设备路径，已知连接的设备数时设为该值
+    unsigned confirms_per_recipient = 1;
+};
+
+// 指示统计
+struct IndicationStatistics {
+    size_t in_flight = 0;        // 已发送未确认
+    size_t pending = 0;          // 等待窗口
+    uint64_t confirmed = 0;      // 已确认
+    uint64_t timed_out = 0;      // 超时失败
+    uint64_t retransmitted = 0;  // 重发次数
+    uint64_t partial_timeouts = 0; // 部分接收方已确认时的超时（不重发，只延长等待）
+    uint64_t rejected = 0;       // 排队已满被拒绝
+};
+
+/**
+ * @brief 指示（INDICATE）发送队列
+ * 维护一个未确认指示的窗口：窗口未满时立即发送，发送时记下应当确认的接收方，
+ * 每个接收方的Confirm按该接收方的发送顺序记账，所有接收方都确认后指示才完成。
+ * 超时且没有任何接收方确认时重发；已有接收方确认时不再重发（信号是广播，会重复送达已确认的设备），
+ * 只延长等待。重发次数用尽则以TIMED_OUT完成
+ */
+class IndicationQueue {
+public:
+    using SendFunction = std::function<bool(const ValueSnapshot& value)>;
+    // 返回当前应当确认指示的接收方（Confirm调用者）
+    using RecipientsFunction = std::function<std::vector<std::string>()>;
+
+    IndicationQueue(SendFunction send_function, RecipientsFunction recipients_function);
+    ~IndicationQueue();
+
+    // 禁用拷贝构造和赋值
+    IndicationQueue(const IndicationQueue&) = delete;
+    IndicationQueue& operator=(const IndicationQueue&) = delete;
+
+    /**
+     * @brief 设置发送配置
+     * @param config 发送配置
+     */
+    void setConfig(const IndicationConfig& config);
+
+    /**
+     * @brief 获取发送配置
+     * @return 发送配置
+     */
+    const IndicationConfig& getConfig() const { return config_; }
+
+    /**
+     * @brief 提交一个指示
+     * @param value 指示数据
+     * @param callback 完成回调，可为空
+     * @param reserved_id 事先预留的指示ID，0表示分配新ID
+     * @return 指示ID，0表示排队已满被拒绝
+     */
+    uint64_t submit(const ValueSnapshot& value, IndicationCallback callback, uint64_t reserved_id = 0);
+
+    /**
+     * @brief 预留一个指示ID，供稍后提交（例如事务提交时才发送的指示）
+     * @return 指示ID
+     */
+    uint64_t reserveId() { return next_id_++; }
+
+    /**
+     * @brief 处理Confirm，记入该接收方最旧的未确认指示；所有接收方都确认后完成该指示
+     * @param recipient Confirm调用者
+     * @return true表示记入了某个指示，false表示该接收方没有未确认的指示
+     */
+    bool confirm(const std::string& recipient);
+
+    /**
+     * @brief 接收方取消订阅，不再等待它的Confirm；因此全部确认的指示随之完成
+     * @param recipient 接收方
+     */
+    void removeRecipient(const std::string& recipient);
+
+    /**
+     * @brief 取消所有未完成的指示
+     */
+    void cancelAll();
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    IndicationStatistics getStatistics() const;
+
+private:
+    struct Indication {
+        uint64_t id;
+        ValueSnapshot value;
+        IndicationCallback callback;
+        unsigned retries;
+        gint64 deadline;
+        std::map<std::string, unsigned> awaiting; // 接收方 -> 尚未收到的Confirm次数
+        bool partially_confirmed;                 // 已有接收方确认
+    };
+
+    SendFunction send_function_;
+    RecipientsFunction recipients_function_;
+    IndicationConfig config_;
+    std::deque<Indication> in_flight_;
+    std::deque<Indication> pending_;
+    uint64_t next_id_;
+    guint timer_id_;
+    IndicationStatistics stats_;
+
+    void pump();
+    void transmit(Indication& indication);
+    void retireConfirmed();
+    void complete(Indication indication, IndicationStatus status);
+    void armTimer();
+    void handleTimeouts();
+
+    static gboolean onTimeout(gpointer user_data);
+};
+
+} // namespace Bluetooth
+
+#endif // INDICATION_QUEUE_H
@@ -0,0 +1,119 @@
+#ifndef NOTIFICATION_DISPATCHER_H
+#define NOTIFICATION_DISPATCHER_H
+
+#include <gio/gio.h>
+#include <deque>
+#include <cstdint>
+
+namespace Bluetooth {
+
+class GattCharacteristic;
+
+// 通知优先级
+enum class NotificationPriority {
+    CRITICAL = 0,     // 告警等安全相关数据，抢占其他类别
+    INTERACTIVE = 1,  // 用户交互触发的更新
+    BULK = 2          // 批量遥测数据
+};
+
+constexpr size_t NOTIFICATION_PRIORITY_COUNT = 3;
+
+// 调度配置
+struct DispatcherConfig {
+    unsigned interactive_weight = 4;  // 每轮INTERACTIVE可发送的通知数
+    unsigned bulk_weight = 1;         // 每轮BULK可发送的通知数
+    size_t batch_limit = 16;          // 每次主循环分发最多发送的通知数，超出后让出主循环
+};
+
+// 单个优先级的统计
+struct PriorityClassStatistics {
+    size_t depth = 0;               // 当前排队数
+    size_t max_depth = 0;           // 历史最大排队数
+    uint64_t dispatched = 0;        // 已发送数
+    uint64_t total_latency_us = 0;  // 排队时延总和（微秒）
+    uint64_t max_latency_us = 0;    // 最大排队时延（微秒）
+};
+
+/**
+ * @brief 按优先级分发通知
+ * 每个优先级一个队列：CRITICAL总是先于其他类别发送，并把分发源提升到高优先级；
+ * INTERACTIVE与BULK按权重轮流发送，保证BULK不会被饿死。
+ * 同一特征值排队期间只占一个位置，发送时取最新值
+ */
+class NotificationDispatcher {
+public:
+    explicit NotificationDispatcher(const DispatcherConfig& config = DispatcherConfig());
+    ~NotificationDispatcher();
+
+    // 禁用拷贝构造和赋值
+    NotificationDispatcher(const NotificationDispatcher&) = delete;
+    NotificationDispatcher& operator=(const NotificationDispatcher&) = delete;
+
+    /**
+     * @brief 设置调度配置
+     * @param config 调度配置
+     */
+    void setConfig(const DispatcherConfig& config);
+
+    /**
+     * @brief 获取调度配置
+     * @return 调度配置
+     */
+    const DispatcherConfig& getConfig() const { return config_; }
+
+    /**
+     * @brief 按特征值的优先级排队
+     * @param characteristic GATT特征值实例
+     * @return true表示新入队，false表示已在队列中
+     */
+    bool submit(GattCharacteristic* characteristic);
+
+    /**
+     * @brief 取消特征值的待发送通知
+     * @param characteristic GATT特征值实例
+     */
+    void cancel(GattCharacteristic* characteristic);
+
+    /**
+     * @brief 立即发送所有排队的通知
+     */
+    void flush();
+
+    /**
+     * @brief 获取某个优先级的统计
+     * @param priority 优先级
+     * @return 统计信息
+     */
+    PriorityClassStatistics getStatistics(NotificationPriority priority) const;
+
+    /**
+     * @brief 清零统计计数（不影响当前排队数）
+     */
+    void resetStatistics();
+
+private:
+    struct Entry {
+        GattCharacteristic* characteristic;
+        gint64 enqueued_at;
+    };
+
+    DispatcherConfig config_;
+    std::deque<Entry> queues_[NOTIFICATION_PRIORITY_COUNT];
+    PriorityClassStatistics stats_[NOTIFICATION_PRIORITY_COUNT];
+    unsigned interactive_credits_;
+    unsigned bulk_credits_;
+    guint source_id_;
+    gint source_priority_;
+
+    bool dispatchOne();
+    void dispatch(size_t limit);
+    void deliver(NotificationPriority priority);
+    void scheduleDispatch();
+    void cancelDispatch();
+
+    static gboolean onDispatch(gpointer user_data);
+};
+
+} // namespace Bluetooth
+
+#endif // NOTIFICATION_DISPATCHER_H
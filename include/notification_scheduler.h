@@ -0,0 +1,97 @@
+#ifndef NOTIFICATION_SCHEDULER_H
+#define NOTIFICATION_SCHEDULER_H
+
+#include <gio/gio.h>
+#include <vector>
+#include <cstdint>
+
+namespace Bluetooth {
+
+class GattCharacteristic;
+
+/**
+ * @brief 通知合并调度器
+ * 特征值在一个刷新窗口内的多次setValue只标记为"脏"，
+ * 窗口到期时每个特征值只发送一次最新值的通知
+ */
+class NotificationScheduler {
+public:
+    /**
+     * @param flush_interval_ms 刷新窗口（毫秒），0表示每次主循环迭代刷新一次
+     */
+    explicit NotificationScheduler(guint flush_interval_ms = 0);
+    ~NotificationScheduler();
+
+    // 禁用拷贝构造和赋值
+    NotificationScheduler(const NotificationScheduler&) = delete;
+    NotificationScheduler& operator=(const NotificationScheduler&) = delete;
+
+    /**
+     * @brief 设置刷新窗口
+     * @param flush_interval_ms 刷新窗口（毫秒），0表示每次主循环迭代刷新一次
+     */
+    void setFlushInterval(guint flush_interval_ms);
+
+    /**
+     * @brief 获取刷新窗口
+     * @return 刷新窗口（毫秒）
+     */
+    guint getFlushInterval() const { return flush_interval_ms_; }
+
+    /**
+     * @brief 标记特征值待通知
+     * @param characteristic GATT特征值实例
+     * @return true表示新加入待刷新列表，false表示与已有的待发送通知合并
+     */
+    bool markDirty(GattCharacteristic* characteristic);
+
+    /**
+     * @brief 取消特征值的待发送通知
+     * @param characteristic GATT特征值实例
+     */
+    void cancel(GattCharacteristic* characteristic);
+
+    /**
+     * @brief 立即刷新所有待发送通知
+     */
+    void flush();
+
+    /**
+     * @brief 获取待刷新的特征值数量
+     * @return 待刷新数量
+     */
+    size_t getPendingCount() const { return pending_.size(); }
+
+    /**
+     * @brief 获取被合并掉的更新总数
+     * @return 合并数量
+     */
+    uint64_t getCoalescedCount() const { return coalesced_count_; }
+
+    /**
+     * @brief 获取刷新时实际发出的通知总数
+     * @return 发送数量
+     */
+    uint64_t getSentCount() const { return sent_count_; }
+
+    /**
+     * @brief 清零统计计数
+     */
+    void resetStatistics();
+
+private:
+    guint flush_interval_ms_;
+    guint source_id_;
+    std::vector<GattCharacteristic*> pending_;
+    uint64_t coalesced_count_;
+    uint64_t sent_count_;
+
+    void scheduleFlush();
+    void cancelFlush();
+
+    static gboolean onFlush(gpointer user_data);
+};
+
+} // namespace Bluetooth
+
+#endif // NOTIFICATION_SCHEDULER_H
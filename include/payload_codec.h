@@ -0,0 +1,133 @@
+#ifndef PAYLOAD_CODEC_H
+#define PAYLOAD_CODEC_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "byte_value.h"
+
+namespace Bluetooth {
+
+// 通知负载编码方式
+enum class PayloadEncoding {
+    NONE,   // 原样发送完整值（默认，无帧头）
+    XOR,    // 与上一帧按字节异或，只发送非零区段
+    DELTA   // 按字段求差，差值以zig-zag变长整数发送
+};
+
+// 帧类型，位于帧头高两位
+enum class PayloadFrameType : uint8_t {
+    KEYFRAME = 0,  // 完整值
+    XOR = 1,       // 异或帧
+    DELTA = 2      // 差分帧
+};
+
+// 编码配置，解码端必须使用相同的配置
+struct PayloadEncodingConfig {
+    PayloadEncoding mode = PayloadEncoding::NONE;
+    size_t keyframe_interval = 32;  // 每隔多少帧强制发送关键帧，0表示只在需要时发送
+    size_t word_size = 1;           // DELTA模式下字段宽度（1、2或4字节，小端）
+};
+
+// 编码统计
+struct PayloadEncodingStatistics {
+    uint64_t raw_bytes = 0;      // 编码前字节数
+    uint64_t encoded_bytes = 0;  // 编码后字节数（含帧头）
+    uint64_t keyframes = 0;      // 关键帧数
+    uint64_t delta_frames = 0;   // 异或帧和差分帧数
+    uint64_t oversized = 0;      // 关键帧超过帧长上限而未发送的值
+};
+
+/**
+ * @brief 帧格式
+ * 1字节帧头：高两位为帧类型，低六位为序号（逐帧加一，模64）。
+ * 关键帧：帧头后跟完整值。
+ * 异或帧/差分帧：长度与上一帧相同，帧体由若干区段组成，每段为
+ * [变长整数 不变单元数][变长整数 变化单元数][变化单元数据]，末尾的不变单元省略。
+ * 异或帧的单元为字节，变化数据为异或结果；差分帧的单元为字段，
+ * 变化数据为每个字段差值的zig-zag变长整数。
+ */
+constexpr uint8_t PAYLOAD_FRAME_SEQUENCE_MASK = 0x3F;
+constexpr size_t PAYLOAD_FRAME_HEADER_SIZE = 1;
+
+/**
+ * @brief 负载编码器，维护一个编码流：特征值的信号订阅者共享一个，每个套接字订阅者各有一个
+ */
+class PayloadEncoder {
+public:
+    explicit PayloadEncoder(const PayloadEncodingConfig& config);
+
+    /**
+     * @brief 编码一个新值
+     * 差分帧超过上限时改发关键帧；关键帧也超过上限时不发送该值，编码状态不变，
+     * 解码端停留在上一个值，之后的帧仍能正确解码（截断的关键帧会让之后的差分帧全部解错）
+     * @param value 完整值
+     * @param max_frame_size 帧长上限（含帧头），通常为MTU-3
+     * @return 带帧头的编码结果；mode为NONE时原样返回；关键帧放不下时返回空值
+     */
+    ByteValue encode(const ByteValue& value, size_t max_frame_size = std::numeric_limits<size_t>::max());
+
+    /**
+     * @brief 要求下一帧为关键帧（新订阅者加入时调用）
+     */
+    void requestKeyframe() { keyframe_requested_ = true; }
+
+    /**
+     * @brief 获取编码配置
+     * @return 编码配置
+     */
+    const PayloadEncodingConfig& getConfig() const { return config_; }
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    const PayloadEncodingStatistics& getStatistics() const { return stats_; }
+
+private:
+    PayloadEncodingConfig config_;
+    ByteValue previous_;
+    bool has_previous_;
+    bool keyframe_requested_;
+    uint8_t sequence_;
+    size_t frames_since_keyframe_;
+    PayloadEncodingStatistics stats_;
+
+    ByteValue encodeKeyframe(const ByteValue& value);
+    ByteValue rejectOversized(const ByteValue& value);
+};
+
+/**
+ * @brief 参考解码器，供客户端实现和测试对照
+ * 丢帧（序号不连续）后拒绝后续非关键帧，直到收到下一个关键帧
+ */
+class PayloadDecoder {
+public:
+    explicit PayloadDecoder(const PayloadEncodingConfig& config);
+
+    /**
+     * @brief 解码一帧
+     * @param data 帧数据
+     * @param size 帧长度
+     * @param value 输出解码后的完整值
+     * @return true表示成功，false表示帧格式错误或丢帧后等待关键帧
+     */
+    bool decode(const uint8_t* data, size_t size, std::vector<uint8_t>& value);
+
+    /**
+     * @brief 是否已同步（收到过关键帧且之后没有丢帧）
+     * @return true表示已同步
+     */
+    bool isSynchronized() const { return synchronized_; }
+
+private:
+    PayloadEncodingConfig config_;
+    std::vector<uint8_t> current_;
+    bool synchronized_;
+    uint8_t last_sequence_;
+};
+
+} // namespace Bluetooth
+
+#endif // PAYLOAD_CODEC_H
@@ -0,0 +1,57 @@
+#ifndef PROPERTIES_CHANGED_TEMPLATE_H
+#define PROPERTIES_CHANGED_TEMPLATE_H
+
+#include <gio/gio.h>
+#include <string>
+
+namespace Bluetooth {
+
+/**
+ * @brief PropertiesChanged信号模板
+ * 预先构建信号中不变的部分：带对象路径、接口和成员头部的消息，以及接口名、属性名键和空的失效属性数组。
+ * 每次发送复制模板消息并换上由新属性值拼接的消息体
+ */
+class PropertiesChangedTemplate {
+public:
+    PropertiesChangedTemplate(const std::string& object_path,
+                              const std::string& interface_name,
+                              const std::string& property_name);
+    ~PropertiesChangedTemplate();
+
+    // 禁用拷贝构造和赋值
+    PropertiesChangedTemplate(const PropertiesChangedTemplate&) = delete;
+    PropertiesChangedTemplate& operator=(const PropertiesChangedTemplate&) = delete;
+
+    /**
+     * @brief 获取属性名
+     * @return 属性名
+     */
+    const std::string& getPropertyName() const { return property_name_; }
+
+    /**
+     * @brief 构建信号消息
+     * @param value 新的属性值（浮动引用会被接管）
+     * @return 待发送的信号消息，调用者负责释放
+     */
+    GDBusMessage* build(GVariant* value) const;
+
+    /**
+     * @brief 构建并发送信号
+     * @param connection D-Bus连接
+     * @param value 新的属性值（浮动引用会被接管）
+     * @return true表示成功，false表示失败
+     */
+    bool emit(GDBusConnection* connection, GVariant* value) const;
+
+private:
+    std::string object_path_;
+    std::string property_name_;
+    GDBusMessage* message_;
+    GVariant* interface_name_;
+    GVariant* property_key_;
+    GVariant* invalidated_;
+};
+
+} // namespace Bluetooth
+
+#endif // PROPERTIES_CHANGED_TEMPLATE_H
@@ -0,0 +1,140 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <gio/gio.h>
+#include <functional>
+#include <cstdint>
+
+namespace Bluetooth {
+
+// 超出速率限制时的处理策略
+enum class RateLimitPolicy {
+    DELAY_LATEST,  // 推迟到有令牌时发送，期间只保留最新值
+    DROP           // 直接丢弃并计数
+};
+
+// 令牌桶配置
+struct RateLimitConfig {
+    double rate = 0.0;   // 每秒补充的令牌数（通知数），0表示不限速
+    double burst = 1.0;  // 桶容量，允许的突发通知数
+    RateLimitPolicy policy = RateLimitPolicy::DELAY_LATEST;
+};
+
+// 限速统计
+struct RateLimitStatistics {
+    uint64_t passed = 0;   // 直接放行的通知数
+    uint64_t delayed = 0;  // 被推迟发送的通知数
+    uint64_t dropped = 0;  // 被丢弃或被更新值覆盖的通知数
+};
+
+/**
+ * @brief 令牌桶
+ * 按配置速率补充令牌，每次通知消耗一个令牌
+ */
+class TokenBucket {
+public:
+    TokenBucket();
+    explicit TokenBucket(const RateLimitConfig& config);
+
+    /**
+     * @brief 修改配置，可在运行时调用；已有令牌按新容量截断
+     * @param config 令牌桶配置
+     */
+    void configure(const RateLimitConfig& config);
+
+    /**
+     * @brief 获取配置
+     * @return 令牌桶配置
+     */
+    const RateLimitConfig& getConfig() const { return config_; }
+
+    /**
+     * @brief 是否启用限速
+     * @return true表示启用
+     */
+    bool isLimited() const { return config_.rate > 0.0; }
+
+    /**
+     * @brief 尝试消耗一个令牌
+     * @param now_us 当前单调时间（微秒）
+     * @return true表示放行，false表示超出速率
+     */
+    bool tryConsume(gint64 now_us);
+
+    /**
+     * @brief 计算距离下一个令牌可用的时间
+     * @param now_us 当前单调时间（微秒）
+     * @return 等待时间（微秒），0表示已有令牌
+     */
+    gint64 getDelayUntilAvailable(gint64 now_us);
+
+private:
+    RateLimitConfig config_;
+    double tokens_;
+    gint64 last_refill_us_;
+
+    void refill(gint64 now_us);
+};
+
+/**
+ * @brief 带推迟发送的限速器
+ * 超出速率时按策略丢弃或在令牌可用时回调一次，由调用者发送届时的最新值
+ */
+class RateLimiter {
+public:
+    using ReleaseCallback = std::function<void()>;
+
+    explicit RateLimiter(ReleaseCallback release_callback);
+    ~RateLimiter();
+
+    // 禁用拷贝构造和赋值
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /**
+     * @brief 修改限速配置，可在运行时调用
+     * @param config 令牌桶配置
+     */
+    void configure(const RateLimitConfig& config);
+
+    /**
+     * @brief 获取限速配置
+     * @return 令牌桶配置
+     */
+    const RateLimitConfig& getConfig() const { return bucket_.getConfig(); }
+
+    /**
+     * @brief 申请发送一次通知
+     * @return true表示立即发送，false表示已丢弃或已推迟（推迟时稍后调用释放回调）
+     */
+    bool admit();
+
+    /**
+     * @brief 取消推迟中的发送
+     */
+    void cancel();
+
+    /**
+     * @brief 是否有推迟中的发送
+     * @return true表示令牌可用时会调用释放回调
+     */
+    bool isDelaying() const { return timer_id_ != 0; }
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    const RateLimitStatistics& getStatistics() const { return stats_; }
+
+private:
+    TokenBucket bucket_;
+    ReleaseCallback release_callback_;
+    guint timer_id_;
+    RateLimitStatistics stats_;
+
+    static gboolean onRelease(gpointer user_data);
+};
+
+} // namespace Bluetooth
+
+#endif // RATE_LIMITER_H
@@ -0,0 +1,113 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <sched.h>
+
+namespace Bluetooth {
+
+/**
+ * @brief 单写者seqlock的读写实现，ValueSlot和共享内存值表共用
+ * 数据按64位原子字存放，读写并发时每个字都是原子访问；
+ * 序号为奇数表示写入中，读者发现序号变化后重试。
+ * 原子变量是无锁且与地址无关的，也可以放在跨进程共享的内存中
+ */
+namespace Seqlock {
+
+constexpr size_t WORD_SIZE = sizeof(uint64_t);
+
+inline size_t wordCount(size_t bytes) {
+    return (bytes + WORD_SIZE - 1) / WORD_SIZE;
+}
+
+/**
+ * @brief 写入新值（同一时刻只允许一个写者）
+ * @param sequence 序号
+ * @param size 长度
+ * @param words 数据字，容量由调用者保证
+ * @param data 数据
+ * @param length 长度
+ */
+inline void write(std::atomic<uint64_t>& sequence, std::atomic<uint64_t>& size,
+                  std::atomic<uint64_t>* words, const uint8_t* data, size_t length) {
+    uint64_t current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < wordCount(length); ++i) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i * WORD_SIZE, std::min(WORD_SIZE, length - i * WORD_SIZE));
+        words[i].store(word, std::memory_order_relaxed);
+    }
+    size.store(length, std::memory_order_relaxed);
+
+    sequence.store(current + 2, std::memory_order_release);
+}
+
+/**
+ * @brief 尝试读取完整的一帧，写者持续处于写入中时放弃
+ * 写者位于其他进程时可能在写入中途退出，序号永远停在奇数，无限重试会让读者卡死
+ * @param sequence 序号
+ * @param size 长度
+ * @param words 数据字
+ * @param capacity 数据容量（字节），防止共享内存中的长度被篡改后越界
+ * @param value 输出，需提供resize()和data()
+ * @param max_attempts 最多尝试次数
+ * @param version 输出读到的值的版本号（序号的一半），0表示尚未写入过
+ * @return true表示读到完整的一帧，false表示尝试次数用完
+ */
+template <typename Buffer>
+bool tryRead(const std::atomic<uint64_t>& sequence, const std::atomic<uint64_t>& size,
+             const std::atomic<uint64_t>* words, size_t capacity, Buffer& value,
+             size_t max_attempts, uint64_t& version) {
+    for (size_t attempt = 0; attempt < max_attempts; ++attempt) {
+        uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            // 写者正在写入，让出CPU后重试
+            sched_yield();
+            continue;
+        }
+
+        size_t length = std::min<size_t>(size.load(std::memory_order_relaxed), capacity);
+        value.resize(length);
+        for (size_t i = 0; i < wordCount(length); ++i) {
+            uint64_t word = words[i].load(std::memory_order_relaxed);
+            std::memcpy(value.data() + i * WORD_SIZE, &word, std::min(WORD_SIZE, length - i * WORD_SIZE));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            version = before / 2;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 读取完整的一帧，写者写入中时一直重试（只用于同一进程内的写者）
+ * @param sequence 序号
+ * @param size 长度
+ * @param words 数据字
+ * @param capacity 数据容量（字节）
+ * @param value 输出，需提供resize()和data()
+ * @return 读到的值的版本号（序号的一半），0表示尚未写入过
+ */
+template <typename Buffer>
+uint64_t read(const std::atomic<uint64_t>& sequence, const std::atomic<uint64_t>& size,
+              const std::atomic<uint64_t>* words, size_t capacity, Buffer& value) {
+    uint64_t version = 0;
+    while (!tryRead(sequence, size, words, capacity, value, SIZE_MAX, version)) {
+    }
+    return version;
+}
+
+} // namespace Seqlock
+
+} // namespace Bluetooth
+
+#endif // SEQLOCK_H
@@ -0,0 +1,208 @@
+#ifndef SHARED_VALUE_TABLE_H
+#define SHARED_VALUE_TABLE_H
+
+#include <gio/gio.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "byte_value.h"
+
+namespace Bluetooth {
+
+class GattCharacteristic;
+
+// 每个槽位默认容量，等于ATT属性值的最大长度
+constexpr size_t SHARED_TABLE_DEFAULT_SLOT_SIZE = 512;
+
+// 读取槽位时最多尝试的次数，生产者进程在写入中途退出时槽位序号停在奇数，超过后放弃本次读取
+constexpr size_t SHARED_TABLE_READ_ATTEMPTS = 64;
+
+/**
+ * @brief 跨进程共享的特征值表
+ * 一块内存映射区域（memfd或/dev/shm下的文件），头部之后是定长槽位，
+ * 每个槽位是一个seqlock：外部生产者进程直接写入共享内存，不经过D-Bus或套接字协议。
+ * 绑定eventfd后，生产者只在服务端处理完上一次唤醒后才写一次eventfd，连续写入不增加系统调用
+ */
+class SharedValueTable {
+public:
+    SharedValueTable();
+    ~SharedValueTable();
+
+    // 禁用拷贝构造和赋值
+    SharedValueTable(const SharedValueTable&) = delete;
+    SharedValueTable& operator=(const SharedValueTable&) = delete;
+
+    /**
+     * @brief 创建并映射新的值表（服务端调用）
+     * @param name /dev/shm下的名称（如"bluetooth-values"），为空时使用匿名memfd，需通过getFd()传给生产者
+     * @param slot_count 槽位数
+     * @param slot_size 每个槽位的最大值长度
+     * @return true表示成功，false表示失败
+     */
+    bool create(const std::string& name, size_t slot_count, size_t slot_size = SHARED_TABLE_DEFAULT_SLOT_SIZE);
+
+    /**
+     * @brief 按名称打开已有的值表（生产者进程调用）
+     * @param name 创建时使用的名称
+     * @return true表示成功，false表示失败
+     */
+    bool open(const std::string& name);
+
+    /**
+     * @brief 通过文件描述符映射已有的值表（如继承或经SCM_RIGHTS收到的memfd）
+     * @param fd 文件描述符，函数内部复制，调用者仍持有原描述符
+     * @return true表示成功，false表示失败
+     */
+    bool attach(int fd);
+
+    /**
+     * @brief 解除映射并关闭描述符
+     */
+    void close();
+
+    bool isOpen() const { return base_ != nullptr; }
+    int getFd() const { return fd_; }
+    size_t getSlotCount() const { return slot_count_; }
+    size_t getSlotSize() const { return slot_size_; }
+
+    /**
+     * @brief 创建唤醒用的eventfd（服务端调用）
+     * @return true表示成功，false表示失败
+     */
+    bool createEventFd();
+
+    /**
+     * @brief 设置唤醒用的eventfd（生产者进程调用），函数内部复制描述符
+     * @param fd eventfd描述符
+     * @return true表示成功，false表示失败
+     */
+    bool setEventFd(int fd);
+
+    int getEventFd() const { return event_fd_; }
+
+    /**
+     * @brief 写入槽位（每个槽位同一时刻只允许一个写者）
+     * @param slot 槽位下标
+     * @param data 数据
+     * @param size 长度
+     * @return true表示成功，false表示下标越界或超过槽位容量
+     */
+    bool publish(size_t slot, const uint8_t* data, size_t size);
+
+    /**
+     * @brief 尝试读取槽位的最新值，写者长时间处于写入中（如生产者进程中途退出）时放弃
+     * @param slot 槽位下标
+     * @param value 输出特征值数据
+     * @param version 输出值的版本号，0表示尚未写入
+     * @return true表示读到完整的值，false表示下标越界或槽位停在写入中
+     */
+    bool tryRead(size_t slot, ByteValue& value, uint64_t& version) const;
+
+    /**
+     * @brief 读取槽位的最新值
+     * @param slot 槽位下标
+     * @param value 输出特征值数据
+     * @return 值的版本号，0表示尚未写入、下标越界或槽位停在写入中
+     */
+    uint64_t read(size_t slot, ByteValue& value) const;
+
+    /**
+     * @brief 获取槽位当前版本号（不读取数据）
+     * @param slot 槽位下标
+     * @return 版本号
+     */
+    uint64_t getVersion(size_t slot) const;
+
+    /**
+     * @brief 处理一次eventfd唤醒：清空计数并复位门铃，之后的写入会再次唤醒（服务端调用）
+     */
+    void acknowledgeWakeup();
+
+private:
+    void* base_;
+    size_t mapped_size_;
+    int fd_;
+    int event_fd_;
+    size_t slot_count_;
+    size_t slot_size_;
+    size_t slot_stride_;
+
+    bool map(int fd, bool initialize, size_t slot_count, size_t slot_size);
+    uint8_t* slotAddress(size_t slot) const;
+};
+
+/**
+ * @brief 将值表中的槽位绑定到特征值，在主循环中把变化的槽位转换为setValue()
+ * 可以按固定间隔轮询，也可以监听值表的eventfd
+ */
+class SharedValueTableWatch {
+public:
+    explicit SharedValueTableWatch(std::shared_ptr<SharedValueTable> table);
+    ~SharedValueTableWatch();
+
+    // 禁用拷贝构造和赋值
+    SharedValueTableWatch(const SharedValueTableWatch&) = delete;
+    SharedValueTableWatch& operator=(const SharedValueTableWatch&) = delete;
+
+    /**
+     * @brief 绑定槽位到特征值
+     * @param slot 槽位下标
+     * @param characteristic GATT特征值实例
+     * @return true表示成功，false表示下标越界
+     */
+    bool bindSlot(size_t slot, std::shared_ptr<GattCharacteristic> characteristic);
+
+    /**
+     * @brief 解除槽位绑定
+     * @param slot 槽位下标
+     */
+    void unbindSlot(size_t slot);
+
+    /**
+     * @brief 按固定间隔轮询
+     * @param interval_ms 轮询间隔（毫秒）
+     */
+    void startPolling(guint interval_ms);
+
+    /**
+     * @brief 监听值表的eventfd（需先调用SharedValueTable::createEventFd()）
+     * @return true表示成功，false表示值表没有eventfd
+     */
+    bool startEventWatch();
+
+    /**
+     * @brief 停止轮询和eventfd监听
+     */
+    void stop();
+
+    /**
+     * @brief 立即检查所有绑定的槽位
+     * @return 发生变化的槽位数
+     */
+    size_t poll();
+
+private:
+    struct Binding {
+        size_t slot;
+        std::weak_ptr<GattCharacteristic> characteristic;
+        uint64_t consumed_version;
+        bool stalled;  // 槽位停在写入中，已记录过日志
+        bool removed;  // poll()期间解除绑定，遍历结束后移除
+    };
+
+    std::shared_ptr<SharedValueTable> table_;
+    std::vector<Binding> bindings_;
+    ByteValue buffer_;
+    bool polling_;
+    guint poll_source_id_;
+    guint event_source_id_;
+
+    static gboolean onPollTimer(gpointer user_data);
+    static gboolean onEventFd(gint fd, GIOCondition condition, gpointer user_data);
+};
+
+} // namespace Bluetooth
+
+#endif // SHARED_VALUE_TABLE_H
@@ -0,0 +1,127 @@
+#ifndef STREAM_FRAMING_H
+#define STREAM_FRAMING_H
+
+#include <gio/gio.h>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "byte_value.h"
+#include "value_snapshot.h"
+
+namespace Bluetooth {
+
+// 分块头部：1字节，bit7表示首块，bit6表示末块，低6位为块序号（模64）
+constexpr size_t STREAM_HEADER_SIZE = 1;
+constexpr uint8_t STREAM_FLAG_FIRST = 0x80;
+constexpr uint8_t STREAM_FLAG_LAST = 0x40;
+constexpr uint8_t STREAM_SEQUENCE_MASK = 0x3F;
+
+// 接收端默认的最大消息长度
+constexpr size_t STREAM_DEFAULT_MAX_MESSAGE_SIZE = 64 * 1024;
+
+// 数据生产者：向buffer写入最多capacity字节，返回写入的字节数，0表示数据结束
+using StreamProducer = std::function<size_t(uint8_t* buffer, size_t capacity)>;
+
+// 流发送完成回调：completed为false表示被取消或订阅者全部离开
+using StreamCallback = std::function<void(bool completed)>;
+
+// 流发送节奏
+struct StreamConfig {
+    guint interval_ms = 10;       // 发送间隔（毫秒）
+    size_t chunks_per_tick = 4;   // 每次最多发送的块数，订阅者队列越过高水位时提前停止
+};
+
+/**
+ * @brief 把生产者的数据切分为带头部的定长块
+ * 每块负载尽量填满chunk_payload_size；预读下一块以便在当前块上标记末块，
+ * 空数据也会产生一个同时带首块和末块标志的空块
+ */
+class StreamChunker {
+public:
+    /**
+     * @param producer 数据生产者
+     * @param chunk_payload_size 每块的负载长度（不含头部）
+     */
+    StreamChunker(StreamProducer producer, size_t chunk_payload_size);
+
+    // 禁用拷贝构造和赋值
+    StreamChunker(const StreamChunker&) = delete;
+    StreamChunker& operator=(const StreamChunker&) = delete;
+
+    /**
+     * @brief 生成下一块
+     * @param chunk 输出带头部的块
+     * @return true表示生成了一块，false表示已经结束
+     */
+    bool next(ValueSnapshot& chunk);
+
+    bool isFinished() const { return finished_; }
+    size_t getChunkPayloadSize() const { return payload_size_; }
+    uint64_t getChunkCount() const { return chunks_; }
+    uint64_t getByteCount() const { return bytes_; }
+
+private:
+    StreamProducer producer_;
+    size_t payload_size_;
+    ByteValue frame_;
+    ByteValue lookahead_;
+    size_t lookahead_size_;
+    uint8_t sequence_;
+    bool started_;
+    bool exhausted_;
+    bool finished_;
+    uint64_t chunks_;
+    uint64_t bytes_;
+
+    size_t fill(uint8_t* buffer);
+};
+
+// 重组结果
+enum class ReassemblyStatus {
+    INCOMPLETE,  // 等待后续块
+    COMPLETE,    // 收到末块，getMessage()可用
+    ERROR        // 序号不连续、缺少首块或超过长度上限，已丢弃当前消息
+};
+
+/**
+ * @brief 接收端的分块重组
+ * 按序号校验块的连续性，收到末块后得到完整消息
+ */
+class StreamReassembler {
+public:
+    explicit StreamReassembler(size_t max_message_size = STREAM_DEFAULT_MAX_MESSAGE_SIZE);
+
+    /**
+     * @brief 处理一个块（一次通知的负载）
+     * @param data 数据
+     * @param size 长度
+     * @return 重组结果
+     */
+    ReassemblyStatus push(const uint8_t* data, size_t size);
+
+    /**
+     * @brief 获取最近重组完成的消息，下一次push()之前有效
+     * @return 消息数据
+     */
+    const ByteValue& getMessage() const { return message_; }
+
+    /**
+     * @brief 丢弃进行中的消息
+     */
+    void reset();
+
+    uint64_t getErrorCount() const { return errors_; }
+
+private:
+    size_t max_message_size_;
+    ByteValue message_;
+    uint8_t expected_sequence_;
+    bool in_progress_;
+    uint64_t errors_;
+
+    ReassemblyStatus fail();
+};
+
+} // namespace Bluetooth
+
+#endif // STREAM_FRAMING_H
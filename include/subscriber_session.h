@@ -0,0 +1,225 @@
+#ifndef SUBSCRIBER_SESSION_H
+#define SUBSCRIBER_SESSION_H
+
+#include <gio/gio.h>
+#include <deque>
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include "rate_limiter.h"
+#include "value_snapshot.h"
+#include "payload_codec.h"
+
+namespace Bluetooth {
+
+// 订阅者队列已满时的处理策略
+enum class DropPolicy {
+    DROP_OLDEST,    // 丢弃队首最旧的通知
+    DROP_NEWEST,    // 丢弃新到的通知
+    BLOCK_PRODUCER  // 拒绝生产者的更新，等待低水位回调后重试
+};
+
+// 订阅者出队列配置
+struct SubscriberQueueConfig {
+    size_t capacity = 32;        // 队列容量（通知条数）
+    size_t high_watermark = 24;  // 达到该深度时通知生产者限流
+    size_t low_watermark = 8;    // 回落到该深度时通知生产者恢复
+    DropPolicy drop_policy = DropPolicy::DROP_OLDEST;
+};
+
+// 订阅者统计
+struct SubscriberStatistics {
+    size_t queued = 0;      // 当前排队的通知数
+    uint64_t sent = 0;      // 已发出的通知数
+    uint64_t dropped = 0;   // 因队列满而丢弃的通知数
+    uint64_t truncated = 0; // 超过MTU-3被截断发出的通知数
+    bool congested = false; // 是否处于高水位以上
+    uint16_t mtu = 0;       // 通知套接字MTU，0表示经由D-Bus信号
+    RateLimitStatistics rate_limit; // 订阅者级限速统计
+};
+
+// 排队中的通知负载，多个订阅者共享同一个快照
+using NotificationPayload = ValueSnapshot;
+
+// 水位回调：congested为true表示越过高水位，false表示回落到低水位
+using WatermarkCallback = std::function<void(const std::string& device_path, bool congested)>;
+
+/**
+ * @brief 单个订阅者的通知会话
+ * 持有订阅者的有界出队列；通过AcquireNotify套接字订阅时负责非阻塞写出，
+ * 套接字写满后等待可写事件，不影响其他订阅者。
+ * 启用负载编码时队列中保存完整值，写出时才用会话自己的编码器编码，
+ * 队列丢弃和限速替换不会打乱该订阅者的解码序列
+ */
+class SubscriberSession {
+public:
+    using ClosedCallback = std::function<void(const std::string& device_path)>;
+
+    SubscriberSession(const std::string& device_path, const SubscriberQueueConfig& config);
+    ~SubscriberSession();
+
+    // 禁用拷贝构造和赋值
+    SubscriberSession(const SubscriberSession&) = delete;
+    SubscriberSession& operator=(const SubscriberSession&) = delete;
+
+    /**
+     * @brief 绑定通知套接字，会话接管文件描述符
+     * @param fd 本地一端的文件描述符（非阻塞）
+     * @param mtu 协商的ATT MTU
+     * @return true表示成功，false表示已绑定套接字
+     */
+    bool attachSocket(int fd, uint16_t mtu);
+
+    /**
+     * @brief 是否经由套接字发送
+     * @return true表示持有套接字
+     */
+    bool hasSocket() const { return fd_ >= 0; }
+
+    /**
+     * @brief 套接字是否已失效（出错或对端关闭），等待所属特征值移除
+     * @return true表示已失效
+     */
+    bool isClosed() const { return closed_; }
+
+    /**
+     * @brief 获取设备路径
+     * @return 设备路径
+     */
+    const std::string& getDevicePath() const { return device_path_; }
+
+    /**
+     * @brief 获取MTU
+     * @return ATT MTU
+     */
+    uint16_t getMtu() const { return mtu_; }
+
+    /**
+     * @brief 设置队列配置
+     * @param config 队列配置
+     */
+    void setQueueConfig(const SubscriberQueueConfig& config);
+
+    /**
+     * @brief 获取队列配置
+     * @return 队列配置
+     */
+    const SubscriberQueueConfig& getQueueConfig() const { return config_; }
+
+    /**
+     * @brief 设置订阅者级限速，可在运行时调用（仅对套接字订阅者生效）
+     * @param config 令牌桶配置
+     */
+    void setRateLimit(const RateLimitConfig& config);
+
+    /**
+     * @brief 获取订阅者级限速配置
+     * @return 令牌桶配置
+     */
+    const RateLimitConfig& getRateLimit() const { return rate_limiter_.getConfig(); }
+
+    /**
+     * @brief 队列满且策略为BLOCK_PRODUCER时，生产者应暂停
+     * @return true表示应拒绝新的更新
+     */
+    bool isBlockingProducer() const;
+
+    /**
+     * @brief 是否可以无损地再入队一条：队列低于高水位且未被限速推迟（用于分块流的节奏控制）
+     * @return true表示可以入队
+     */
+    bool canAcceptWithoutLoss() const;
+
+    /**
+     * @brief 经过订阅者级限速后入队并尽量写出
+     * @param payload 通知负载
+     * @param encode 写出时是否经过负载编码（分块流等自带帧格式的数据为false）
+     * @return true表示已入队，false表示被限速推迟、按策略丢弃
+     */
+    bool enqueue(const NotificationPayload& payload, bool encode = true);
+
+    /**
+     * @brief 不经过限速直接入队分块流的一块（不编码）
+     * 丢弃策略的限速会无声地丢掉分块，节奏由canAcceptWithoutLoss()和StreamConfig控制
+     * @param chunk 带分块头部的数据
+     * @return true表示已入队
+     */
+    bool enqueueStreamChunk(const NotificationPayload& chunk);
+
+    /**
+     * @brief 设置负载编码（仅对套接字订阅者生效），新编码器的第一帧为关键帧
+     * @param config 编码配置，mode为NONE时关闭编码
+     */
+    void setPayloadEncoding(const PayloadEncodingConfig& config);
+
+    /**
+     * @brief 获取负载编码统计
+     * @return 统计信息，未启用编码时为空
+     */
+    PayloadEncodingStatistics getPayloadEncodingStatistics() const;
+
+    /**
+     * @brief 记录一次经由D-Bus信号的广播发送
+     */
+    void recordBroadcast() { stats_.sent++; }
+
+    /**
+     * @brief 设置水位回调
+     * @param callback 回调函数
+     */
+    void setWatermarkCallback(WatermarkCallback callback) { watermark_callback_ = callback; }
+
+    /**
+     * @brief 设置套接字关闭回调（对端挂断或写入出错时从主循环中调用）
+     * @param callback 回调函数
+     */
+    void setClosedCallback(ClosedCallback callback) { closed_callback_ = callback; }
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    SubscriberStatistics getStatistics() const;
+
+private:
+    struct QueuedNotification {
+        NotificationPayload payload;
+        bool encode;  // 写出前还需要编码
+    };
+
+    std::string device_path_;
+    SubscriberQueueConfig config_;
+    std::deque<QueuedNotification> queue_;
+    int fd_;
+    uint16_t mtu_;
+    guint watch_id_;
+    guint writable_watch_id_;
+    bool closed_;
+    bool congested_;
+    SubscriberStatistics stats_;
+    RateLimiter rate_limiter_;
+    NotificationPayload delayed_payload_;
+    bool delayed_encode_;
+    std::unique_ptr<PayloadEncoder> encoder_;
+    bool front_encoded_;  // 队首已编码但还没有写出
+
+    WatermarkCallback watermark_callback_;
+    ClosedCallback closed_callback_;
+
+    bool push(const NotificationPayload& payload, bool encode);
+    void dropOldest();
+    void releaseDelayed();
+    bool flushQueue();
+    void updateWatermarks();
+    void markClosed();
+    void notifyClosed();
+
+    static gboolean onSocketEvent(gint fd, GIOCondition condition, gpointer user_data);
+    static gboolean onSocketWritable(gint fd, GIOCondition condition, gpointer user_data);
+};
+
+} // namespace Bluetooth
+
+#endif // SUBSCRIBER_SESSION_H
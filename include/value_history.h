@@ -0,0 +1,101 @@
+#ifndef VALUE_HISTORY_H
+#define VALUE_HISTORY_H
+
+#include <gio/gio.h>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+namespace Bluetooth {
+
+// 历史记录中单个值的默认最大长度，等于ATT属性值的最大长度
+constexpr size_t HISTORY_DEFAULT_MAX_VALUE_SIZE = 512;
+
+// 历史记录访问回调，timestamp_us为g_get_monotonic_time()时间戳
+using HistoryVisitor = std::function<void(gint64 timestamp_us, const uint8_t* data, size_t size)>;
+
+// 历史记录统计
+struct HistoryStatistics {
+    size_t count = 0;           // 当前保存的样本数
+    uint64_t appended = 0;      // 累计写入样本数
+    uint64_t overwritten = 0;   // 被新样本覆盖的样本数
+    uint64_t oversized = 0;     // 超过单值最大长度而被拒绝的样本数
+};
+
+/**
+ * @brief 定长环形历史记录
+ * 构造时一次性分配capacity个槽位，每个槽位max_value_size字节，写入时不再分配内存；
+ * 写满后覆盖最旧的样本。时间戳单调不减，按时间范围查询使用二分查找
+ */
+class ValueHistory {
+public:
+    ValueHistory(size_t capacity, size_t max_value_size = HISTORY_DEFAULT_MAX_VALUE_SIZE);
+
+    // 禁用拷贝构造和赋值
+    ValueHistory(const ValueHistory&) = delete;
+    ValueHistory& operator=(const ValueHistory&) = delete;
+
+    /**
+     * @brief 追加样本
+     * @param data 数据
+     * @param size 长度
+     * @param timestamp_us 时间戳（微秒），早于上一个样本时按上一个样本的时间戳记录
+     * @return true表示成功，false表示超过单值最大长度
+     */
+    bool append(const uint8_t* data, size_t size, gint64 timestamp_us);
+
+    /**
+     * @brief 按时间范围查询，从旧到新访问
+     * @param from_us 起始时间（含）
+     * @param to_us 结束时间（含）
+     * @param visitor 访问回调，数据指针只在回调期间有效
+     * @return 访问的样本数
+     */
+    size_t query(gint64 from_us, gint64 to_us, const HistoryVisitor& visitor) const;
+
+    /**
+     * @brief 访问最近的count个样本，从旧到新
+     * @param count 样本数
+     * @param visitor 访问回调，数据指针只在回调期间有效
+     * @return 访问的样本数
+     */
+    size_t visitLatest(size_t count, const HistoryVisitor& visitor) const;
+
+    /**
+     * @brief 清空历史记录（不释放内存）
+     */
+    void clear();
+
+    size_t getCapacity() const { return capacity_; }
+    size_t getMaxValueSize() const { return max_value_size_; }
+    size_t size() const { return count_; }
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    HistoryStatistics getStatistics() const;
+
+private:
+    struct Entry {
+        gint64 timestamp;
+        size_t size;
+    };
+
+    size_t capacity_;
+    size_t max_value_size_;
+    std::vector<uint8_t> storage_;
+    std::vector<Entry> entries_;
+    size_t head_;
+    size_t count_;
+    gint64 last_timestamp_;
+    HistoryStatistics stats_;
+
+    size_t physicalIndex(size_t logical_index) const;
+    void visit(size_t first, size_t last, const HistoryVisitor& visitor) const;
+};
+
+} // namespace Bluetooth
+
+#endif // VALUE_HISTORY_H
@@ -0,0 +1,135 @@
+#ifndef VALUE_SLOT_H
+#define VALUE_SLOT_H
+
+#include <gio/gio.h>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "byte_value.h"
+
+namespace Bluetooth {
+
+// 槽位默认容量，等于ATT属性值的最大长度
+constexpr size_t VALUE_SLOT_DEFAULT_CAPACITY = 512;
+
+/**
+ * @brief 单写者/多读者的无锁值槽（seqlock）
+ * 生产者线程调用publish()写入最新值，不加锁、不分配内存；
+ * 读者在写入过程中读取时会重试，保证读到完整的一帧。
+ * 同一时刻只允许一个线程调用publish()
+ */
+class ValueSlot {
+public:
+    explicit ValueSlot(size_t capacity = VALUE_SLOT_DEFAULT_CAPACITY);
+
+    // 禁用拷贝构造和赋值
+    ValueSlot(const ValueSlot&) = delete;
+    ValueSlot& operator=(const ValueSlot&) = delete;
+
+    /**
+     * @brief 发布新值（生产者线程调用）
+     * @param data 数据
+     * @param size 长度
+     * @return true表示成功，false表示超过槽位容量
+     */
+    bool publish(const uint8_t* data, size_t size);
+
+    /**
+     * @brief 发布新值（生产者线程调用）
+     * @param value 特征值数据
+     * @return true表示成功，false表示超过槽位容量
+     */
+    bool publish(const ByteValue& value) { return publish(value.data(), value.size()); }
+
+    /**
+     * @brief 读取最新值（任意线程）
+     * @param value 输出特征值数据
+     * @return 读到的值对应的序号，0表示尚未发布过
+     */
+    uint64_t read(ByteValue& value) const;
+
+    /**
+     * @brief 获取当前序号（每次发布加2，奇数表示写入中）
+     * @return 序号
+     */
+    uint64_t getSequence() const { return sequence_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 获取槽位容量
+     * @return 容量（字节）
+     */
+    size_t getCapacity() const { return capacity_; }
+
+    /**
+     * @brief 设置发布后唤醒的主循环上下文（由ValueSlotWatch设置）
+     * @param context 主循环上下文，nullptr表示不唤醒
+     */
+    void setWakeupContext(GMainContext* context);
+
+    /**
+     * @brief 清除待唤醒标记，之后的发布会再次唤醒主循环（由ValueSlotWatch调用）
+     */
+    void clearWakeup() { wakeup_pending_.store(false, std::memory_order_release); }
+
+private:
+    size_t capacity_;
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+    std::atomic<uint64_t> sequence_;
+    std::atomic<uint64_t> size_;
+    std::atomic<GMainContext*> wakeup_context_;
+    std::atomic<bool> wakeup_pending_;
+};
+
+/**
+ * @brief 在主循环中取出值槽的最新值
+ * 自定义GSource：生产者发布后通过g_main_context_wakeup唤醒主循环，
+ * 分发时只读取一次最新值，中间被覆盖的值自然合并
+ */
+class ValueSlotWatch {
+public:
+    using ValueCallback = std::function<void(const ByteValue& value)>;
+
+    /**
+     * @param slot 值槽
+     * @param callback 在主循环线程中调用的回调
+     * @param context 主循环上下文，nullptr表示默认上下文
+     */
+    ValueSlotWatch(std::shared_ptr<ValueSlot> slot, ValueCallback callback, GMainContext* context = nullptr);
+    ~ValueSlotWatch();
+
+    // 禁用拷贝构造和赋值
+    ValueSlotWatch(const ValueSlotWatch&) = delete;
+    ValueSlotWatch& operator=(const ValueSlotWatch&) = delete;
+
+    /**
+     * @brief 获取值槽
+     * @return 值槽
+     */
+    const std::shared_ptr<ValueSlot>& getSlot() const { return slot_; }
+
+private:
+    struct SlotSource {
+        GSource source;
+        ValueSlotWatch* watch;
+    };
+
+    std::shared_ptr<ValueSlot> slot_;
+    ValueCallback callback_;
+    GSource* source_;
+    uint64_t consumed_sequence_;
+    ByteValue buffer_;
+
+    bool hasNewValue() const;
+    void dispatch();
+
+    static gboolean onPrepare(GSource* source, gint* timeout);
+    static gboolean onCheck(GSource* source);
+    static gboolean onDispatch(GSource* source, GSourceFunc callback, gpointer user_data);
+    static GSourceFuncs source_funcs_;
+};
+
+} // namespace Bluetooth
+
+#endif // VALUE_SLOT_H
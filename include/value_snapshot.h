@@ -0,0 +1,98 @@
+#ifndef VALUE_SNAPSHOT_H
+#define VALUE_SNAPSHOT_H
+
+#include <gio/gio.h>
+#include <cstddef>
+#include <cstdint>
+#include "byte_value.h"
+
+namespace Bluetooth {
+
+/**
+ * @brief 不可变的特征值快照（基于GBytes引用计数）
+ * 拷贝只增加引用计数，ReadValue回复、Value属性和各订阅者的通知队列共享同一块内存；
+ * 写入方构造新快照后整体替换，已发出的快照不受影响
+ */
+class ValueSnapshot {
+public:
+    /**
+     * @brief 构造空引用（不是空值），用于表示"没有快照"
+     */
+    ValueSnapshot() : bytes_(nullptr) {}
+
+    /**
+     * @brief 复制数据构造快照
+     * @param value 特征值数据
+     */
+    ValueSnapshot(const ByteValue& value);
+
+    /**
+     * @brief 复制数据构造快照
+     * @param data 数据
+     * @param size 长度
+     */
+    ValueSnapshot(const uint8_t* data, size_t size);
+
+    ~ValueSnapshot();
+
+    ValueSnapshot(const ValueSnapshot& other);
+    ValueSnapshot(ValueSnapshot&& other) noexcept;
+    ValueSnapshot& operator=(const ValueSnapshot& other);
+    ValueSnapshot& operator=(ValueSnapshot&& other) noexcept;
+
+    /**
+     * @brief 接管GBytes的一个引用
+     * @param bytes GBytes实例
+     * @return 快照
+     */
+    static ValueSnapshot adopt(GBytes* bytes);
+
+    /**
+     * @brief 共享"ay"类型GVariant的数据，不复制
+     * @param variant 字节数组GVariant
+     * @return 快照
+     */
+    static ValueSnapshot fromVariant(GVariant* variant);
+
+    explicit operator bool() const { return bytes_ != nullptr; }
+
+    const uint8_t* data() const;
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief 获取底层GBytes（不增加引用）
+     * @return GBytes实例，空引用时为nullptr
+     */
+    GBytes* bytes() const { return bytes_; }
+
+    /**
+     * @brief 构建共享本快照内存的"ay" GVariant
+     * @return 浮动引用的GVariant
+     */
+    GVariant* toVariant() const;
+
+    /**
+     * @brief 截取一段，与本快照共享内存，不复制
+     * @param offset 起始偏移（不超过size()）
+     * @param length 长度（不超过size() - offset）
+     * @return 快照
+     */
+    ValueSnapshot slice(size_t offset, size_t length) const;
+
+    /**
+     * @brief 复制为可修改的字节序列
+     * @return 字节序列
+     */
+    ByteValue toByteValue() const { return ByteValue(data(), size()); }
+
+    void reset();
+    void swap(ValueSnapshot& other) noexcept;
+
+private:
+    GBytes* bytes_;
+};
+
+} // namespace Bluetooth
+
+#endif // VALUE_SNAPSHOT_H
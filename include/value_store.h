@@ -0,0 +1,119 @@
+#ifndef VALUE_STORE_H
+#define VALUE_STORE_H
+
+#include <gio/gio.h>
+#include <string>
+#include <map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "byte_value.h"
+
+namespace Bluetooth {
+
+// 持久化配置
+struct ValueStoreConfig {
+    guint commit_interval_ms = 50;                  // 组提交间隔，窗口内的写入共用一次fdatasync
+    size_t max_batch_bytes = 64 * 1024;             // 缓冲超过该大小时立即提交
+    size_t compaction_threshold_bytes = 1024 * 1024; // 日志超过该大小时压缩为快照
+};
+
+// 持久化统计
+struct ValueStoreStatistics {
+    uint64_t appended = 0;         // 追加的记录数
+    uint64_t commits = 0;          // 组提交次数（fdatasync次数）
+    uint64_t compactions = 0;      // 压缩次数
+    uint64_t recovered = 0;        // 启动时恢复的记录数
+    uint64_t discarded_bytes = 0;  // 恢复时丢弃的损坏或不完整的日志尾部
+};
+
+/**
+ * @brief 可写特征值的持久化存储（预写日志）
+ * 客户端写入被接受后追加到日志缓冲，按组提交批量write+fdatasync；
+ * 日志过大时把每个UUID的最新值写成快照并清空日志。
+ * 启动时用mmap读取快照和日志恢复各UUID的最新值，记录带CRC32校验，
+ * 日志尾部不完整的记录（崩溃时写到一半）会被截掉
+ *
+ * 文件：<directory>/values.snapshot 和 <directory>/values.log
+ */
+class ValueStore {
+public:
+    explicit ValueStore(const std::string& directory, const ValueStoreConfig& config = ValueStoreConfig());
+    ~ValueStore();
+
+    // 禁用拷贝构造和赋值
+    ValueStore(const ValueStore&) = delete;
+    ValueStore& operator=(const ValueStore&) = delete;
+
+    /**
+     * @brief 打开存储并恢复已持久化的值，应在注册GATT应用之前调用
+     * @return true表示成功，false表示失败
+     */
+    bool open();
+
+    /**
+     * @brief 关闭存储，提交缓冲中的记录
+     */
+    void close();
+
+    bool isOpen() const { return log_fd_ >= 0; }
+
+    /**
+     * @brief 查询已恢复或最近写入的值
+     * @param uuid 特征值UUID
+     * @param value 输出特征值数据
+     * @return true表示存在，false表示没有记录
+     */
+    bool lookup(const std::string& uuid, ByteValue& value) const;
+
+    /**
+     * @brief 追加一条记录（写入缓冲，组提交时落盘）
+     * @param uuid 特征值UUID
+     * @param data 数据
+     * @param size 长度
+     * @return true表示成功，false表示存储未打开
+     */
+    bool append(const std::string& uuid, const uint8_t* data, size_t size);
+
+    /**
+     * @brief 立即提交缓冲中的记录
+     * @return true表示成功，false表示写入或同步失败
+     */
+    bool commit();
+
+    /**
+     * @brief 先提交缓冲中的记录，再把最新值写成快照并清空日志
+     * @return true表示成功，false表示提交或写快照失败
+     */
+    bool compact();
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    const ValueStoreStatistics& getStatistics() const { return stats_; }
+
+private:
+    std::string directory_;
+    ValueStoreConfig config_;
+    int log_fd_;
+    size_t log_size_;
+    std::vector<uint8_t> pending_;
+    std::map<std::string, ByteValue> latest_;
+    guint commit_source_id_;
+    ValueStoreStatistics stats_;
+
+    std::string logPath() const;
+    std::string snapshotPath() const;
+    bool replayFile(const std::string& path, bool is_log, size_t& valid_size);
+    bool openLog(bool truncate);
+    bool writePending();
+    void scheduleCommit();
+    void cancelCommit();
+
+    static gboolean onCommit(gpointer user_data);
+};
+
+} // namespace Bluetooth
+
+#endif // VALUE_STORE_H
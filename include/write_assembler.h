@@ -0,0 +1,141 @@
+#ifndef WRITE_ASSEMBLER_H
+#define WRITE_ASSEMBLER_H
+
+#include <gio/gio.h>
+#include <map>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "byte_value.h"
+
+namespace Bluetooth {
+
+// ATT属性值的最大长度
+constexpr size_t ATT_MAX_VALUE_SIZE = 512;
+
+// 片段处理结果
+enum class WriteFragmentStatus {
+    ACCEPTED,        // 已写入缓冲（预备阶段）或已确认（执行阶段中已提交之后的片段）
+    COMPLETE,        // 执行阶段的首个片段：输出完整的值，由调用者校验后提交，校验结果作为该片段的回复
+    INVALID_OFFSET,  // 偏移超出已收到的数据（中间有空洞）或没有进行中的长写
+    INVALID_LENGTH,  // 组装后的长度超过上限
+    ABANDONED        // 长写持续时间超过上限，已丢弃
+};
+
+// 长写组装配置
+struct WriteAssemblyConfig {
+    guint abandon_ms = 30000;                     // 单次长写从首个片段起的最长时间，超过后丢弃而不提交
+    size_t max_value_size = ATT_MAX_VALUE_SIZE;   // 每个设备的组装缓冲上限
+};
+
+// 长写组装统计
+struct WriteAssemblyStatistics {
+    size_t active = 0;              // 进行中的长写
+    uint64_t fragments = 0;         // 接受的片段数
+    uint64_t committed = 0;         // 交给调用者校验提交的完整值
+    uint64_t rejected = 0;          // 偏移或长度无效被拒绝的片段
+    uint64_t abandoned = 0;         // 超时丢弃的长写
+};
+
+/**
+ * @brief 长写/可靠写的组装缓冲
+ * 特征值导出authorize标志后，BlueZ在客户端每次Prepare Write时以prepare-authorize调用WriteValue，
+ * 这里按设备把各段写入对应偏移（预备阶段），校验空洞和长度，出错时客户端的Prepare Write即失败。
+ * Execute Write时BlueZ把各段以带offset、类型为reliable的WriteValue依次交给应用并等待每一次回复：
+ * 执行阶段的首个片段返回COMPLETE和预备阶段组装好的完整值，调用者校验通过后提交、失败时回复错误，
+ * 客户端的Execute Write随之成功或失败；之后的片段只确认，直到覆盖完整的值。
+ * 没有预备阶段时（BlueZ未请求授权），偏移为0的执行片段本身即视为完整的值。
+ * 每个设备的缓冲不超过max_value_size；持续时间超过abandon_ms的长写由定时器丢弃，从不提交
+ */
+class WriteAssembler {
+public:
+    WriteAssembler();
+    ~WriteAssembler();
+
+    // 禁用拷贝构造和赋值
+    WriteAssembler(const WriteAssembler&) = delete;
+    WriteAssembler& operator=(const WriteAssembler&) = delete;
+
+    /**
+     * @brief 设置组装配置
+     * @param config 组装配置
+     */
+    void setConfig(const WriteAssemblyConfig& config);
+
+    /**
+     * @brief 获取组装配置
+     * @return 组装配置
+     */
+    const WriteAssemblyConfig& getConfig() const { return config_; }
+
+    /**
+     * @brief 预备阶段写入一个片段，offset为0时开始新的长写（丢弃该设备未执行的缓冲）
+     * @param device_path 设备对象路径
+     * @param offset 片段偏移
+     * @param data 数据
+     * @param size 长度
+     * @return 处理结果
+     */
+    WriteFragmentStatus addFragment(const std::string& device_path, uint16_t offset,
+                                    const uint8_t* data, size_t size);
+
+    /**
+     * @brief 执行阶段处理一个片段
+     * @param device_path 设备对象路径
+     * @param offset 片段偏移
+     * @param data 数据
+     * @param size 长度
+     * @param value 返回COMPLETE时输出完整的值
+     * @return COMPLETE表示调用者需校验并提交value，ACCEPTED表示只需确认，其余为错误
+     */
+    WriteFragmentStatus executeFragment(const std::string& device_path, uint16_t offset,
+                                        const uint8_t* data, size_t size, ByteValue& value);
+
+    /**
+     * @brief 丢弃设备进行中的长写（如调用者校验失败）
+     * @param device_path 设备对象路径
+     */
+    void discard(const std::string& device_path);
+
+    /**
+     * @brief 设备是否有进行中的长写
+     * @param device_path 设备对象路径
+     * @return true表示有
+     */
+    bool isAssembling(const std::string& device_path) const;
+
+    /**
+     * @brief 丢弃所有进行中的长写
+     */
+    void discardAll();
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    WriteAssemblyStatistics getStatistics() const;
+
+private:
+    struct Assembly {
+        ByteValue buffer;
+        gint64 started;
+        bool executing;       // 完整的值已交给调用者，剩余的执行片段只确认
+        size_t executed_size; // 执行阶段已确认覆盖的长度
+    };
+
+    WriteAssemblyConfig config_;
+    std::map<std::string, Assembly> assemblies_;
+    guint timer_id_;
+    WriteAssemblyStatistics stats_;
+
+    bool isExpired(const Assembly& assembly, gint64 now) const;
+    void abandon(std::map<std::string, Assembly>::iterator it);
+    void armTimer();
+    void handleTimeouts();
+
+    static gboolean onTimeout(gpointer user_data);
+};
+
+} // namespace Bluetooth
+
+#endif // WRITE_ASSEMBLER_H
@@ -1,54 +1,55 @@
 #include "advertisement_manager.h"
 #include "bluez_interface.h"
+#include "dbus_dispatch.h"
 #include <iostream>
 #include <map>
 #include <glib-2.0/glib.h>
 
 namespace Bluetooth {
 
-// D-Bus接口静态成员定义
-const GDBusMethodInfo AdvertisementManager::interface_methods[] = {
-    {
-        "Release",
-        nullptr,
-        nullptr,
-        nullptr
-    },
-    { nullptr, nullptr, nullptr, nullptr }
-};
-
-const GDBusPropertyInfo AdvertisementManager::interface_properties[] = {
-    { "Type", "s", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "ServiceUUIDs", "as", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "ManufacturerData", "a{qv}", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "SolicitUUIDs", "as", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "ServiceData", "a{sv}", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "IncludeTxPower", "b", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "LocalName", "s", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "Appearance", "q", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "Duration", "q", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "Timeout", "q", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "SecondaryChannel", "s", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { nullptr, nullptr, G_DBUS_PROPERTY_INFO_FLAGS_NONE }
-};
-
-const GDBusInterfaceInfo AdvertisementManager::interface_info_ = {
-    -1,
-    "org.bluez.LEAdvertisement1",
-    interface_methods,
-    nullptr,
-    interface_properties,
-    nullptr
-};
+// D-Bus接口定义，只声明会导出值的属性
+static const gchar* const ADVERTISEMENT_INTROSPECTION_XML =
+    "<node>"
+    "  <interface name='org.bluez.LEAdvertisement1'>"
+    "    <method name='Release'/>"
+    "    <property name='Type' type='s' access='read'/>"
+    "    <property name='ServiceUUIDs' type='as' access='read'/>"
+    "    <property name='ManufacturerData' type='a{qv}' access='read'/>"
+    "    <property name='ServiceData' type='a{sv}' access='read'/>"
+    "    <property name='LocalName' type='s' access='read'/>"
+    "  </interface>"
+    "</node>";
 
 const GDBusInterfaceVTable AdvertisementManager::interface_vtable_ = {
     methodRelease,
-    nullptr,
     onGetProperty,
-    nullptr,
     nullptr
 };
 
+GDBusInterfaceInfo* AdvertisementManager::interfaceInfo() {
+    // 内省数据只解析一次
+    static GDBusNodeInfo* node_info = g_dbus_node_info_new_for_xml(ADVERTISEMENT_INTROSPECTION_XML, nullptr);
+    return node_info ? node_info->interfaces[0] : nullptr;
+}
+
+// 属性名的分派表，编译期生成完美哈希；未列出的可选属性不导出值
+enum class AdvertisementProperty {
+    TYPE,
+    SERVICE_UUIDS,
+    MANUFACTURER_DATA,
+    SERVICE_DATA,
+    LOCAL_NAME
+};
+
+constexpr auto ADVERTISEMENT_PROPERTIES = makeNameTable<AdvertisementProperty>({
+    { "Type", AdvertisementProperty::TYPE },
+    { "ServiceUUIDs", AdvertisementProperty::SERVICE_UUIDS },
+    { "ManufacturerData", AdvertisementProperty::MANUFACTURER_DATA },
+    { "ServiceData", AdvertisementProperty::SERVICE_DATA },
+    { "LocalName", AdvertisementProperty::LOCAL_NAME }
+});
+static_assert(ADVERTISEMENT_PROPERTIES.isValid(), "No perfect hash seed for advertisement properties");
+
 AdvertisementManager::AdvertisementManager(const std::string& object_path, AdvertisementType type)
     : object_path_(object_path), type_(type), connection_(nullptr), registration_id_(0),
       discoverable_(true), connectable_(true), min_advertising_interval_(100), max_advertising_interval_(500) {
@@ -69,8 +70,8 @@ bool AdvertisementManager::exportInterface(GDBusConnection* connection) {
     registration_id_ = g_dbus_connection_register_object(
         connection,
         object_path_.c_str(),
-        const_cast<GDBusInterfaceInfo*>(&interface_info_),
-        const_cast<GDBusInterfaceVTable*>(&interface_vtable_),
+        interfaceInfo(),
+        &interface_vtable_,
         this,
         nullptr,
         &error
@@ -184,73 +185,80 @@ std::map<std::string, GVariant*> AdvertisementManager::getServiceDataVariant() c
     return data_map;
 }
 
-GVariant* AdvertisementManager::methodRelease(GDBusConnection* connection,
-                                             const gchar* sender,
-                                             const gchar* object_path,
-                                             const gchar* interface_name,
-                                             const gchar* method_name,
-                                             GVariant* parameters,
-                                             gpointer user_data,
-                                             GDBusMethodInvocation* invocation) {
+void AdvertisementManager::methodRelease(GDBusConnection* connection,
+                                         const gchar* sender,
+                                         const gchar* object_path,
+                                         const gchar* interface_name,
+                                         const gchar* method_name,
+                                         GVariant* parameters,
+                                         GDBusMethodInvocation* invocation,
+                                         gpointer user_data) {
     AdvertisementManager* ad = static_cast<AdvertisementManager*>(user_data);
     ad->handleRelease();
     g_dbus_method_invocation_return_value(invocation, nullptr);
-    return nullptr;
 }
 
-gboolean AdvertisementManager::onGetProperty(GDBusConnection* connection,
-                                            const gchar* sender,
-                                            const gchar* object_path,
-                                            const gchar* interface_name,
-                                            const gchar* property_name,
-                                            GVariant** value,
-                                            GError** error,
-                                            gpointer user_data) {
+GVariant* AdvertisementManager::onGetProperty(GDBusConnection* connection,
+                                              const gchar* sender,
+                                              const gchar* object_path,
+                                              const gchar* interface_name,
+                                              const gchar* property_name,
+                                              GError** error,
+                                              gpointer user_data) {
     AdvertisementManager* ad = static_cast<AdvertisementManager*>(user_data);
 
-    if (g_strcmp0(property_name, "Type") == 0) {
-        const char* type_str = (ad->type_ == AdvertisementType::PERIPHERAL) ? "peripheral" : "broadcast";
-        *value = g_variant_new_string(type_str);
-        return TRUE;
-    } else if (g_strcmp0(property_name, "ServiceUUIDs") == 0) {
-        GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("as"));
-        for (const auto& uuid : ad->service_uuids_) {
-            g_variant_builder_add(builder, "s", uuid.c_str());
+    AdvertisementProperty property;
+    if (!ADVERTISEMENT_PROPERTIES.find(property_name, property)) {
+        g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY, "Unknown property: %s", property_name);
+        return nullptr;
+    }
+
+    switch (property) {
+        case AdvertisementProperty::TYPE: {
+            const char* type_str = (ad->type_ == AdvertisementType::PERIPHERAL) ? "peripheral" : "broadcast";
+            return g_variant_new_string(type_str);
         }
-        *value = g_variant_new("as", builder);
-        g_variant_builder_unref(builder);
-        return TRUE;
-    } else if (g_strcmp0(property_name, "ManufacturerData") == 0) {
-        // 构建制造商数据字典
-        GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("a{qv}"));
-        for (const auto& pair : ad->manufacturer_data_) {
-            GVariant* data = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
-                                                      pair.second.data(),
-                                                      pair.second.size(),
-                                                      sizeof(uint8_t));
-            g_variant_builder_add(builder, "{qv}", g_variant_new_uint16(pair.first), data);
+        case AdvertisementProperty::SERVICE_UUIDS: {
+            GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("as"));
+            for (const auto& uuid : ad->service_uuids_) {
+                g_variant_builder_add(builder, "s", uuid.c_str());
+            }
+            GVariant* value = g_variant_new("as", builder);
+            g_variant_builder_unref(builder);
+            return value;
         }
-        *value = g_variant_new("a{qv}", builder);
-        g_variant_builder_unref(builder);
-        return TRUE;
-    } else if (g_strcmp0(property_name, "ServiceData") == 0) {
-        GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
-        for (const auto& pair : ad->service_data_) {
-            GVariant* data = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
-                                                      pair.second.data(),
-                                                      pair.second.size(),
-                                                      sizeof(uint8_t));
-            g_variant_builder_add(builder, "{sv}", pair.first.c_str(), data);
+        case AdvertisementProperty::MANUFACTURER_DATA: {
+            // 构建制造商数据字典
+            GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("a{qv}"));
+            for (const auto& pair : ad->manufacturer_data_) {
+                GVariant* data = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
+                                                          pair.second.data(),
+                                                          pair.second.size(),
+                                                          sizeof(uint8_t));
+                g_variant_builder_add(builder, "{qv}", pair.first, data);
+            }
+            GVariant* value = g_variant_new("a{qv}", builder);
+            g_variant_builder_unref(builder);
+            return value;
         }
-        *value = g_variant_new("a{sv}", builder);
-        g_variant_builder_unref(builder);
-        return TRUE;
-    } else if (g_strcmp0(property_name, "LocalName") == 0) {
-        *value = g_variant_new_string(ad->device_name_.c_str());
-        return TRUE;
+        case AdvertisementProperty::SERVICE_DATA: {
+            GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+            for (const auto& pair : ad->service_data_) {
+                GVariant* data = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
+                                                          pair.second.data(),
+                                                          pair.second.size(),
+                                                          sizeof(uint8_t));
+                g_variant_builder_add(builder, "{sv}", pair.first.c_str(), data);
+            }
+            GVariant* value = g_variant_new("a{sv}", builder);
+            g_variant_builder_unref(builder);
+            return value;
+        }
+        case AdvertisementProperty::LOCAL_NAME:
+            return g_variant_new_string(ad->device_name_.c_str());
     }
 
-    return FALSE;
+    return nullptr;
 }
 
 AdvertisementRegistrar::AdvertisementRegistrar() : error_callback_(nullptr) {
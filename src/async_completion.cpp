@@ -0,0 +1,119 @@
+#include "async_completion.h"
+#include <utility>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+const char* attErrorName(AttError error) {
+    switch (error) {
+        case AttError::IN_PROGRESS:
+            return "org.bluez.Error.InProgress";
+        case AttError::NOT_PERMITTED:
+            return "org.bluez.Error.NotPermitted";
+        case AttError::NOT_AUTHORIZED:
+            return "org.bluez.Error.NotAuthorized";
+        case AttError::NOT_SUPPORTED:
+            return "org.bluez.Error.NotSupported";
+        case AttError::INVALID_OFFSET:
+            return "org.bluez.Error.InvalidOffset";
+        case AttError::INVALID_VALUE_LENGTH:
+            return "org.bluez.Error.InvalidValueLength";
+        case AttError::FAILED:
+        default:
+            return "org.bluez.Error.Failed";
+    }
+}
+
+CompletionState::CompletionState(FinishFunction finish)
+    : done_(false), finish_(finish), timeout_id_(0) {
+}
+
+std::shared_ptr<CompletionState> CompletionState::create(FinishFunction finish, guint timeout_ms) {
+    std::shared_ptr<CompletionState> state(new CompletionState(finish));
+
+    // 超时源持有一个引用，应用丢弃所有句柄后仍能以超时结束请求
+    if (timeout_ms > 0) {
+        state->timeout_id_ = g_timeout_add_full(G_PRIORITY_DEFAULT, timeout_ms, onTimeout,
+            new std::shared_ptr<CompletionState>(state), onTimeoutDestroy);
+    }
+    return state;
+}
+
+bool CompletionState::complete(CompletionResult result) {
+    if (done_.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    // 在主循环线程中调用时直接处理，其他线程投递到主循环
+    Delivery* delivery = new Delivery{ shared_from_this(), std::move(result) };
+    g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, onDeliver, delivery, onDeliveryDestroy);
+    return true;
+}
+
+void CompletionState::finish(const CompletionResult& result) {
+    if (timeout_id_ != 0) {
+        g_source_remove(timeout_id_);
+        timeout_id_ = 0;
+    }
+
+    // 释放finish函数持有的请求和值
+    FinishFunction finish;
+    finish.swap(finish_);
+    if (finish) {
+        finish(result);
+    }
+}
+
+gboolean CompletionState::onTimeout(gpointer user_data) {
+    CompletionState* state = static_cast<std::shared_ptr<CompletionState>*>(user_data)->get();
+
+    // 源在返回G_SOURCE_REMOVE后自动销毁；已完成的结果正在投递途中，交给onDeliver处理
+    state->timeout_id_ = 0;
+    if (!state->done_.exchange(true, std::memory_order_acq_rel)) {
+        CompletionResult result;
+        result.timed_out = true;
+        state->finish(result);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+gboolean CompletionState::onDeliver(gpointer user_data) {
+    Delivery* delivery = static_cast<Delivery*>(user_data);
+    delivery->state->finish(delivery->result);
+    return G_SOURCE_REMOVE;
+}
+
+void CompletionState::onDeliveryDestroy(gpointer user_data) {
+    delete static_cast<Delivery*>(user_data);
+}
+
+void CompletionState::onTimeoutDestroy(gpointer user_data) {
+    delete static_cast<std::shared_ptr<CompletionState>*>(user_data);
+}
+
+bool ReadCompletion::complete(const ByteValue& value) {
+    CompletionResult result;
+    result.success = true;
+    result.value = value;
+    return state_->complete(std::move(result));
+}
+
+bool ReadCompletion::fail(AttError error) {
+    CompletionResult result;
+    result.error = error;
+    return state_->complete(std::move(result));
+}
+
+bool WriteCompletion::accept() {
+    CompletionResult result;
+    result.success = true;
+    return state_->complete(std::move(result));
+}
+
+bool WriteCompletion::reject(AttError error) {
+    CompletionResult result;
+    result.error = error;
+    return state_->complete(std::move(result));
+}
+
+} // namespace Bluetooth
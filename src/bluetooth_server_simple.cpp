@@ -7,6 +7,7 @@
 #include <unistd.h>
 #include <signal.h>
 #include <cstdint>
+#include "dbus_dispatch.h"
 
 // 蓝牙常量定义
 constexpr const char* BLUEZ_SERVICE = "org.bluez";
@@ -40,166 +41,317 @@ void signal_handler(int signal) {
     }
 }
 
-// D-Bus方法调用回调
-void on_method_call(GDBusConnection* conn,
-                   const gchar* sender,
-                   const gchar* object_path,
-                   const gchar* interface_name,
-                   const gchar* method_name,
-                   GVariant* parameters,
-                   GDBusMethodInvocation* invocation,
-                   gpointer user_data) {
+// 服务对象数据，注册时作为user_data传入
+struct ServiceObject {
+    const char* uuid;
+    const char* characteristic_path;
+};
+
+// 特征值对象数据，注册时作为user_data传入
+struct CharacteristicObject {
+    const char* uuid;
+    const char* const* flags;                              // 以nullptr结尾
+    GVariant* (*read_value)();                             // 返回ay类型的值
+    void (*write_value)(const uint8_t* data, gsize size);  // nullptr表示忽略写入
+};
+
+// 电池电量读取
+GVariant* read_battery_level() {
+    battery_level = (battery_level % 100) + 1;
+    std::cout << "Battery level read: " << (int)battery_level << "%" << std::endl;
+    return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, &battery_level, 1, sizeof(uint8_t));
+}
+
+// 计数器读取
+GVariant* read_counter() {
+    counter_value++;
+    std::cout << "Counter read: " << counter_value << std::endl;
+    return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, &counter_value, sizeof(counter_value), sizeof(uint8_t));
+}
+
+// 计数器写入
+void write_counter(const uint8_t* data, gsize size) {
+    if (size >= 4) {
+        counter_value = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
+        std::cout << "Counter written: " << counter_value << std::endl;
+    }
+}
+
+static const char* const battery_flags[] = { "read", "notify", nullptr };
+static const char* const counter_flags[] = { "read", "write", "notify", nullptr };
+
+static const ServiceObject battery_service = {
+    "0000180f-0000-1000-8000-00805f9b34fb", // Battery Service
+    "/org/bluez/example/gatt/service0/char0"
+};
+
+static const ServiceObject counter_service = {
+    "12345678-1234-1234-1234-123456789abc", // Custom Service
+    "/org/bluez/example/gatt/service1/char1"
+};
+
+static const CharacteristicObject battery_characteristic = {
+    "00002a19-0000-1000-8000-00805f9b34fb", // Battery Level
+    battery_flags,
+    read_battery_level,
+    nullptr
+};
+
+static const CharacteristicObject counter_characteristic = {
+    "12345678-1234-1234-1234-123456789abd", // Custom Characteristic
+    counter_flags,
+    read_counter,
+    write_counter
+};
+
+// 方法名和属性名的分派表，编译期生成完美哈希；接口由各自的vtable区分，
+// GDBus已按接口描述拒绝未声明的方法
+enum class MethodId {
+    GET_SERVICES,
+    READ_VALUE,
+    WRITE_VALUE,
+    START_NOTIFY,
+    STOP_NOTIFY,
+    RELEASE
+};
+
+enum class PropertyId {
+    UUID,
+    PRIMARY,
+    CHARACTERISTICS,
+    FLAGS,
+    NOTIFYING,
+    TYPE,
+    SERVICE_UUIDS,
+    LOCAL_NAME
+};
+
+constexpr auto method_table = Bluetooth::makeNameTable<MethodId>({
+    { "GetServices", MethodId::GET_SERVICES },
+    { "ReadValue", MethodId::READ_VALUE },
+    { "WriteValue", MethodId::WRITE_VALUE },
+    { "StartNotify", MethodId::START_NOTIFY },
+    { "StopNotify", MethodId::STOP_NOTIFY },
+    { "Release", MethodId::RELEASE }
+});
+static_assert(method_table.isValid(), "No perfect hash seed for method names");
+
+constexpr auto property_table = Bluetooth::makeNameTable<PropertyId>({
+    { "UUID", PropertyId::UUID },
+    { "Primary", PropertyId::PRIMARY },
+    { "Characteristics", PropertyId::CHARACTERISTICS },
+    { "Flags", PropertyId::FLAGS },
+    { "Notifying", PropertyId::NOTIFYING },
+    { "Type", PropertyId::TYPE },
+    { "ServiceUUIDs", PropertyId::SERVICE_UUIDS },
+    { "LocalName", PropertyId::LOCAL_NAME }
+});
+static_assert(property_table.isValid(), "No perfect hash seed for property names");
+
+// 未知方法
+void return_unknown_method(GDBusMethodInvocation* invocation) {
+    g_dbus_method_invocation_return_error(invocation,
+        G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD, "Unknown method");
+}
+
+// GattApplication1方法调用回调
+void on_application_method_call(GDBusConnection* conn,
+                                const gchar* sender,
+                                const gchar* object_path,
+                                const gchar* interface_name,
+                                const gchar* method_name,
+                                GVariant* parameters,
+                                GDBusMethodInvocation* invocation,
+                                gpointer user_data) {
 
     std::cout << "Method call: " << method_name << " on " << object_path << std::endl;
 
-    if (g_strcmp0(interface_name, GATT_APPLICATION_IFACE) == 0) {
-        if (g_strcmp0(method_name, "GetServices") == 0) {
-            // 返回服务列表
-            const char* services[] = {
-                "/org/bluez/example/gatt/service0",
-                "/org/bluez/example/gatt/service1",
-                nullptr
-            };
-            GVariant* result = g_variant_new_strv(services, -1);
-            g_dbus_method_invocation_return_value(invocation, result);
-            return;
+    MethodId method;
+    if (!method_table.find(method_name, method) || method != MethodId::GET_SERVICES) {
+        return_unknown_method(invocation);
+        return;
+    }
+
+    // 返回服务列表
+    const char* services[] = {
+        "/org/bluez/example/gatt/service0",
+        "/org/bluez/example/gatt/service1",
+        nullptr
+    };
+    GVariant* result = g_variant_new_objv(services, -1);
+    g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&result, 1));
+}
+
+// GattCharacteristic1方法调用回调
+void on_characteristic_method_call(GDBusConnection* conn,
+                                   const gchar* sender,
+                                   const gchar* object_path,
+                                   const gchar* interface_name,
+                                   const gchar* method_name,
+                                   GVariant* parameters,
+                                   GDBusMethodInvocation* invocation,
+                                   gpointer user_data) {
+    const CharacteristicObject* characteristic = static_cast<const CharacteristicObject*>(user_data);
+
+    std::cout << "Method call: " << method_name << " on " << object_path << std::endl;
+
+    MethodId method;
+    if (!method_table.find(method_name, method)) {
+        return_unknown_method(invocation);
+        return;
+    }
+
+    switch (method) {
+        case MethodId::READ_VALUE: {
+            GVariant* value = characteristic->read_value();
+            g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&value, 1));
+            break;
         }
-    } else if (g_strcmp0(interface_name, GATT_CHARACTERISTIC_IFACE) == 0) {
-        if (g_strcmp0(method_name, "ReadValue") == 0) {
-            // 读取特征值
-            if (g_str_has_suffix(object_path, "char0")) {
-                // 电池电量特征值
-                battery_level = (battery_level % 100) + 1;
-                std::cout << "Battery level read: " << (int)battery_level << "%" << std::endl;
-                GVariant* value = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, &battery_level, 1, sizeof(uint8_t));
-                g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&value, 1));
-                return;
-            } else if (g_str_has_suffix(object_path, "char1")) {
-                // 计数器特征值
-                counter_value++;
-                std::cout << "Counter read: " << counter_value << std::endl;
-                GVariant* value = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, &counter_value, 4, sizeof(uint32_t));
-                g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&value, 1));
-                return;
-            }
-        } else if (g_strcmp0(method_name, "WriteValue") == 0) {
-            // 写入特征值
+        case MethodId::WRITE_VALUE: {
             GVariant* value = g_variant_get_child_value(parameters, 0);
             gsize n_elements;
             const uint8_t* data = (const uint8_t*)g_variant_get_fixed_array(value, &n_elements, sizeof(uint8_t));
 
-            if (g_str_has_suffix(object_path, "char1") && n_elements >= 4) {
-                counter_value = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
-                std::cout << "Counter written: " << counter_value << std::endl;
+            if (characteristic->write_value) {
+                characteristic->write_value(data, n_elements);
             }
 
             g_variant_unref(value);
             g_dbus_method_invocation_return_value(invocation, nullptr);
-            return;
-        } else if (g_strcmp0(method_name, "StartNotify") == 0) {
+            break;
+        }
+        case MethodId::START_NOTIFY:
             notifying = true;
             std::cout << "Notification started" << std::endl;
             g_dbus_method_invocation_return_value(invocation, nullptr);
-            return;
-        } else if (g_strcmp0(method_name, "StopNotify") == 0) {
+            break;
+        case MethodId::STOP_NOTIFY:
             notifying = false;
             std::cout << "Notification stopped" << std::endl;
             g_dbus_method_invocation_return_value(invocation, nullptr);
-            return;
-        }
-    } else if (g_strcmp0(interface_name, ADVERTISEMENT_IFACE) == 0) {
-        if (g_strcmp0(method_name, "Release") == 0) {
-            std::cout << "Advertisement released" << std::endl;
-            g_dbus_method_invocation_return_value(invocation, nullptr);
-            return;
-        }
+            break;
+        default:
+            return_unknown_method(invocation);
+            break;
     }
+}
 
-    // 未知方法
-    g_dbus_method_invocation_return_error(invocation,
-        G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD, "Unknown method");
+// LEAdvertisement1方法调用回调
+void on_advertisement_method_call(GDBusConnection* conn,
+                                  const gchar* sender,
+                                  const gchar* object_path,
+                                  const gchar* interface_name,
+                                  const gchar* method_name,
+                                  GVariant* parameters,
+                                  GDBusMethodInvocation* invocation,
+                                  gpointer user_data) {
+
+    std::cout << "Method call: " << method_name << " on " << object_path << std::endl;
+
+    MethodId method;
+    if (!method_table.find(method_name, method) || method != MethodId::RELEASE) {
+        return_unknown_method(invocation);
+        return;
+    }
+
+    std::cout << "Advertisement released" << std::endl;
+    g_dbus_method_invocation_return_value(invocation, nullptr);
 }
 
-// D-Bus属性获取回调
-gboolean on_get_property(GDBusConnection* conn,
-                        const gchar* sender,
-                        const gchar* object_path,
-                        const gchar* interface_name,
-                        const gchar* property_name,
-                        GVariant** value,
-                        GError** error,
-                        gpointer user_data) {
+// 未知属性统一返回UnknownProperty错误
+GVariant* unknown_property(const gchar* property_name, GError** error) {
+    g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY, "Unknown property: %s", property_name);
+    return nullptr;
+}
 
-    if (g_strcmp0(interface_name, GATT_SERVICE_IFACE) == 0) {
-        if (g_strcmp0(property_name, "UUID") == 0) {
-            if (g_str_has_suffix(object_path, "service0")) {
-                *value = g_variant_new_string("0000180f-0000-1000-8000-00805f9b34fb"); // Battery Service
-            } else if (g_str_has_suffix(object_path, "service1")) {
-                *value = g_variant_new_string("12345678-1234-1234-1234-123456789abc"); // Custom Service
-            }
-            return TRUE;
-        } else if (g_strcmp0(property_name, "Primary") == 0) {
-            *value = g_variant_new_boolean(TRUE);
-            return TRUE;
-        } else if (g_strcmp0(property_name, "Characteristics") == 0) {
-            const char* characteristics[] = { nullptr };
-            if (g_str_has_suffix(object_path, "service0")) {
-                characteristics[0] = "/org/bluez/example/gatt/service0/char0";
-            } else if (g_str_has_suffix(object_path, "service1")) {
-                characteristics[0] = "/org/bluez/example/gatt/service1/char1";
-            }
-            *value = g_variant_new_strv(characteristics, 1);
-            return TRUE;
-        }
-    } else if (g_strcmp0(interface_name, GATT_CHARACTERISTIC_IFACE) == 0) {
-        if (g_strcmp0(property_name, "UUID") == 0) {
-            if (g_str_has_suffix(object_path, "char0")) {
-                *value = g_variant_new_string("00002a19-0000-1000-8000-00805f9b34fb"); // Battery Level
-            } else if (g_str_has_suffix(object_path, "char1")) {
-                *value = g_variant_new_string("12345678-1234-1234-1234-123456789abd"); // Custom Characteristic
-            }
-            return TRUE;
-        } else if (g_strcmp0(property_name, "Flags") == 0) {
-            const char* flags[] = { "read", "notify", nullptr };
-            if (g_str_has_suffix(object_path, "char1")) {
-                flags[1] = "write";
-                flags[2] = "notify";
-                flags[3] = nullptr;
-            }
-            *value = g_variant_new_strv(flags, -1);
-            return TRUE;
-        } else if (g_strcmp0(property_name, "Notifying") == 0) {
-            *value = g_variant_new_boolean(notifying);
-            return TRUE;
+// GattService1属性获取回调
+GVariant* on_service_get_property(GDBusConnection* conn,
+                                  const gchar* sender,
+                                  const gchar* object_path,
+                                  const gchar* interface_name,
+                                  const gchar* property_name,
+                                  GError** error,
+                                  gpointer user_data) {
+    const ServiceObject* service = static_cast<const ServiceObject*>(user_data);
+
+    PropertyId property;
+    if (!property_table.find(property_name, property)) {
+        return unknown_property(property_name, error);
+    }
+
+    switch (property) {
+        case PropertyId::UUID:
+            return g_variant_new_string(service->uuid);
+        case PropertyId::PRIMARY:
+            return g_variant_new_boolean(TRUE);
+        case PropertyId::CHARACTERISTICS: {
+            const char* characteristics[] = { service->characteristic_path, nullptr };
+            return g_variant_new_objv(characteristics, -1);
         }
-    } else if (g_strcmp0(interface_name, ADVERTISEMENT_IFACE) == 0) {
-        if (g_strcmp0(property_name, "Type") == 0) {
-            *value = g_variant_new_string("peripheral");
-            return TRUE;
-        } else if (g_strcmp0(property_name, "ServiceUUIDs") == 0) {
+        default:
+            return unknown_property(property_name, error);
+    }
+}
+
+// GattCharacteristic1属性获取回调
+GVariant* on_characteristic_get_property(GDBusConnection* conn,
+                                         const gchar* sender,
+                                         const gchar* object_path,
+                                         const gchar* interface_name,
+                                         const gchar* property_name,
+                                         GError** error,
+                                         gpointer user_data) {
+    const CharacteristicObject* characteristic = static_cast<const CharacteristicObject*>(user_data);
+
+    PropertyId property;
+    if (!property_table.find(property_name, property)) {
+        return unknown_property(property_name, error);
+    }
+
+    switch (property) {
+        case PropertyId::UUID:
+            return g_variant_new_string(characteristic->uuid);
+        case PropertyId::FLAGS:
+            return g_variant_new_strv(characteristic->flags, -1);
+        case PropertyId::NOTIFYING:
+            return g_variant_new_boolean(notifying);
+        default:
+            return unknown_property(property_name, error);
+    }
+}
+
+// LEAdvertisement1属性获取回调
+GVariant* on_advertisement_get_property(GDBusConnection* conn,
+                                        const gchar* sender,
+                                        const gchar* object_path,
+                                        const gchar* interface_name,
+                                        const gchar* property_name,
+                                        GError** error,
+                                        gpointer user_data) {
+
+    PropertyId property;
+    if (!property_table.find(property_name, property)) {
+        return unknown_property(property_name, error);
+    }
+
+    switch (property) {
+        case PropertyId::TYPE:
+            return g_variant_new_string("peripheral");
+        case PropertyId::SERVICE_UUIDS: {
             const char* uuids[] = {
-                "0000180f-0000-1000-8000-00805f9b34fb",
-                "12345678-1234-1234-1234-123456789abc",
+                battery_service.uuid,
+                counter_service.uuid,
                 nullptr
             };
-            *value = g_variant_new_strv(uuids, -1);
-            return TRUE;
-        } else if (g_strcmp0(property_name, "LocalName") == 0) {
-            *value = g_variant_new_string("BLE GATT Server Demo");
-            return TRUE;
+            return g_variant_new_strv(uuids, -1);
         }
+        case PropertyId::LOCAL_NAME:
+            return g_variant_new_string("BLE GATT Server Demo");
+        default:
+            return unknown_property(property_name, error);
     }
-
-    return FALSE;
 }
 
-// D-Bus接口vtable
-const GDBusInterfaceVTable app_vtable = {
-    on_method_call,
-    nullptr,
-    nullptr,
-};
-
 // D-Bus属性设置回调
 gboolean on_set_property(GDBusConnection* conn,
                         const gchar* sender,
@@ -213,6 +365,31 @@ gboolean on_set_property(GDBusConnection* conn,
     return FALSE;
 }
 
+// 各接口的vtable，处理函数通过user_data取得对象数据
+const GDBusInterfaceVTable application_vtable = {
+    on_application_method_call,
+    nullptr,
+    nullptr,
+};
+
+const GDBusInterfaceVTable service_vtable = {
+    nullptr,
+    on_service_get_property,
+    on_set_property,
+};
+
+const GDBusInterfaceVTable characteristic_vtable = {
+    on_characteristic_method_call,
+    on_characteristic_get_property,
+    on_set_property,
+};
+
+const GDBusInterfaceVTable advertisement_vtable = {
+    on_advertisement_method_call,
+    on_advertisement_get_property,
+    on_set_property,
+};
+
 // 初始化D-Bus接口
 gboolean register_interfaces() {
     GError* error = nullptr;
@@ -268,14 +445,6 @@ gboolean register_interfaces() {
         "  </interface>"
         "</node>";
 
-    // 创建完整的vtable
-    GDBusInterfaceVTable vtable = {
-        on_method_call,
-        nullptr,
-        on_get_property,
-        on_set_property,
-    };
-
     // 注册应用接口
     GDBusNodeInfo* app_info = g_dbus_node_info_new_for_xml(app_xml, &error);
     if (!app_info) {
@@ -285,7 +454,7 @@ gboolean register_interfaces() {
     }
 
     reg_id = g_dbus_connection_register_object(connection, APP_PATH,
-        app_info->interfaces[0], &vtable, nullptr, nullptr, &error);
+        app_info->interfaces[0], &application_vtable, nullptr, nullptr, &error);
 
     if (reg_id == 0) {
         std::cerr << "Failed to register application interface: " << error->message << std::endl;
@@ -297,21 +466,21 @@ gboolean register_interfaces() {
     // 注册服务接口
     GDBusNodeInfo* service_info = g_dbus_node_info_new_for_xml(service_xml, nullptr);
     g_dbus_connection_register_object(connection, "/org/bluez/example/gatt/service0",
-        service_info->interfaces[0], &vtable, nullptr, nullptr, nullptr);
+        service_info->interfaces[0], &service_vtable, (gpointer)&battery_service, nullptr, nullptr);
     g_dbus_connection_register_object(connection, "/org/bluez/example/gatt/service1",
-        service_info->interfaces[0], &vtable, nullptr, nullptr, nullptr);
+        service_info->interfaces[0], &service_vtable, (gpointer)&counter_service, nullptr, nullptr);
 
     // 注册特征值接口
     GDBusNodeInfo* char_info = g_dbus_node_info_new_for_xml(char_xml, nullptr);
     g_dbus_connection_register_object(connection, "/org/bluez/example/gatt/service0/char0",
-        char_info->interfaces[0], &vtable, nullptr, nullptr, nullptr);
+        char_info->interfaces[0], &characteristic_vtable, (gpointer)&battery_characteristic, nullptr, nullptr);
     g_dbus_connection_register_object(connection, "/org/bluez/example/gatt/service1/char1",
-        char_info->interfaces[0], &vtable, nullptr, nullptr, nullptr);
+        char_info->interfaces[0], &characteristic_vtable, (gpointer)&counter_characteristic, nullptr, nullptr);
 
     // 注册广告接口
     GDBusNodeInfo* ad_info = g_dbus_node_info_new_for_xml(ad_xml, nullptr);
     g_dbus_connection_register_object(connection, ADVERTISEMENT_PATH,
-        ad_info->interfaces[0], &vtable, nullptr, nullptr, nullptr);
+        ad_info->interfaces[0], &advertisement_vtable, nullptr, nullptr, nullptr);
 
     // 清理
     g_dbus_node_info_unref(app_info);
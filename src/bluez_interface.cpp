@@ -7,10 +7,14 @@
 namespace Bluetooth {
 
 BluezInterface::BluezInterface()
-    : connection_(nullptr), object_manager_(nullptr), adapter_proxy_(nullptr), initialized_(false) {
+    : connection_(nullptr), object_manager_(nullptr), adapter_proxy_(nullptr), initialized_(false),
+      dispatch_thread_(nullptr), dispatch_loop_(nullptr),
+      dispatch_handoff_(new ContextHandoff(g_main_context_default())) {
 }
 
 BluezInterface::~BluezInterface() {
+    stopDispatchThread();
+
     if (adapter_proxy_) {
         g_object_unref(adapter_proxy_);
     }
@@ -88,8 +92,7 @@ bool BluezInterface::findAdapter() {
 
         // 查找hci0适配器
         if (g_str_has_suffix(object_path, "hci0")) {
-            adapter_proxy_ = G_DBUS_OBJECT_PROXY(g_dbus_object_proxy_new(
-                connection_, BLUEZ_SERVICE, object_path));
+            adapter_proxy_ = G_DBUS_OBJECT_PROXY(g_dbus_object_proxy_new(connection_, object_path));
             found = true;
             std::cout << "Found Bluetooth adapter: " << object_path << std::endl;
             break;
@@ -107,12 +110,12 @@ bool BluezInterface::isBluezAvailable() const {
 
     GError* error = nullptr;
     GDBusMessage* message = g_dbus_message_new_method_call(
-        BLUEZ_SERVICE,
-        "/",
         "org.freedesktop.DBus",
-        "NameHasOwner",
-        g_variant_new("(s)", BLUEZ_SERVICE)
+        "/org/freedesktop/DBus",
+        "org.freedesktop.DBus",
+        "NameHasOwner"
     );
+    g_dbus_message_set_body(message, g_variant_new("(s)", BLUEZ_SERVICE));
 
     GDBusMessage* reply = g_dbus_connection_send_message_with_reply_sync(
         connection_, message, G_DBUS_SEND_MESSAGE_FLAGS_NONE, -1, nullptr, nullptr, &error);
@@ -246,6 +249,45 @@ bool BluezInterface::unregisterApplication(ErrorCallback callback) {
     return true;
 }
 
+bool BluezInterface::startDispatchThread() {
+    if (dispatch_thread_) {
+        return false;
+    }
+
+    // 导出对象在注册时绑定调用线程的默认上下文（即全局默认上下文），方法调用在迭代它的线程中分发；
+    // 特征值内部的定时器和fd监视同样附加在默认上下文，因此整个GATT对象层都在分发线程中运行
+    dispatch_loop_ = g_main_loop_new(g_main_context_default(), FALSE);
+    dispatch_thread_ = g_thread_new("dbus-dispatch", dispatchThreadMain, this);
+
+    std::cout << "D-Bus dispatch thread started" << std::endl;
+    return true;
+}
+
+void BluezInterface::stopDispatchThread() {
+    if (!dispatch_thread_) {
+        return;
+    }
+
+    // 在分发线程中退出：线程尚未进入g_main_loop_run时直接quit会被run覆盖
+    GMainLoop* loop = dispatch_loop_;
+    dispatch_handoff_->post([loop]() {
+        g_main_loop_quit(loop);
+    });
+    g_thread_join(dispatch_thread_);
+    dispatch_thread_ = nullptr;
+
+    g_main_loop_unref(dispatch_loop_);
+    dispatch_loop_ = nullptr;
+
+    std::cout << "D-Bus dispatch thread stopped" << std::endl;
+}
+
+gpointer BluezInterface::dispatchThreadMain(gpointer user_data) {
+    BluezInterface* self = static_cast<BluezInterface*>(user_data);
+    g_main_loop_run(self->dispatch_loop_);
+    return nullptr;
+}
+
 void BluezInterface::onInterfaceAddedStatic(GDBusObjectManager* manager,
                                            GDBusObject* object,
                                            GDBusInterface* interface,
@@ -0,0 +1,133 @@
+#include "byte_value.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Bluetooth {
+
+ByteValue::ByteValue(const uint8_t* data, size_t size)
+    : size_(0), capacity_(INLINE_CAPACITY) {
+    assign(data, size);
+}
+
+ByteValue::ByteValue(size_t size, uint8_t fill)
+    : size_(0), capacity_(INLINE_CAPACITY) {
+    resize(size, fill);
+}
+
+ByteValue::ByteValue(const std::vector<uint8_t>& bytes)
+    : size_(0), capacity_(INLINE_CAPACITY) {
+    assign(bytes.data(), bytes.size());
+}
+
+ByteValue::ByteValue(std::initializer_list<uint8_t> bytes)
+    : size_(0), capacity_(INLINE_CAPACITY) {
+    assign(bytes.begin(), bytes.size());
+}
+
+ByteValue::~ByteValue() {
+    release();
+}
+
+ByteValue::ByteValue(const ByteValue& other)
+    : size_(0), capacity_(INLINE_CAPACITY) {
+    assign(other.data(), other.size_);
+}
+
+ByteValue::ByteValue(ByteValue&& other) noexcept
+    : size_(0), capacity_(INLINE_CAPACITY) {
+    swap(other);
+}
+
+ByteValue& ByteValue::operator=(const ByteValue& other) {
+    if (this != &other) {
+        assign(other.data(), other.size_);
+    }
+    return *this;
+}
+
+ByteValue& ByteValue::operator=(ByteValue&& other) noexcept {
+    if (this != &other) {
+        // 交换后由other释放原有的堆内存
+        swap(other);
+        other.clear();
+    }
+    return *this;
+}
+
+void ByteValue::assign(const uint8_t* data, size_t size) {
+    if (size > capacity_) {
+        size_ = 0;
+        grow(size);
+    }
+
+    if (size > 0) {
+        std::memmove(this->data(), data, size);
+    }
+    size_ = size;
+}
+
+void ByteValue::append(const uint8_t* data, size_t size) {
+    if (size_ + size > capacity_) {
+        // 追加的数据可能来自自身，扩容前先记下偏移
+        const uint8_t* begin = this->data();
+        bool self = data >= begin && data < begin + size_;
+        size_t offset = self ? static_cast<size_t>(data - begin) : 0;
+
+        grow(std::max(size_ + size, capacity_ * 2));
+        if (self) {
+            data = this->data() + offset;
+        }
+    }
+
+    if (size > 0) {
+        std::memmove(this->data() + size_, data, size);
+    }
+    size_ += size;
+}
+
+void ByteValue::resize(size_t size, uint8_t fill) {
+    if (size > capacity_) {
+        grow(size);
+    }
+
+    if (size > size_) {
+        std::memset(data() + size_, fill, size - size_);
+    }
+    size_ = size;
+}
+
+void ByteValue::reserve(size_t capacity) {
+    if (capacity > capacity_) {
+        grow(capacity);
+    }
+}
+
+void ByteValue::swap(ByteValue& other) noexcept {
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(storage_, other.storage_);
+}
+
+bool ByteValue::operator==(const ByteValue& other) const {
+    return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+}
+
+void ByteValue::grow(size_t capacity) {
+    uint8_t* heap = new uint8_t[capacity];
+    if (size_ > 0) {
+        std::memcpy(heap, data(), size_);
+    }
+
+    release();
+    storage_.heap = heap;
+    capacity_ = capacity;
+}
+
+void ByteValue::release() {
+    if (!isInline()) {
+        delete[] storage_.heap;
+        capacity_ = INLINE_CAPACITY;
+    }
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,143 @@
+#include "callback_executor.h"
+#include <iostream>
+#include <algorithm>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+CallbackExecutor::CallbackExecutor(const ExecutorConfig& config, GMainContext* context)
+    : config_(config), pool_(nullptr),
+      context_(g_main_context_ref(context ? context : g_main_context_default())),
+      queued_(0), running_(0), peak_queued_(0), completed_(0), rejected_(0), total_wait_us_(0) {
+    config_.max_threads = std::max<size_t>(config_.max_threads, 1);
+
+    // 非独占线程池：空闲线程由GLib在各线程池之间共享
+    GError* error = nullptr;
+    pool_ = g_thread_pool_new(onWork, this, static_cast<gint>(config_.max_threads), FALSE, &error);
+    if (!pool_) {
+        std::cerr << "Failed to create callback thread pool: " << error->message << std::endl;
+        g_error_free(error);
+    }
+}
+
+CallbackExecutor::CallbackExecutor(GMainContext* work_context, const ExecutorConfig& config, GMainContext* context)
+    : config_(config), pool_(nullptr),
+      context_(g_main_context_ref(context ? context : g_main_context_default())),
+      work_handoff_(new ContextHandoff(work_context)), completion_handoff_(new ContextHandoff(context_)),
+      queued_(0), running_(0), peak_queued_(0), completed_(0), rejected_(0), total_wait_us_(0) {
+    config_.max_threads = 1;
+}
+
+CallbackExecutor::~CallbackExecutor() {
+    // 等待排队和执行中的任务结束；已投递到主循环的完成处理不再引用执行器
+    if (pool_) {
+        g_thread_pool_free(pool_, FALSE, TRUE);
+        pool_ = nullptr;
+    }
+
+    // 应用上下文模式下尚未执行的任务和完成处理被丢弃
+    work_handoff_.reset();
+    completion_handoff_.reset();
+    g_main_context_unref(context_);
+}
+
+bool CallbackExecutor::submit(Task work, Task completion) {
+    // 只在主循环线程中提交，工作线程只会减少排队数，检查后再增加不会超过上限
+    if ((!pool_ && !work_handoff_) || queued_.load(std::memory_order_acquire) >= config_.max_queue_depth) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t depth = queued_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (depth > peak_queued_.load(std::memory_order_relaxed)) {
+        peak_queued_.store(depth, std::memory_order_relaxed);
+    }
+
+    if (work_handoff_) {
+        // 任务在应用线程中执行，完成处理经另一个队列回到主循环线程
+        work_handoff_->post([this, job = Job{ std::move(work), std::move(completion), g_get_monotonic_time() }]() mutable {
+            runJob(job);
+            if (job.completion) {
+                completion_handoff_->post(std::move(job.completion));
+            }
+        });
+        return true;
+    }
+
+    Job* job = new Job{ std::move(work), std::move(completion), g_get_monotonic_time() };
+
+    GError* error = nullptr;
+    if (!g_thread_pool_push(pool_, job, &error)) {
+        std::cerr << "Failed to submit callback task: " << error->message << std::endl;
+        g_error_free(error);
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        delete job;
+        return false;
+    }
+
+    return true;
+}
+
+void CallbackExecutor::setConfig(const ExecutorConfig& config) {
+    config_ = config;
+    config_.max_threads = work_handoff_ ? 1 : std::max<size_t>(config_.max_threads, 1);
+
+    if (pool_) {
+        g_thread_pool_set_max_threads(pool_, static_cast<gint>(config_.max_threads), nullptr);
+    }
+}
+
+ExecutorStatistics CallbackExecutor::getStatistics() const {
+    ExecutorStatistics stats;
+    stats.queued = queued_.load(std::memory_order_relaxed);
+    stats.running = running_.load(std::memory_order_relaxed);
+    stats.peak_queued = peak_queued_.load(std::memory_order_relaxed);
+    stats.completed = completed_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+
+    uint64_t started = stats.completed + stats.running;
+    if (started > 0) {
+        stats.average_wait_ms = total_wait_us_.load(std::memory_order_relaxed) / 1000.0 / started;
+    }
+    return stats;
+}
+
+void CallbackExecutor::runJob(Job& job) {
+    queued_.fetch_sub(1, std::memory_order_acq_rel);
+    running_.fetch_add(1, std::memory_order_relaxed);
+    total_wait_us_.fetch_add(static_cast<uint64_t>(g_get_monotonic_time() - job.queued_at),
+                             std::memory_order_relaxed);
+
+    job.work();
+
+    running_.fetch_sub(1, std::memory_order_relaxed);
+    completed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CallbackExecutor::onWork(gpointer data, gpointer user_data) {
+    Job* job = static_cast<Job*>(data);
+    CallbackExecutor* executor = static_cast<CallbackExecutor*>(user_data);
+
+    executor->runJob(*job);
+
+    if (!job->completion) {
+        delete job;
+        return;
+    }
+
+    // 工作线程不持有主循环上下文，完成处理作为空闲源在主循环线程中执行
+    g_main_context_invoke_full(executor->context_, G_PRIORITY_DEFAULT, onComplete, job, onJobDestroy);
+}
+
+gboolean CallbackExecutor::onComplete(gpointer user_data) {
+    Job* job = static_cast<Job*>(user_data);
+    job->completion();
+    return G_SOURCE_REMOVE;
+}
+
+void CallbackExecutor::onJobDestroy(gpointer user_data) {
+    delete static_cast<Job*>(user_data);
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,137 @@
+#include "context_handoff.h"
+#include <utility>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+GSourceFuncs ContextHandoff::source_funcs_ = {
+    onPrepare,
+    onCheck,
+    onDispatch,
+    nullptr,
+    nullptr,
+    nullptr
+};
+
+ContextHandoff::ContextHandoff(GMainContext* context)
+    : context_(g_main_context_ref(context ? context : g_main_context_default())),
+      source_(nullptr), head_(&stub_), tail_(&stub_), pending_(0), wakeup_pending_(false) {
+    stub_.next.store(nullptr, std::memory_order_relaxed);
+
+    source_ = g_source_new(&source_funcs_, sizeof(HandoffSource));
+    reinterpret_cast<HandoffSource*>(source_)->handoff = this;
+    g_source_attach(source_, context_);
+}
+
+ContextHandoff::~ContextHandoff() {
+    g_source_destroy(source_);
+    g_source_unref(source_);
+
+    // 丢弃尚未执行的任务
+    while (Node* node = pop()) {
+        delete node;
+    }
+    g_main_context_unref(context_);
+}
+
+void ContextHandoff::post(Task task) {
+    Node* node = new Node;
+    node->task = std::move(task);
+
+    // 先计数再入队，消费者取出节点时计数不会变为负数
+    pending_.fetch_add(1, std::memory_order_acq_rel);
+    push(node);
+
+    // 上一次唤醒尚未被处理时不再重复唤醒；全屏障与hasPendingTasks()成对，
+    // 要么目标线程看到新计数，要么这里看到已清除的标记
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!wakeup_pending_.exchange(true, std::memory_order_acq_rel)) {
+        g_main_context_wakeup(context_);
+    }
+}
+
+void ContextHandoff::push(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+ContextHandoff::Node* ContextHandoff::pop() {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    // 跳过占位节点
+    if (tail == &stub_) {
+        if (!next) {
+            return nullptr;
+        }
+        tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail_ = next;
+        return tail;
+    }
+
+    // 生产者已交换head_但尚未链接next，稍后再取
+    if (tail != head_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    // 队列只剩最后一个节点，重新压入占位节点后才能取出它
+    push(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        tail_ = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+void ContextHandoff::dispatch() {
+    // 先清除标记再取任务，之后的投递会再次唤醒
+    wakeup_pending_.store(false, std::memory_order_release);
+
+    for (size_t i = 0; i < CONTEXT_HANDOFF_BATCH_LIMIT; ++i) {
+        Node* node = pop();
+        if (!node) {
+            break;
+        }
+
+        pending_.fetch_sub(1, std::memory_order_acq_rel);
+        if (node->task) {
+            node->task();
+        }
+        delete node;
+    }
+}
+
+bool ContextHandoff::hasPendingTasks() {
+    if (pending_.load(std::memory_order_acquire) > 0) {
+        return true;
+    }
+
+    // 没有任务时标记可能来自已执行的投递（投递在分发清除标记之后才置位），
+    // 不清除的话之后的投递都不会再唤醒。清除后重新检查，覆盖两次检查之间看到旧标记的投递
+    wakeup_pending_.store(false, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return pending_.load(std::memory_order_acquire) > 0;
+}
+
+gboolean ContextHandoff::onPrepare(GSource* source, gint* timeout) {
+    *timeout = -1;
+    return reinterpret_cast<HandoffSource*>(source)->handoff->hasPendingTasks();
+}
+
+gboolean ContextHandoff::onCheck(GSource* source) {
+    return reinterpret_cast<HandoffSource*>(source)->handoff->hasPendingTasks();
+}
+
+gboolean ContextHandoff::onDispatch(GSource* source, GSourceFunc callback, gpointer user_data) {
+    reinterpret_cast<HandoffSource*>(source)->handoff->dispatch();
+    return G_SOURCE_CONTINUE;
+}
+
+} // namespace Bluetooth
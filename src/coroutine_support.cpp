@@ -0,0 +1,170 @@
+#include "coroutine_support.h"
+
+#ifdef BLUETOOTH_COROUTINES
+
+#include <iostream>
+#include <exception>
+#include <utility>
+#include <glib-unix.h>
+
+namespace Bluetooth {
+
+void CoTask::promise_type::unhandled_exception() noexcept {
+    // 分离执行的协程没有等待者，异常只能记录下来；完成句柄随后由超时结束请求
+    try {
+        std::rethrow_exception(std::current_exception());
+    } catch (const std::exception& e) {
+        std::cerr << "Unhandled exception in coroutine handler: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unhandled exception in coroutine handler" << std::endl;
+    }
+}
+
+SleepAwaitable::SleepAwaitable(guint interval_ms, GMainContext* context)
+    : interval_ms_(interval_ms), context_(context), source_(nullptr) {
+}
+
+SleepAwaitable::~SleepAwaitable() {
+    if (source_) {
+        g_source_destroy(source_);
+        g_source_unref(source_);
+    }
+}
+
+void SleepAwaitable::await_suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+    source_ = g_timeout_source_new(interval_ms_);
+    g_source_set_callback(source_, onTimeout, this, nullptr);
+    g_source_attach(source_, context_);
+}
+
+gboolean SleepAwaitable::onTimeout(gpointer user_data) {
+    SleepAwaitable* awaitable = static_cast<SleepAwaitable*>(user_data);
+
+    // 恢复后协程可能结束并销毁本对象，先释放源
+    g_source_unref(awaitable->source_);
+    awaitable->source_ = nullptr;
+    awaitable->handle_.resume();
+    return G_SOURCE_REMOVE;
+}
+
+FdAwaitable::FdAwaitable(int fd, GIOCondition condition, guint timeout_ms, GMainContext* context)
+    : fd_(fd), condition_(condition), timeout_ms_(timeout_ms), context_(context),
+      fd_source_(nullptr), timeout_source_(nullptr), result_(static_cast<GIOCondition>(0)) {
+}
+
+FdAwaitable::~FdAwaitable() {
+    if (fd_source_) {
+        g_source_destroy(fd_source_);
+        g_source_unref(fd_source_);
+    }
+    if (timeout_source_) {
+        g_source_destroy(timeout_source_);
+        g_source_unref(timeout_source_);
+    }
+}
+
+void FdAwaitable::await_suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+
+    fd_source_ = g_unix_fd_source_new(fd_, condition_);
+    // GUnixFDSourceFunc通过GSourceFunc登记，经void (*)()转换避免函数类型转换警告
+    g_source_set_callback(fd_source_, reinterpret_cast<GSourceFunc>(reinterpret_cast<void (*)()>(onFdReady)),
+                          this, nullptr);
+    g_source_attach(fd_source_, context_);
+
+    if (timeout_ms_ > 0) {
+        timeout_source_ = g_timeout_source_new(timeout_ms_);
+        g_source_set_callback(timeout_source_, onTimeout, this, nullptr);
+        g_source_attach(timeout_source_, context_);
+    }
+}
+
+void FdAwaitable::resume(GIOCondition result) {
+    // 两个源只有先触发的一个生效，另一个在恢复前销毁；正在分发的源由主循环持有引用
+    if (fd_source_) {
+        g_source_destroy(fd_source_);
+        g_source_unref(fd_source_);
+        fd_source_ = nullptr;
+    }
+    if (timeout_source_) {
+        g_source_destroy(timeout_source_);
+        g_source_unref(timeout_source_);
+        timeout_source_ = nullptr;
+    }
+
+    result_ = result;
+    handle_.resume();
+}
+
+gboolean FdAwaitable::onFdReady(gint fd, GIOCondition condition, gpointer user_data) {
+    static_cast<FdAwaitable*>(user_data)->resume(condition);
+    return G_SOURCE_REMOVE;
+}
+
+gboolean FdAwaitable::onTimeout(gpointer user_data) {
+    static_cast<FdAwaitable*>(user_data)->resume(static_cast<GIOCondition>(0));
+    return G_SOURCE_REMOVE;
+}
+
+DBusReply::DBusReply(DBusReply&& other) noexcept
+    : reply_(other.reply_), error_(other.error_) {
+    other.reply_ = nullptr;
+    other.error_ = nullptr;
+}
+
+DBusReply& DBusReply::operator=(DBusReply&& other) noexcept {
+    if (this != &other) {
+        std::swap(reply_, other.reply_);
+        std::swap(error_, other.error_);
+    }
+    return *this;
+}
+
+DBusReply::~DBusReply() {
+    if (reply_) {
+        g_variant_unref(reply_);
+    }
+    if (error_) {
+        g_error_free(error_);
+    }
+}
+
+DBusCallAwaitable::DBusCallAwaitable(GDBusConnection* connection, const std::string& bus_name,
+                                     const std::string& object_path, const std::string& interface_name,
+                                     const std::string& method_name, GVariant* parameters,
+                                     const GVariantType* reply_type, gint timeout_ms)
+    : connection_(connection), bus_name_(bus_name), object_path_(object_path),
+      interface_name_(interface_name), method_name_(method_name),
+      parameters_(parameters ? g_variant_ref_sink(parameters) : nullptr),
+      reply_type_(reply_type), timeout_ms_(timeout_ms) {
+}
+
+DBusCallAwaitable::~DBusCallAwaitable() {
+    if (parameters_) {
+        g_variant_unref(parameters_);
+    }
+}
+
+void DBusCallAwaitable::await_suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+
+    // 回复在调用线程的默认主循环上下文中分发，协程在同一线程恢复
+    g_dbus_connection_call(connection_, bus_name_.c_str(), object_path_.c_str(),
+                           interface_name_.c_str(), method_name_.c_str(), parameters_,
+                           reply_type_, G_DBUS_CALL_FLAGS_NONE, timeout_ms_, nullptr,
+                           onCallReady, this);
+}
+
+void DBusCallAwaitable::onCallReady(GObject* source, GAsyncResult* result, gpointer user_data) {
+    DBusCallAwaitable* awaitable = static_cast<DBusCallAwaitable*>(user_data);
+
+    GError* error = nullptr;
+    GVariant* reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+    awaitable->reply_ = DBusReply(reply, error);
+    awaitable->handle_.resume();
+}
+
+} // namespace Bluetooth
+
+#endif // BLUETOOTH_COROUTINES
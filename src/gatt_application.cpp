@@ -5,43 +5,28 @@
 
 namespace Bluetooth {
 
-// D-Bus接口静态成员定义
-const GDBusArgInfo GattApplication::method_get_services_args[] = {
-    { nullptr, nullptr, nullptr, nullptr }
-};
-
-const GDBusArgInfo GattApplication::method_get_services_result[] = {
-    { nullptr, "services", "ao", nullptr },
-    { nullptr, nullptr, nullptr, nullptr }
-};
-
-const GDBusMethodInfo GattApplication::interface_methods[] = {
-    {
-        "GetServices",
-        method_get_services_args,
-        method_get_services_result,
-        nullptr
-    },
-    { nullptr, nullptr, nullptr, nullptr }
-};
-
-const GDBusInterfaceInfo GattApplication::interface_info_ = {
-    -1,
-    "org.bluez.GattApplication1",
-    interface_methods,
-    nullptr,
-    nullptr,
-    nullptr
-};
+// D-Bus接口定义
+static const gchar* const APPLICATION_INTROSPECTION_XML =
+    "<node>"
+    "  <interface name='org.bluez.GattApplication1'>"
+    "    <method name='GetServices'>"
+    "      <arg name='services' type='ao' direction='out'/>"
+    "    </method>"
+    "  </interface>"
+    "</node>";
 
 const GDBusInterfaceVTable GattApplication::interface_vtable_ = {
     methodGetServices,
     nullptr,
-    nullptr,
-    nullptr,
     nullptr
 };
 
+GDBusInterfaceInfo* GattApplication::interfaceInfo() {
+    // 内省数据只解析一次
+    static GDBusNodeInfo* node_info = g_dbus_node_info_new_for_xml(APPLICATION_INTROSPECTION_XML, nullptr);
+    return node_info ? node_info->interfaces[0] : nullptr;
+}
+
 GattApplication::GattApplication(const std::string& object_path)
     : object_path_(object_path), connection_(nullptr), registration_id_(0) {
 }
@@ -61,8 +46,8 @@ bool GattApplication::exportInterface(GDBusConnection* connection) {
     registration_id_ = g_dbus_connection_register_object(
         connection,
         object_path_.c_str(),
-        const_cast<GDBusInterfaceInfo*>(&interface_info_),
-        const_cast<GDBusInterfaceVTable*>(&interface_vtable_),
+        interfaceInfo(),
+        &interface_vtable_,
         this,
         nullptr,
         &error
@@ -118,19 +103,19 @@ GVariant* GattApplication::handleGetServices() {
     return result;
 }
 
-GVariant* GattApplication::methodGetServices(GDBusConnection* connection,
-                                            const gchar* sender,
-                                            const gchar* object_path,
-                                            const gchar* interface_name,
-                                            const gchar* method_name,
-                                            GVariant* parameters,
-                                            gpointer user_data,
-                                            GDBusMethodInvocation* invocation) {
+void GattApplication::methodGetServices(GDBusConnection* connection,
+                                        const gchar* sender,
+                                        const gchar* object_path,
+                                        const gchar* interface_name,
+                                        const gchar* method_name,
+                                        GVariant* parameters,
+                                        GDBusMethodInvocation* invocation,
+                                        gpointer user_data) {
     GattApplication* app = static_cast<GattApplication*>(user_data);
     GVariant* result = app->handleGetServices();
-    g_dbus_method_invocation_return_value(invocation, result);
-    g_variant_unref(result);
-    return nullptr;
+
+    // 回复签名为(ao)，元组接管浮动引用
+    g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&result, 1));
 }
 
 } // namespace Bluetooth
\ No newline at end of file
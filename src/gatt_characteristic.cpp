@@ -1,159 +1,1234 @@
 #include "gatt_characteristic.h"
+#include "notification_scheduler.h"
+#include "subscriber_session.h"
+#include "indication_queue.h"
+#include "properties_changed_template.h"
+#include "bluez_interface.h"
+#include "dbus_dispatch.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <glib-2.0/glib.h>
+#include <glib-unix.h>
+#include <gio/gunixfdlist.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
 
 namespace Bluetooth {
 
-// D-Bus接口静态成员定义
-const GDBusArgInfo GattCharacteristic::method_read_value_args[] = {
-    { "options", "a{sv}", nullptr },
-    { nullptr, nullptr, nullptr }
-};
+// D-Bus接口定义
+static const gchar* const CHARACTERISTIC_INTROSPECTION_XML =
+    "<node>"
+    "  <interface name='org.bluez.GattCharacteristic1'>"
+    "    <method name='ReadValue'>"
+    "      <arg name='options' type='a{sv}' direction='in'/>"
+    "      <arg name='value' type='ay' direction='out'/>"
+    "    </method>"
+    "    <method name='WriteValue'>"
+    "      <arg name='value' type='ay' direction='in'/>"
+    "      <arg name='options' type='a{sv}' direction='in'/>"
+    "    </method>"
+    "    <method name='StartNotify'/>"
+    "    <method name='StopNotify'/>"
+    "    <method name='Confirm'/>"
+    "    <method name='AcquireWrite'>"
+    "      <arg name='options' type='a{sv}' direction='in'/>"
+    "      <arg name='fd' type='h' direction='out'/>"
+    "      <arg name='mtu' type='q' direction='out'/>"
+    "    </method>"
+    "    <method name='AcquireNotify'>"
+    "      <arg name='options' type='a{sv}' direction='in'/>"
+    "      <arg name='fd' type='h' direction='out'/>"
+    "      <arg name='mtu' type='q' direction='out'/>"
+    "    </method>"
+    "    <property name='UUID' type='s' access='read'/>"
+    "    <property name='Flags' type='as' access='read'/>"
+    "    <property name='Notifying' type='b' access='read'/>"
+    "    <property name='Value' type='ay' access='read'/>"
+    "    <property name='WriteAcquired' type='b' access='read'/>"
+    "    <property name='NotifyAcquired' type='b' access='read'/>"
+    "  </interface>"
+    "</node>";
 
-const GDBusArgInfo GattCharacteristic::method_read_value_result[] = {
-    { "value", "ay", nullptr },
-    { nullptr, nullptr, nullptr }
+const GDBusInterfaceVTable GattCharacteristic::interface_vtable_ = {
+    methodCallHandler,
+    onGetProperty,
+    nullptr
 };
 
-const GDBusArgInfo GattCharacteristic::method_write_value_args[] = {
-    { "value", "ay", nullptr },
-    { "options", "a{sv}", nullptr },
-    { nullptr, nullptr, nullptr }
-};
+GDBusInterfaceInfo* GattCharacteristic::interfaceInfo() {
+    // 内省数据只解析一次，所有特征值共享
+    static GDBusNodeInfo* node_info = g_dbus_node_info_new_for_xml(CHARACTERISTIC_INTROSPECTION_XML, nullptr);
+    return node_info ? node_info->interfaces[0] : nullptr;
+}
 
-const GDBusMethodInfo GattCharacteristic::interface_methods[] = {
-    {
-        "ReadValue",
-        method_read_value_args,
-        method_read_value_result,
-        nullptr
-    },
-    {
-        "WriteValue",
-        method_write_value_args,
-        nullptr,
-        nullptr
-    },
-    {
-        "StartNotify",
-        nullptr,
-        nullptr,
-        nullptr
-    },
-    {
-        "StopNotify",
-        nullptr,
-        nullptr,
-        nullptr
-    },
-    { nullptr, nullptr, nullptr, nullptr }
+// 方法名和属性名的分派表，编译期生成完美哈希
+enum class CharacteristicMethod {
+    READ_VALUE,
+    WRITE_VALUE,
+    START_NOTIFY,
+    STOP_NOTIFY,
+    CONFIRM,
+    ACQUIRE_WRITE,
+    ACQUIRE_NOTIFY
 };
 
-const GDBusPropertyInfo GattCharacteristic::interface_properties[] = {
-    { "UUID", "s", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "Flags", "as", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "Notifying", "b", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "Value", "ay", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { nullptr, nullptr, G_DBUS_PROPERTY_INFO_FLAGS_NONE }
+enum class CharacteristicProperty {
+    UUID,
+    FLAGS,
+    NOTIFYING,
+    VALUE,
+    WRITE_ACQUIRED,
+    NOTIFY_ACQUIRED
 };
 
-const GDBusInterfaceInfo GattCharacteristic::interface_info_ = {
-    -1,
-    "org.bluez.GattCharacteristic1",
-    interface_methods,
-    nullptr,
-    interface_properties,
-    nullptr
-};
+constexpr auto CHARACTERISTIC_METHODS = makeNameTable<CharacteristicMethod>({
+    { "ReadValue", CharacteristicMethod::READ_VALUE },
+    { "WriteValue", CharacteristicMethod::WRITE_VALUE },
+    { "StartNotify", CharacteristicMethod::START_NOTIFY },
+    { "StopNotify", CharacteristicMethod::STOP_NOTIFY },
+    { "Confirm", CharacteristicMethod::CONFIRM },
+    { "AcquireWrite", CharacteristicMethod::ACQUIRE_WRITE },
+    { "AcquireNotify", CharacteristicMethod::ACQUIRE_NOTIFY }
+});
+static_assert(CHARACTERISTIC_METHODS.isValid(), "No perfect hash seed for characteristic methods");
 
-const GDBusInterfaceVTable GattCharacteristic::interface_vtable_ = {
-    methodCallHandler,
-    nullptr,
-    onGetProperty,
-    nullptr,
-    nullptr
-};
+constexpr auto CHARACTERISTIC_PROPERTIES = makeNameTable<CharacteristicProperty>({
+    { "UUID", CharacteristicProperty::UUID },
+    { "Flags", CharacteristicProperty::FLAGS },
+    { "Notifying", CharacteristicProperty::NOTIFYING },
+    { "Value", CharacteristicProperty::VALUE },
+    { "WriteAcquired", CharacteristicProperty::WRITE_ACQUIRED },
+    { "NotifyAcquired", CharacteristicProperty::NOTIFY_ACQUIRED }
+});
+static_assert(CHARACTERISTIC_PROPERTIES.isValid(), "No perfect hash seed for characteristic properties");
 
 GattCharacteristic::GattCharacteristic(const std::string& uuid,
                                      const std::vector<CharacteristicFlags>& flags,
                                      const std::string& object_path_prefix)
-    : uuid_(uuid), flags_(flags), connection_(nullptr), registration_id_(0), notifying_(false) {
+    : uuid_(uuid), flags_(flags), connection_(nullptr), registration_id_(0),
+      value_(ByteValue()), staging_(false), has_staged_value_(false), has_deferred_write_(false),
+      coalescing_enabled_(true), notification_pending_(false),
+      priority_(NotificationPriority::INTERACTIVE), dispatch_pending_(false),
+      rate_limiter_([this]() { dispatchNotification(); }),
+      history_replay_count_(0), stream_source_id_(0), write_error_(nullptr),
+      alive_(std::make_shared<bool>(true)), async_timeout_ms_(ASYNC_CALLBACK_DEFAULT_TIMEOUT_MS),
+      write_fd_(-1), write_mtu_(DEFAULT_ATT_MTU), write_watch_id_(0), write_sequence_(0),
+      applied_write_sequence_(0) {
 
     // 生成唯一对象路径
     static int characteristic_counter = 0;
     object_path_ = object_path_prefix + std::to_string(characteristic_counter++);
+
+    if (hasFlag(CharacteristicFlags::INDICATE)) {
+        // 指示经由PropertiesChanged送达信号订阅者，由它们（StartNotify调用者）确认
+        indication_queue_ = std::make_unique<IndicationQueue>([this](const ValueSnapshot& value) {
+            return emitValue(value);
+        }, [this]() {
+            std::vector<std::string> recipients;
+            for (const auto& entry : subscribers_) {
+                if (!entry.second->hasSocket()) {
+                    recipients.push_back(entry.first);
+                }
+            }
+            return recipients;
+        });
+    }
+
+    // 可靠写必须在执行前组装；普通可写特征值只在配置了组装时才启用
+    if (hasFlag(CharacteristicFlags::RELIABLE_WRITE)) {
+        write_assembler_ = std::make_unique<WriteAssembler>();
+    }
+}
+
+GattCharacteristic::~GattCharacteristic() {
+    if (scheduler_) {
+        scheduler_->cancel(this);
+    }
+    if (dispatcher_) {
+        dispatcher_->cancel(this);
+    }
+    unexportInterface();
+}
+
+bool GattCharacteristic::exportInterface(GDBusConnection* connection, const std::string& service_path) {
+    if (!connection || registration_id_ != 0) {
+        return false;
+    }
+
+    connection_ = connection;
+    GError* error = nullptr;
+
+    registration_id_ = g_dbus_connection_register_object(
+        connection,
+        object_path_.c_str(),
+        interfaceInfo(),
+        &interface_vtable_,
+        this,
+        nullptr,
+        &error
+    );
+
+    if (registration_id_ == 0) {
+        std::cerr << "Failed to register GATT characteristic: " << error->message << std::endl;
+        g_error_free(error);
+        connection_ = nullptr;
+        return false;
+    }
+
+    std::cout << "GATT characteristic exported at path: " << object_path_
+              << " with UUID: " << uuid_ << std::endl;
+    return true;
+}
+
+void GattCharacteristic::unexportInterface() {
+    cancelStream();
+    while (!subscribers_.empty()) {
+        removeSubscriber(subscribers_.begin()->first);
+    }
+    releaseWrite();
+
+    if (connection_ && registration_id_ != 0) {
+        g_dbus_connection_unregister_object(connection_, registration_id_);
+        registration_id_ = 0;
+        std::cout << "GATT characteristic unexported: " << uuid_ << std::endl;
+    }
+    connection_ = nullptr;
+}
+
+bool GattCharacteristic::setValue(const ByteValue& value) {
+    // 任一BLOCK_PRODUCER订阅者队列已满时拒绝更新，生产者应等待低水位回调
+    for (const auto& entry : subscribers_) {
+        if (entry.second->isBlockingProducer()) {
+            return false;
+        }
+    }
+
+    if (staging_) {
+        // 事务中只暂存，读取者仍看到事务前的值
+        staged_value_ = ValueSnapshot(value);
+        has_staged_value_ = true;
+        return true;
+    }
+
+    // 构造新快照后整体替换，已排队或正在发送的旧快照不受影响
+    value_ = ValueSnapshot(value);
+    recordHistory();
+    scheduleNotification();
+    return true;
+}
+
+void GattCharacteristic::attachValueSlot(std::shared_ptr<ValueSlot> slot, GMainContext* context) {
+    slot_watch_.reset();
+    if (!slot) {
+        return;
+    }
+
+    // 回调在主循环线程中执行，可以安全地更新值并发送通知
+    slot_watch_ = std::make_unique<ValueSlotWatch>(slot, [this](const ByteValue& value) {
+        setValue(value);
+    }, context);
+}
+
+void GattCharacteristic::enableHistory(size_t capacity, size_t max_value_size) {
+    history_ = std::make_unique<ValueHistory>(capacity, max_value_size);
+}
+
+void GattCharacteristic::disableHistory() {
+    history_.reset();
+}
+
+void GattCharacteristic::recordHistory() {
+    if (history_) {
+        history_->append(value_.data(), value_.size(), g_get_monotonic_time());
+    }
+}
+
+void GattCharacteristic::setValueStore(std::shared_ptr<ValueStore> store) {
+    value_store_ = store;
+
+    ByteValue restored;
+    if (value_store_ && value_store_->lookup(uuid_, restored)) {
+        value_ = ValueSnapshot(restored);
+        recordHistory();
+        std::cout << "Restored persisted value for characteristic: " << uuid_ << std::endl;
+    }
+}
+
+void GattCharacteristic::persistValue() {
+    if (value_store_ && !value_store_->append(uuid_, value_.data(), value_.size())) {
+        std::cerr << "Failed to persist value for characteristic: " << uuid_ << std::endl;
+    }
+}
+
+void GattCharacteristic::replayHistory(SubscriberSession* session) {
+    if (!history_ || history_replay_count_ == 0 || !session) {
+        return;
+    }
+
+    // 信号订阅者共享广播编码流，回放的旧值会打乱其他订阅者的序号；套接字订阅者在写出时各自编码
+    if (payload_encoder_ && !session->hasSocket()) {
+        std::cerr << "History replay skipped on encoded characteristic: " << uuid_ << std::endl;
+        return;
+    }
+
+    history_->visitLatest(history_replay_count_, [this, session](gint64, const uint8_t* data, size_t size) {
+        ValueSnapshot snapshot(data, size);
+        if (session->hasSocket()) {
+            session->enqueue(snapshot);
+        } else if (emitValue(snapshot)) {
+            session->recordBroadcast();
+        }
+    });
+
+    // 与通知路径一样，写入失败的套接字会话立即移除
+    if (session->isClosed()) {
+        removeSubscriber(std::string(session->getDevicePath()));
+    }
+}
+
+void GattCharacteristic::beginStaging() {
+    staging_ = true;
+    has_staged_value_ = false;
+}
+
+bool GattCharacteristic::commitStaging() {
+    staging_ = false;
+    bool changed = has_staged_value_;
+
+    if (has_staged_value_) {
+        value_.swap(staged_value_);
+        recordHistory();
+        staged_value_.reset();
+        has_staged_value_ = false;
+    }
+
+    // 事务期间到达的客户端写入排在事务之后，与事务的值一起在提交阶段生效
+    if (has_deferred_write_) {
+        value_ = deferred_write_;
+        recordHistory();
+        persistValue();
+        deferred_write_.reset();
+        has_deferred_write_ = false;
+        changed = true;
+    }
+
+    return changed;
+}
+
+void GattCharacteristic::discardStaging() {
+    staging_ = false;
+    has_staged_value_ = false;
+    staged_value_.reset();
+
+    std::vector<StagedIndication> cancelled;
+    cancelled.swap(staged_indications_);
+    for (const auto& indication : cancelled) {
+        if (indication.callback) {
+            indication.callback(indication.id, IndicationStatus::CANCELLED);
+        }
+    }
+
+    // 回滚只丢弃应用暂存的值，已被接受的客户端写入照常生效
+    applyDeferredWrite();
+}
+
+void GattCharacteristic::flushStagedNotification() {
+    // 事务提交即一次集中刷新，不再等待合并窗口
+    if (scheduler_) {
+        scheduler_->cancel(this);
+    }
+
+    if (staged_indications_.empty() || !indication_queue_) {
+        notifyValueChanged();
+        return;
+    }
+
+    // 事务中的指示合并为一次：以提交的值发送，完成时逐个回调
+    std::vector<StagedIndication> staged;
+    staged.swap(staged_indications_);
+    uint64_t id = staged.back().id;
+    auto complete = [staged](uint64_t, IndicationStatus status) {
+        for (const auto& indication : staged) {
+            if (indication.callback) {
+                indication.callback(indication.id, status);
+            }
+        }
+    };
+
+    ValueSnapshot wire_value = encodePayload(value_);
+    if (!wire_value) {
+        complete(id, IndicationStatus::CANCELLED);
+        return;
+    }
+    indication_queue_->submit(wire_value, complete, id);
+}
+
+void GattCharacteristic::storeWrittenValue(const ValueSnapshot& value) {
+    // 事务期间只记下最新的客户端写入，读取者仍看到事务前的值
+    if (staging_) {
+        deferred_write_ = value;
+        has_deferred_write_ = true;
+        return;
+    }
+
+    value_ = value;
+    recordHistory();
+    persistValue();
+
+    // 如果启用了通知，发送值更改通知
+    scheduleNotification();
+}
+
+void GattCharacteristic::applyDeferredWrite() {
+    if (!has_deferred_write_) {
+        return;
+    }
+
+    ValueSnapshot value;
+    value.swap(deferred_write_);
+    has_deferred_write_ = false;
+    storeWrittenValue(value);
+}
+
+void GattCharacteristic::scheduleNotification() {
+    if (subscribers_.empty()) {
+        return;
+    }
+
+    if (scheduler_ && coalescing_enabled_ && priority_ != NotificationPriority::CRITICAL) {
+        // 只标记为脏，由调度器在刷新窗口到期时发送最新值
+        scheduler_->markDirty(this);
+    } else {
+        notifyValueChanged();
+    }
+}
+
+void GattCharacteristic::notifyValueChanged() {
+    if (subscribers_.empty()) {
+        return;
+    }
+
+    // 特征值级限速：推迟时由限速器在令牌可用后发送届时的最新值
+    if (!rate_limiter_.admit()) {
+        return;
+    }
+
+    dispatchNotification();
+}
+
+void GattCharacteristic::dispatchNotification() {
+    if (dispatcher_) {
+        // 按优先级排队，发送时取届时的最新值
+        dispatcher_->submit(this);
+    } else {
+        deliverNotification();
+    }
+}
+
+void GattCharacteristic::deliverNotification() {
+    if (subscribers_.empty()) {
+        return;
+    }
+
+    // 套接字订阅者各自排队写出，一个慢订阅者只会堆积自己的队列；
+    // 队列中是完整值，写出时由会话各自编码，丢弃和限速替换不会打乱其解码序列
+    std::vector<SubscriberSession*> signal_subscribers;
+    std::vector<std::string> closed_subscribers;
+
+    for (const auto& entry : subscribers_) {
+        SubscriberSession* session = entry.second.get();
+        if (!session->hasSocket()) {
+            signal_subscribers.push_back(session);
+            continue;
+        }
+
+        session->enqueue(value_);
+        if (session->isClosed()) {
+            closed_subscribers.push_back(entry.first);
+        }
+    }
+
+    // PropertiesChanged由BlueZ扇出到所有设备，信号订阅者共享一次发送和同一编码流
+    if (!signal_subscribers.empty()) {
+        // 编码后的关键帧超过MTU时为空，不发送
+        ValueSnapshot wire_value = encodePayload(value_);
+        bool sent = false;
+        if (wire_value && indication_queue_ && !hasFlag(CharacteristicFlags::NOTIFY)) {
+            // 仅支持指示的特征值经由指示窗口流控
+            sent = indication_queue_->submit(wire_value, nullptr) != 0;
+        } else if (wire_value) {
+            sent = emitValue(wire_value);
+        }
+
+        if (sent) {
+            for (SubscriberSession* session : signal_subscribers) {
+                session->recordBroadcast();
+            }
+        }
+    }
+
+    notification_stats_.sent_updates++;
+
+    for (const auto& device_path : closed_subscribers) {
+        removeSubscriber(device_path);
+    }
+}
+
+uint64_t GattCharacteristic::indicate(const ByteValue& value, IndicationCallback callback) {
+    if (!indication_queue_) {
+        std::cerr << "Characteristic does not support indications: " << uuid_ << std::endl;
+        return 0;
+    }
+
+    if (subscribers_.empty()) {
+        return 0;
+    }
+
+    if (staging_) {
+        // 与setValue一样只暂存，提交时统一发送
+        staged_value_ = ValueSnapshot(value);
+        has_staged_value_ = true;
+        uint64_t id = indication_queue_->reserveId();
+        staged_indications_.push_back({ id, callback });
+        return id;
+    }
+
+    value_ = ValueSnapshot(value);
+    recordHistory();
+    ValueSnapshot wire_value = encodePayload(value_);
+    if (!wire_value) {
+        return 0;
+    }
+    return indication_queue_->submit(wire_value, callback);
+}
+
+void GattCharacteristic::setPayloadEncoding(const PayloadEncodingConfig& config) {
+    payload_encoding_ = config;
+
+    // 新编码器的第一帧总是关键帧
+    if (config.mode == PayloadEncoding::NONE) {
+        payload_encoder_.reset();
+    } else {
+        payload_encoder_ = std::make_unique<PayloadEncoder>(config);
+    }
+
+    for (const auto& entry : subscribers_) {
+        if (entry.second->hasSocket()) {
+            entry.second->setPayloadEncoding(config);
+        }
+    }
+}
+
+PayloadEncodingStatistics GattCharacteristic::getPayloadEncodingStatistics() const {
+    // 广播编码流与各套接字订阅者的编码流合计
+    PayloadEncodingStatistics total;
+    if (payload_encoder_) {
+        total = payload_encoder_->getStatistics();
+    }
+
+    for (const auto& entry : subscribers_) {
+        PayloadEncodingStatistics stats = entry.second->getPayloadEncodingStatistics();
+        total.raw_bytes += stats.raw_bytes;
+        total.encoded_bytes += stats.encoded_bytes;
+        total.keyframes += stats.keyframes;
+        total.delta_frames += stats.delta_frames;
+        total.oversized += stats.oversized;
+    }
+    return total;
+}
+
+ValueSnapshot GattCharacteristic::encodePayload(const ValueSnapshot& value) {
+    if (!payload_encoder_) {
+        return value;
+    }
+
+    // BlueZ按各设备的MTU截断信号中的值，帧必须放进已知设备中最小的MTU
+    ByteValue frame = payload_encoder_->encode(value.toByteValue(), signalMtu() - ATT_NOTIFICATION_HEADER_SIZE);
+    return frame.empty() ? ValueSnapshot() : ValueSnapshot(frame);
+}
+
+void GattCharacteristic::setIndicationConfig(const IndicationConfig& config) {
+    if (indication_queue_) {
+        indication_queue_->setConfig(config);
+    }
+}
+
+IndicationStatistics GattCharacteristic::getIndicationStatistics() const {
+    if (!indication_queue_) {
+        return IndicationStatistics();
+    }
+    return indication_queue_->getStatistics();
+}
+
+void GattCharacteristic::setWriteAssemblyConfig(const WriteAssemblyConfig& config) {
+    if (!write_assembler_ && hasFlag(CharacteristicFlags::WRITE)) {
+        write_assembler_ = std::make_unique<WriteAssembler>();
+    }
+    if (write_assembler_) {
+        write_assembler_->setConfig(config);
+    }
+}
+
+WriteAssemblyStatistics GattCharacteristic::getWriteAssemblyStatistics() const {
+    if (!write_assembler_) {
+        return WriteAssemblyStatistics();
+    }
+    return write_assembler_->getStatistics();
+}
+
+bool GattCharacteristic::emitValue(const ValueSnapshot& value) {
+    if (!connection_) {
+        return false;
+    }
+
+    return emitPropertyChanged("Value", bytesToGvariant(value));
 }
 
-GattCharacteristic::~GattCharacteristic() {
-    unexportInterface();
+bool GattCharacteristic::hasFlag(CharacteristicFlags flag) const {
+    return std::find(flags_.begin(), flags_.end(), flag) != flags_.end();
+}
+
+SubscriberSession* GattCharacteristic::addSubscriber(const std::string& device_path) {
+    auto it = subscribers_.find(device_path);
+    if (it != subscribers_.end()) {
+        return it->second.get();
+    }
+
+    auto session = std::make_unique<SubscriberSession>(device_path, default_queue_config_);
+    session->setRateLimit(default_subscriber_rate_limit_);
+    session->setWatermarkCallback(watermark_callback_);
+    session->setClosedCallback([this](const std::string& path) {
+        removeSubscriber(path);
+    });
+
+    SubscriberSession* result = session.get();
+    subscribers_[device_path] = std::move(session);
+
+    // 新的信号订阅者没有解码基准，广播流的下一帧发送关键帧（套接字订阅者的编码器从关键帧开始）
+    if (payload_encoder_) {
+        payload_encoder_->requestKeyframe();
+    }
+
+    if (notify_callback_) {
+        notify_callback_(device_path, true);
+    }
+
+    return result;
+}
+
+void GattCharacteristic::removeSubscriber(const std::string& device_path) {
+    auto it = subscribers_.find(device_path);
+    if (it == subscribers_.end()) {
+        return;
+    }
+
+    // 先取出会话再销毁，回调中可能再次访问订阅表；device_path可能引用表中的键，删除前复制
+    std::string path = device_path;
+    std::unique_ptr<SubscriberSession> session = std::move(it->second);
+    subscribers_.erase(it);
+
+    if (session->hasSocket()) {
+        std::cout << "Notify socket released on characteristic: " << uuid_
+                  << " from device: " << path << std::endl;
+    } else if (indication_queue_ && !subscribers_.empty()) {
+        // 其余订阅者已确认的指示不再等待离开的订阅者
+        indication_queue_->removeRecipient(path);
+    }
+    session.reset();
+
+    if (subscribers_.empty()) {
+        if (scheduler_) {
+            scheduler_->cancel(this);
+        }
+        if (dispatcher_) {
+            dispatcher_->cancel(this);
+        }
+        rate_limiter_.cancel();
+        if (indication_queue_) {
+            indication_queue_->cancelAll();
+        }
+    }
+
+    if (notify_callback_) {
+        notify_callback_(path, false);
+    }
+}
+
+void GattCharacteristic::setSubscriberQueueConfig(const SubscriberQueueConfig& config) {
+    default_queue_config_ = config;
+    for (const auto& entry : subscribers_) {
+        entry.second->setQueueConfig(config);
+    }
+}
+
+bool GattCharacteristic::setSubscriberQueueConfig(const std::string& device_path,
+                                                  const SubscriberQueueConfig& config) {
+    auto it = subscribers_.find(device_path);
+    if (it == subscribers_.end()) {
+        return false;
+    }
+
+    it->second->setQueueConfig(config);
+    return true;
+}
+
+void GattCharacteristic::setRateLimit(const RateLimitConfig& config) {
+    rate_limiter_.configure(config);
+}
+
+void GattCharacteristic::setSubscriberRateLimit(const RateLimitConfig& config) {
+    default_subscriber_rate_limit_ = config;
+    for (const auto& entry : subscribers_) {
+        entry.second->setRateLimit(config);
+    }
+}
+
+bool GattCharacteristic::setSubscriberRateLimit(const std::string& device_path, const RateLimitConfig& config) {
+    auto it = subscribers_.find(device_path);
+    if (it == subscribers_.end()) {
+        return false;
+    }
+
+    it->second->setRateLimit(config);
+    return true;
+}
+
+void GattCharacteristic::setWatermarkCallback(WatermarkCallback callback) {
+    watermark_callback_ = callback;
+    for (const auto& entry : subscribers_) {
+        entry.second->setWatermarkCallback(callback);
+    }
+}
+
+std::vector<std::string> GattCharacteristic::getSubscribers() const {
+    std::vector<std::string> devices;
+    for (const auto& entry : subscribers_) {
+        devices.push_back(entry.first);
+    }
+    return devices;
+}
+
+bool GattCharacteristic::getSubscriberStatistics(const std::string& device_path,
+                                                 SubscriberStatistics& stats) const {
+    auto it = subscribers_.find(device_path);
+    if (it == subscribers_.end()) {
+        return false;
+    }
+
+    stats = it->second->getStatistics();
+    return true;
+}
+
+bool GattCharacteristic::isNotifyAcquired() const {
+    for (const auto& entry : subscribers_) {
+        if (entry.second->hasSocket()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int GattCharacteristic::acquireNotify(const std::string& device_path, uint16_t mtu) {
+    auto it = subscribers_.find(device_path);
+    if (it != subscribers_.end() && it->second->hasSocket()) {
+        std::cerr << "Notify socket already acquired on characteristic: " << uuid_
+                  << " by device: " << device_path << std::endl;
+        return -1;
+    }
+
+    // SEQPACKET保留消息边界：一次write()对应一个通知
+    int fds[2];
+    if (!createSocketPair(fds)) {
+        return -1;
+    }
+
+    SubscriberSession* session = addSubscriber(device_path);
+    session->attachSocket(fds[0], mtu);
+    session->setPayloadEncoding(payload_encoding_);
+    learnMtu(device_path, session->getMtu());
+
+    std::cout << "AcquireNotify on characteristic: " << uuid_
+              << " from device: " << device_path << " (MTU " << session->getMtu() << ")" << std::endl;
+
+    return fds[1];
+}
+
+void GattCharacteristic::releaseNotify(const std::string& device_path) {
+    auto it = subscribers_.find(device_path);
+    if (it != subscribers_.end() && it->second->hasSocket()) {
+        removeSubscriber(device_path);
+    }
+}
+
+uint16_t GattCharacteristic::getNotifyMtu(const std::string& device_path) const {
+    auto it = subscribers_.find(device_path);
+    if (it == subscribers_.end() || !it->second->hasSocket()) {
+        return DEFAULT_ATT_MTU;
+    }
+    return it->second->getMtu();
+}
+
+uint16_t GattCharacteristic::getDeviceMtu(const std::string& device_path) const {
+    auto it = device_mtus_.find(device_path);
+    return it != device_mtus_.end() ? it->second : DEFAULT_ATT_MTU;
+}
+
+void GattCharacteristic::learnMtu(const std::string& device_path, uint16_t mtu) {
+    if (!device_path.empty() && mtu >= DEFAULT_ATT_MTU) {
+        device_mtus_[device_path] = mtu;
+    }
+}
+
+bool GattCharacteristic::streamValue(const ByteValue& data, StreamCallback callback) {
+    // 生产者按偏移从同一份快照中取数据
+    ValueSnapshot snapshot(data);
+    size_t offset = 0;
+    return streamValue([snapshot, offset](uint8_t* buffer, size_t capacity) mutable {
+        size_t size = std::min(capacity, snapshot.size() - offset);
+        if (size > 0) {
+            std::memcpy(buffer, snapshot.data() + offset, size);
+            offset += size;
+        }
+        return size;
+    }, callback);
+}
+
+bool GattCharacteristic::streamValue(StreamProducer producer, StreamCallback callback) {
+    if (subscribers_.empty() || stream_chunker_) {
+        return false;
+    }
+
+    size_t payload_size = streamMtu() - ATT_NOTIFICATION_HEADER_SIZE - STREAM_HEADER_SIZE;
+    stream_chunker_ = std::make_unique<StreamChunker>(producer, payload_size);
+    stream_callback_ = callback;
+    stream_source_id_ = g_timeout_add(stream_config_.interval_ms, onStreamTick, this);
+
+    std::cout << "Stream started on characteristic: " << uuid_
+              << " (" << payload_size << " bytes per chunk)" << std::endl;
+    return true;
+}
+
+void GattCharacteristic::cancelStream() {
+    if (stream_source_id_ != 0) {
+        g_source_remove(stream_source_id_);
+        stream_source_id_ = 0;
+    }
+
+    if (stream_chunker_) {
+        finishStream(false);
+    }
+}
+
+uint16_t GattCharacteristic::streamMtu() const {
+    uint16_t mtu = UINT16_MAX;
+    bool has_signal_subscriber = false;
+
+    for (const auto& entry : subscribers_) {
+        if (entry.second->hasSocket()) {
+            mtu = std::min(mtu, entry.second->getMtu());
+        } else {
+            has_signal_subscriber = true;
+        }
+    }
+
+    if (has_signal_subscriber) {
+        mtu = std::min(mtu, signalMtu());
+    }
+
+    return std::max(mtu, DEFAULT_ATT_MTU);
+}
+
+uint16_t GattCharacteristic::signalMtu() const {
+    // PropertiesChanged由BlueZ扇出到所有设备，取已知设备中最小的MTU
+    uint16_t mtu = device_mtus_.empty() ? DEFAULT_ATT_MTU : UINT16_MAX;
+    for (const auto& entry : device_mtus_) {
+        mtu = std::min(mtu, entry.second);
+    }
+    return std::max(mtu, DEFAULT_ATT_MTU);
+}
+
+bool GattCharacteristic::streamSinkReady() const {
+    // 任一套接字订阅者越过高水位就暂停，分块不能像普通通知那样被丢弃或合并
+    for (const auto& entry : subscribers_) {
+        if (entry.second->hasSocket()) {
+            if (!entry.second->canAcceptWithoutLoss()) {
+                return false;
+            }
+        } else if (indication_queue_ && !hasFlag(CharacteristicFlags::NOTIFY) &&
+                   indication_queue_->getStatistics().pending > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void GattCharacteristic::emitStreamChunk(const ValueSnapshot& chunk) {
+    std::vector<SubscriberSession*> signal_subscribers;
+    std::vector<std::string> closed_subscribers;
+
+    for (const auto& entry : subscribers_) {
+        SubscriberSession* session = entry.second.get();
+        if (!session->hasSocket()) {
+            signal_subscribers.push_back(session);
+            continue;
+        }
+
+        // 分块自带帧头，不经过负载编码；也不经过订阅者限速，丢弃策略会让流缺块却报告完成
+        session->enqueueStreamChunk(chunk);
+        if (session->isClosed()) {
+            closed_subscribers.push_back(entry.first);
+        }
+    }
+
+    if (!signal_subscribers.empty()) {
+        bool sent = false;
+        if (indication_queue_ && !hasFlag(CharacteristicFlags::NOTIFY)) {
+            sent = indication_queue_->submit(chunk, nullptr) != 0;
+        } else {
+            sent = emitValue(chunk);
+        }
+
+        if (sent) {
+            for (SubscriberSession* session : signal_subscribers) {
+                session->recordBroadcast();
+            }
+        }
+    }
+
+    for (const auto& device_path : closed_subscribers) {
+        removeSubscriber(device_path);
+    }
+}
+
+bool GattCharacteristic::pumpStream() {
+    // 订阅者全部离开时放弃剩余数据
+    if (subscribers_.empty()) {
+        finishStream(false);
+        return false;
+    }
+
+    ValueSnapshot chunk;
+    for (size_t i = 0; i < stream_config_.chunks_per_tick && streamSinkReady(); ++i) {
+        if (!stream_chunker_->next(chunk)) {
+            break;
+        }
+        emitStreamChunk(chunk);
+
+        // 移除失效订阅者时的通知回调可能取消了流
+        if (!stream_chunker_) {
+            return false;
+        }
+    }
+
+    if (stream_chunker_->isFinished()) {
+        std::cout << "Stream completed on characteristic: " << uuid_ << " ("
+                  << stream_chunker_->getByteCount() << " bytes in "
+                  << stream_chunker_->getChunkCount() << " chunks)" << std::endl;
+        finishStream(true);
+        return false;
+    }
+
+    return true;
+}
+
+void GattCharacteristic::finishStream(bool completed) {
+    // 回调中可能开始新的流，先清理当前流的状态
+    stream_chunker_.reset();
+    stream_source_id_ = 0;
+    StreamCallback callback;
+    callback.swap(stream_callback_);
+
+    if (callback) {
+        callback(completed);
+    }
+}
+
+gboolean GattCharacteristic::onStreamTick(gpointer user_data) {
+    GattCharacteristic* characteristic = static_cast<GattCharacteristic*>(user_data);
+    return characteristic->pumpStream() ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+int GattCharacteristic::acquireWrite(const std::string& device_path, uint16_t mtu) {
+    if (write_fd_ >= 0) {
+        std::cerr << "Write socket already acquired on characteristic: " << uuid_ << std::endl;
+        return -1;
+    }
+
+    // 每个数据报对应客户端的一次Write Command
+    int fds[2];
+    if (!createSocketPair(fds)) {
+        return -1;
+    }
+
+    write_fd_ = fds[0];
+    write_mtu_ = std::max<uint16_t>(mtu, DEFAULT_ATT_MTU);
+    learnMtu(device_path, write_mtu_);
+    write_device_ = device_path;
+    write_buffer_.resize(write_mtu_);
+
+    write_watch_id_ = g_unix_fd_add(write_fd_,
+        static_cast<GIOCondition>(G_IO_IN | G_IO_HUP | G_IO_ERR), onWriteSocketEvent, this);
+
+    std::cout << "AcquireWrite on characteristic: " << uuid_
+              << " from device: " << device_path << " (MTU " << write_mtu_ << ")" << std::endl;
+
+    return fds[1];
+}
+
+void GattCharacteristic::releaseWrite() {
+    if (write_fd_ < 0) {
+        return;
+    }
+
+    if (write_watch_id_ != 0) {
+        g_source_remove(write_watch_id_);
+        write_watch_id_ = 0;
+    }
+
+    close(write_fd_);
+    write_fd_ = -1;
+    write_mtu_ = DEFAULT_ATT_MTU;
+    write_device_.clear();
+
+    std::cout << "Write socket released on characteristic: " << uuid_ << std::endl;
+}
+
+bool GattCharacteristic::drainWriteSocket() {
+    ByteValue packet;
+    ByteValue latest;
+    packet.reserve(write_buffer_.size());
+
+    AccessOptions access;
+    access.device = write_device_;
+    access.mtu = write_mtu_;
+    access.type = "command";
+    bool accepted_any = false;
+    uint64_t latest_sequence = 0;
+
+    // 有执行器时整批复制后作为一个任务提交，回调在工作线程中调用
+    std::shared_ptr<std::vector<ByteValue>> batch;
+    uint64_t first_sequence = write_sequence_ + 1;
+    if (!async_write_callback_ && executor_ && (write_view_callback_ || write_callback_)) {
+        batch = std::make_shared<std::vector<ByteValue>>();
+    }
+
+    // 每次唤醒最多处理一批数据报，避免持续写入饿死主循环中的其他源
+    for (size_t i = 0; i < WRITE_SOCKET_BATCH_LIMIT; i++) {
+        ssize_t received = recv(write_fd_, write_buffer_.data(), write_buffer_.size(), MSG_DONTWAIT);
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            std::cerr << "Failed to read write socket: " << strerror(errno) << std::endl;
+            return false;
+        }
+        if (received == 0) {
+            // 对端已关闭
+            return false;
+        }
+
+        // packet的容量在整批中复用，不会为每次写入重新分配
+        ByteView datagram(write_buffer_.data(), static_cast<size_t>(received));
+        uint64_t sequence = ++write_sequence_;
+        if (async_write_callback_) {
+            startAsyncSocketWrite(datagram, access, sequence);
+            continue;
+        }
+        if (batch) {
+            batch->emplace_back(datagram.data(), datagram.size());
+            continue;
+        }
+        if (write_view_callback_) {
+            // 回调直接读取接收缓冲，接受后才复制
+            if (!write_view_callback_(datagram, access)) {
+                continue;
+            }
+            packet.assign(datagram.data(), datagram.size());
+        } else {
+            packet.assign(datagram.data(), datagram.size());
+            if (write_callback_ && !write_callback_(write_device_, packet)) {
+                continue;
+            }
+        }
+
+        accepted_any = true;
+        latest_sequence = sequence;
+        latest.swap(packet);
+        if (packet.capacity() < write_buffer_.size()) {
+            packet.reserve(write_buffer_.size());
+        }
+    }
+
+    if (batch && !batch->empty()) {
+        submitSocketWrites(batch, access, first_sequence);
+    }
+
+    // 整批只生成一次快照、更新一次通知
+    if (accepted_any) {
+        applySocketWrite(latest_sequence, latest);
+    }
+
+    return true;
+}
+
+void GattCharacteristic::submitSocketWrites(std::shared_ptr<std::vector<ByteValue>> batch,
+                                            const AccessOptions& access, uint64_t first_sequence) {
+    // 工作线程只使用回调和数据报的副本，batch->size()表示没有被接受的写入
+    WriteViewCallback view_callback = write_view_callback_;
+    WriteCallback callback = write_callback_;
+    auto accepted = std::make_shared<size_t>(batch->size());
+    std::weak_ptr<bool> alive = alive_;
+
+    bool submitted = executor_->submit([batch, view_callback, callback, access, accepted]() {
+        for (size_t i = 0; i < batch->size(); ++i) {
+            const ByteValue& packet = (*batch)[i];
+            bool ok = view_callback ? view_callback(ByteView(packet), access) : callback(access.device, packet);
+            if (ok) {
+                *accepted = i;
+            }
+        }
+    }, [this, alive, batch, accepted, first_sequence]() {
+        if (alive.expired() || *accepted == batch->size()) {
+            return;
+        }
+        applySocketWrite(first_sequence + *accepted, (*batch)[*accepted]);
+    });
+
+    // Write Command没有回复，队列已满时整批丢弃
+    if (!submitted) {
+        std::cerr << "Callback queue full, dropped " << batch->size()
+                  << " socket writes on characteristic: " << uuid_ << std::endl;
+    }
+}
+
+void GattCharacteristic::startAsyncSocketWrite(const ByteView& datagram, const AccessOptions& access,
+                                               uint64_t sequence) {
+    // 接收缓冲会被下一次recv覆盖，回调和完成处理使用副本
+    auto held = std::make_shared<ByteValue>(datagram.data(), datagram.size());
+    std::weak_ptr<bool> alive = alive_;
+
+    // Write Command没有回复，拒绝和超时只记录日志
+    auto state = CompletionState::create([this, alive, held, sequence](const CompletionResult& result) {
+        if (alive.expired()) {
+            return;
+        }
+        if (result.timed_out) {
+            std::cerr << "Async write timed out on characteristic: " << uuid_ << std::endl;
+        } else if (!result.success) {
+            std::cerr << "Write rejected by callback" << std::endl;
+        } else {
+            applySocketWrite(sequence, *held);
+        }
+    }, async_timeout_ms_);
+
+    async_write_callback_(ByteView(*held), access, WriteCompletion(state));
+}
+
+void GattCharacteristic::applySocketWrite(uint64_t sequence, const ByteValue& value) {
+    // 完成顺序可能与接收顺序不同，较早的写入不覆盖已经保存的较新写入
+    if (sequence <= applied_write_sequence_) {
+        return;
+    }
+    applied_write_sequence_ = sequence;
+    storeWrittenValue(ValueSnapshot(value));
+}
+
+bool GattCharacteristic::createSocketPair(int fds[2]) {
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) < 0) {
+        std::cerr << "Failed to create socket pair: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+gboolean GattCharacteristic::onWriteSocketEvent(gint fd, GIOCondition condition, gpointer user_data) {
+    GattCharacteristic* characteristic = static_cast<GattCharacteristic*>(user_data);
+
+    // 挂断时先取走缓冲区中剩余的写入
+    bool open = characteristic->drainWriteSocket();
+    if (open && !(condition & (G_IO_HUP | G_IO_ERR))) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    characteristic->write_watch_id_ = 0;
+    characteristic->releaseWrite();
+    return G_SOURCE_REMOVE;
+}
+
+
+void GattCharacteristic::setNotificationScheduler(std::shared_ptr<NotificationScheduler> scheduler) {
+    if (scheduler_ == scheduler) {
+        return;
+    }
+
+    // 待发送的通知转交给新调度器，没有调度器时立即发送
+    bool was_pending = notification_pending_;
+    if (scheduler_) {
+        scheduler_->cancel(this);
+    }
+
+    scheduler_ = scheduler;
+
+    if (was_pending) {
+        scheduleNotification();
+    }
 }
 
-bool GattCharacteristic::exportInterface(GDBusConnection* connection, const std::string& service_path) {
-    if (!connection || registration_id_ != 0) {
-        return false;
+void GattCharacteristic::setNotificationDispatcher(std::shared_ptr<NotificationDispatcher> dispatcher) {
+    if (dispatcher_ == dispatcher) {
+        return;
     }
 
-    connection_ = connection;
-    GError* error = nullptr;
+    // 排队中的通知转交给新分发器，没有分发器时立即发送
+    bool was_pending = dispatch_pending_;
+    if (dispatcher_) {
+        dispatcher_->cancel(this);
+    }
 
-    // 创建方法调用的vtable
-    GDBusInterfaceVTable vtable = {
-        methodCallHandler,
-        nullptr,
-        onGetProperty,
-        nullptr,
-        nullptr
-    };
+    dispatcher_ = dispatcher;
 
-    registration_id_ = g_dbus_connection_register_object(
-        connection,
-        object_path_.c_str(),
-        const_cast<GDBusInterfaceInfo*>(&interface_info_),
-        &vtable,
-        this,
-        nullptr,
-        &error
-    );
+    if (was_pending) {
+        dispatchNotification();
+    }
+}
 
-    if (registration_id_ == 0) {
-        std::cerr << "Failed to register GATT characteristic: " << error->message << std::endl;
-        g_error_free(error);
-        connection_ = nullptr;
-        return false;
+void GattCharacteristic::setPriority(NotificationPriority priority) {
+    if (priority_ == priority) {
+        return;
     }
 
-    std::cout << "GATT characteristic exported at path: " << object_path_
-              << " with UUID: " << uuid_ << std::endl;
-    return true;
-}
+    // 排队中的通知按新优先级重新排队
+    bool was_pending = dispatch_pending_;
+    if (dispatcher_) {
+        dispatcher_->cancel(this);
+    }
 
-void GattCharacteristic::unexportInterface() {
-    if (connection_ && registration_id_ != 0) {
-        g_dbus_connection_unregister_object(connection_, registration_id_);
-        registration_id_ = 0;
-        std::cout << "GATT characteristic unexported: " << uuid_ << std::endl;
+    priority_ = priority;
+
+    if (priority_ == NotificationPriority::CRITICAL && notification_pending_ && scheduler_) {
+        // 升级为CRITICAL时不再等待合并窗口
+        scheduler_->cancel(this);
+        was_pending = true;
     }
-    connection_ = nullptr;
-}
 
-void GattCharacteristic::setValue(const std::vector<uint8_t>& value) {
-    value_ = value;
-    if (notifying_) {
-        notifyValueChanged();
+    if (was_pending) {
+        dispatchNotification();
     }
 }
 
-void GattCharacteristic::notifyValueChanged() {
-    if (!notifying_ || !connection_) {
-        return;
-    }
+void GattCharacteristic::setCoalescingEnabled(bool enabled) {
+    coalescing_enabled_ = enabled;
 
-    GVariant* value_variant = bytesToGvariant(value_);
-    emitPropertyChanged("Value", value_variant);
-    g_variant_unref(value_variant);
+    // 禁用合并时立即发出已合并的最新值
+    if (!enabled && notification_pending_ && scheduler_) {
+        scheduler_->cancel(this);
+        notifyValueChanged();
+    }
 }
 
 std::vector<std::string> GattCharacteristic::getFlags() const {
@@ -161,56 +1236,428 @@ std::vector<std::string> GattCharacteristic::getFlags() const {
     for (const auto& flag : flags_) {
         flags_str.push_back(characteristicFlagsToString(flag));
     }
+
+    // 请求预备写授权：BlueZ在每次Prepare Write时调用WriteValue，长写在执行前已完整组装并可校验
+    if (write_assembler_) {
+        flags_str.push_back("authorize");
+    }
     return flags_str;
 }
 
 GVariant* GattCharacteristic::handleReadValue(GVariant* options) {
-    std::cout << "ReadValue called on characteristic: " << uuid_ << std::endl;
+    AccessOptions access = parseAccessOptions(options);
+    learnMtu(access.device, access.mtu);
+    std::cout << "ReadValue called on characteristic: " << uuid_
+              << " offset: " << access.offset << std::endl;
 
     // 如果设置了读取回调，调用回调获取值
-    if (read_callback_) {
-        // 从选项中获取设备路径（如果有的话）
-        std::string device_path = "";
-        value_ = read_callback_(device_path);
+    if (access.offset == 0 && read_callback_) {
+        value_ = ValueSnapshot(read_callback_(access.device));
+        recordHistory();
+    }
+
+    return readSlice(access);
+}
+
+GVariant* GattCharacteristic::readSlice(const AccessOptions& access) {
+    ValueSnapshot value;
+    if (access.offset == 0) {
+        value = value_;
+    } else {
+        // Read Blob请求沿用首次读取的快照，各段来自同一个值，回调不再调用
+        auto it = long_reads_.find(access.device);
+        value = it != long_reads_.end() ? it->second : value_;
+    }
+
+    if (access.offset > value.size()) {
+        long_reads_.erase(access.device);
+        return nullptr;
+    }
+
+    // 读响应最多携带MTU - 1字节，BlueZ未提供MTU时返回剩余全部数据
+    size_t length = value.size() - access.offset;
+    if (access.mtu > 0) {
+        length = std::min<size_t>(length, access.mtu - 1);
+    }
+
+    // 本次返回后仍有剩余数据时保留快照，读完即释放
+    if (access.offset + length < value.size()) {
+        long_reads_[access.device] = value;
+    } else {
+        long_reads_.erase(access.device);
     }
 
-    return bytesToGvariant(value_);
+    return bytesToGvariant(value.slice(access.offset, length));
 }
 
 bool GattCharacteristic::handleWriteValue(GVariant* value, GVariant* options) {
-    std::cout << "WriteValue called on characteristic: " << uuid_ << std::endl;
+    AccessOptions access = parseAccessOptions(options);
+    learnMtu(access.device, access.mtu);
+    write_error_ = nullptr;
+    std::cout << "WriteValue called on characteristic: " << uuid_
+              << " offset: " << access.offset << std::endl;
+
+    // Prepare Write阶段按偏移组装各段，值在Execute Write时以reliable类型逐段送达
+    if (access.prepare_authorize) {
+        return !write_assembler_ || assembleWrite(access, value);
+    }
 
-    std::vector<uint8_t> new_value = gvariantToBytes(value);
+    // 未启用组装时偏移为0的可靠写片段按普通写入处理
+    if (access.offset > 0 || (write_assembler_ && access.type == "reliable")) {
+        return executeWrite(access, value);
+    }
 
     // 如果设置了写入回调，调用回调
-    if (write_callback_) {
-        std::string device_path = "";
-        if (!write_callback_(device_path, new_value)) {
+    if (write_view_callback_) {
+        // 视图直接指向请求消息中的数组，拒绝时不产生任何复制
+        gsize size = 0;
+        const uint8_t* data = static_cast<const uint8_t*>(
+            g_variant_get_fixed_array(value, &size, sizeof(uint8_t)));
+        if (!write_view_callback_(ByteView(data, size), access)) {
+            std::cerr << "Write rejected by callback" << std::endl;
+            return false;
+        }
+    } else if (write_callback_) {
+        if (!write_callback_(access.device, gvariantToBytes(value))) {
             std::cerr << "Write rejected by callback" << std::endl;
             return false;
         }
     }
 
-    value_ = new_value;
+    applyWrittenValue(value);
+    return true;
+}
+
+void GattCharacteristic::applyWrittenValue(GVariant* value) {
+    // 新值直接共享请求消息中的数据，不复制
+    storeWrittenValue(ValueSnapshot::fromVariant(value));
     std::cout << "Characteristic value updated" << std::endl;
+}
 
-    // 如果启用了通知，发送值更改通知
-    if (notifying_) {
-        notifyValueChanged();
+bool GattCharacteristic::submitReadValue(GVariant* options, GDBusMethodInvocation* invocation) {
+    AccessOptions access = parseAccessOptions(options);
+
+    // 只有需要调用读取回调的首个请求异步处理，Read Blob直接从快照截取
+    if (access.offset != 0) {
+        return false;
+    }
+
+    if (async_read_callback_) {
+        learnMtu(access.device, access.mtu);
+        startAsyncRead(access, invocation);
+        return true;
+    }
+
+    if (!executor_ || !read_callback_) {
+        return false;
+    }
+
+    learnMtu(access.device, access.mtu);
+    std::cout << "ReadValue submitted to executor on characteristic: " << uuid_ << std::endl;
+
+    // 工作线程只使用回调和结果的副本，不访问特征值
+    ReadCallback callback = read_callback_;
+    auto result = std::make_shared<ByteValue>();
+    std::weak_ptr<bool> alive = alive_;
+
+    bool submitted = executor_->submit([callback, result, device = access.device]() {
+        *result = callback(device);
+    }, [this, alive, result, access, invocation]() {
+        if (alive.expired()) {
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                "org.bluez.Error.Failed", "Characteristic removed");
+            return;
+        }
+
+        value_ = ValueSnapshot(*result);
+        recordHistory();
+        returnReadValue(invocation, readSlice(access));
+    });
+
+    if (!submitted) {
+        g_dbus_method_invocation_return_dbus_error(invocation,
+            "org.bluez.Error.Failed", "Callback queue full");
+    }
+    return true;
+}
+
+bool GattCharacteristic::submitWriteValue(GVariant* value, GVariant* options, GDBusMethodInvocation* invocation) {
+    AccessOptions access = parseAccessOptions(options);
+
+    // 预备片段只做组装，在主循环中处理
+    if (access.prepare_authorize) {
+        return false;
+    }
+
+    // 执行片段：异步回调校验完整的值之后才回复，同步回调仍在主循环中调用
+    if (access.offset > 0 || (write_assembler_ && access.type == "reliable")) {
+        return async_write_callback_ && write_assembler_ && submitExecuteWrite(value, access, invocation);
+    }
+
+    if (!async_write_callback_ && (!executor_ || (!write_view_callback_ && !write_callback_))) {
+        return false;
+    }
+
+    learnMtu(access.device, access.mtu);
+
+    if (async_write_callback_) {
+        startAsyncWrite(value, access, invocation);
+        return true;
+    }
+
+    std::cout << "WriteValue submitted to executor on characteristic: " << uuid_ << std::endl;
+
+    // 持有请求中的值直到完成处理，视图在工作线程中始终有效
+    GVariant* held_value = g_variant_ref(value);
+    WriteViewCallback view_callback = write_view_callback_;
+    WriteCallback callback = write_callback_;
+    auto accepted = std::make_shared<bool>(false);
+    std::weak_ptr<bool> alive = alive_;
+
+    bool submitted = executor_->submit([held_value, view_callback, callback, access, accepted]() {
+        gsize size = 0;
+        const uint8_t* data = static_cast<const uint8_t*>(
+            g_variant_get_fixed_array(held_value, &size, sizeof(uint8_t)));
+        if (view_callback) {
+            *accepted = view_callback(ByteView(data, size), access);
+        } else {
+            *accepted = callback(access.device, ByteValue(data, size));
+        }
+    }, [this, alive, held_value, accepted, invocation]() {
+        if (alive.expired()) {
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                "org.bluez.Error.Failed", "Characteristic removed");
+        } else if (*accepted) {
+            applyWrittenValue(held_value);
+            g_dbus_method_invocation_return_value(invocation, nullptr);
+        } else {
+            std::cerr << "Write rejected by callback" << std::endl;
+            g_dbus_method_invocation_return_error(invocation,
+                G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "Write operation failed");
+        }
+        g_variant_unref(held_value);
+    });
+
+    if (!submitted) {
+        g_variant_unref(held_value);
+        g_dbus_method_invocation_return_dbus_error(invocation,
+            "org.bluez.Error.Failed", "Callback queue full");
+    }
+    return true;
+}
+
+void GattCharacteristic::startAsyncRead(const AccessOptions& access, GDBusMethodInvocation* invocation) {
+    std::weak_ptr<bool> alive = alive_;
+
+    auto state = CompletionState::create([this, alive, access, invocation](const CompletionResult& result) {
+        if (alive.expired()) {
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                "org.bluez.Error.Failed", "Characteristic removed");
+            return;
+        }
+
+        if (result.timed_out) {
+            std::cerr << "Async read timed out on characteristic: " << uuid_ << std::endl;
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                "org.bluez.Error.Failed", "Read callback timed out");
+            return;
+        }
+
+        if (!result.success) {
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                attErrorName(result.error), "Read failed");
+            return;
+        }
+
+        value_ = ValueSnapshot(result.value);
+        recordHistory();
+        returnReadValue(invocation, readSlice(access));
+    }, async_timeout_ms_);
+
+    async_read_callback_(access, ReadCompletion(state));
+}
+
+void GattCharacteristic::startAsyncWrite(GVariant* value, const AccessOptions& access,
+                                         GDBusMethodInvocation* invocation) {
+    // 持有请求中的值直到完成，回调返回后视图仍然有效
+    GVariant* held_value = g_variant_ref(value);
+    std::weak_ptr<bool> alive = alive_;
+
+    auto state = CompletionState::create([this, alive, held_value, invocation](const CompletionResult& result) {
+        if (alive.expired()) {
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                "org.bluez.Error.Failed", "Characteristic removed");
+        } else if (result.timed_out) {
+            std::cerr << "Async write timed out on characteristic: " << uuid_ << std::endl;
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                "org.bluez.Error.Failed", "Write callback timed out");
+        } else if (result.success) {
+            applyWrittenValue(held_value);
+            g_dbus_method_invocation_return_value(invocation, nullptr);
+        } else {
+            std::cerr << "Write rejected by callback" << std::endl;
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                attErrorName(result.error), "Write rejected");
+        }
+        g_variant_unref(held_value);
+    }, async_timeout_ms_);
+
+    gsize size = 0;
+    const uint8_t* data = static_cast<const uint8_t*>(
+        g_variant_get_fixed_array(held_value, &size, sizeof(uint8_t)));
+    async_write_callback_(ByteView(data, size), access, WriteCompletion(state));
+}
+
+void GattCharacteristic::returnReadValue(GDBusMethodInvocation* invocation, GVariant* result) {
+    if (result) {
+        // 回复签名为(ay)，元组接管浮动引用
+        g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&result, 1));
+    } else {
+        g_dbus_method_invocation_return_dbus_error(invocation,
+            "org.bluez.Error.InvalidOffset", "Invalid offset");
+    }
+}
+
+bool GattCharacteristic::assembleWrite(const AccessOptions& access, GVariant* value) {
+    gsize size = 0;
+    const uint8_t* data = static_cast<const uint8_t*>(
+        g_variant_get_fixed_array(value, &size, sizeof(uint8_t)));
+
+    return fragmentAccepted(write_assembler_->addFragment(access.device, access.offset, data, size));
+}
+
+bool GattCharacteristic::executeWrite(const AccessOptions& access, GVariant* value) {
+    if (!write_assembler_) {
+        write_error_ = "org.bluez.Error.NotSupported";
+        return false;
+    }
+
+    gsize size = 0;
+    const uint8_t* data = static_cast<const uint8_t*>(
+        g_variant_get_fixed_array(value, &size, sizeof(uint8_t)));
+
+    ByteValue assembled;
+    WriteFragmentStatus status = write_assembler_->executeFragment(access.device, access.offset, data, size, assembled);
+    if (status != WriteFragmentStatus::COMPLETE) {
+        return fragmentAccepted(status);
+    }
+
+    // 回调的结果就是这个片段的回复，拒绝时客户端的Execute Write失败
+    if (!commitAssembledWrite(access, assembled)) {
+        write_assembler_->discard(access.device);
+        return false;
+    }
+    return true;
+}
+
+bool GattCharacteristic::submitExecuteWrite(GVariant* value, const AccessOptions& access,
+                                            GDBusMethodInvocation* invocation) {
+    learnMtu(access.device, access.mtu);
+    write_error_ = nullptr;
+
+    gsize size = 0;
+    const uint8_t* data = static_cast<const uint8_t*>(
+        g_variant_get_fixed_array(value, &size, sizeof(uint8_t)));
+
+    auto assembled = std::make_shared<ByteValue>();
+    WriteFragmentStatus status = write_assembler_->executeFragment(access.device, access.offset, data, size, *assembled);
+    if (status != WriteFragmentStatus::COMPLETE) {
+        if (fragmentAccepted(status)) {
+            g_dbus_method_invocation_return_value(invocation, nullptr);
+        } else {
+            g_dbus_method_invocation_return_dbus_error(invocation, write_error_, "Write operation failed");
+        }
+        return true;
     }
 
+    // BlueZ等待这个片段的回复后才继续执行，回调完成前客户端的Execute Write不会返回
+    std::weak_ptr<bool> alive = alive_;
+    std::string device = access.device;
+    auto state = CompletionState::create([this, alive, assembled, device, invocation](const CompletionResult& result) {
+        if (alive.expired()) {
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                "org.bluez.Error.Failed", "Characteristic removed");
+            return;
+        }
+
+        if (result.success) {
+            applyAssembledValue(*assembled);
+            g_dbus_method_invocation_return_value(invocation, nullptr);
+            return;
+        }
+
+        write_assembler_->discard(device);
+        if (result.timed_out) {
+            std::cerr << "Async long write timed out on characteristic: " << uuid_ << std::endl;
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                "org.bluez.Error.Failed", "Write callback timed out");
+        } else {
+            std::cerr << "Long write rejected by callback" << std::endl;
+            g_dbus_method_invocation_return_dbus_error(invocation,
+                attErrorName(result.error), "Write rejected");
+        }
+    }, async_timeout_ms_);
+
+    async_write_callback_(ByteView(*assembled), access, WriteCompletion(state));
+    return true;
+}
+
+bool GattCharacteristic::fragmentAccepted(WriteFragmentStatus status) {
+    switch (status) {
+        case WriteFragmentStatus::ACCEPTED:
+        case WriteFragmentStatus::COMPLETE:
+            return true;
+        case WriteFragmentStatus::INVALID_OFFSET:
+            write_error_ = "org.bluez.Error.InvalidOffset";
+            return false;
+        case WriteFragmentStatus::INVALID_LENGTH:
+            write_error_ = "org.bluez.Error.InvalidValueLength";
+            return false;
+        default:
+            write_error_ = "org.bluez.Error.Failed";
+            return false;
+    }
+}
+
+bool GattCharacteristic::commitAssembledWrite(const AccessOptions& access, const ByteValue& value) {
+    bool accepted = true;
+    if (write_view_callback_) {
+        accepted = write_view_callback_(ByteView(value), access);
+    } else if (write_callback_) {
+        accepted = write_callback_(access.device, value);
+    }
+
+    if (!accepted) {
+        std::cerr << "Long write rejected by callback" << std::endl;
+        return false;
+    }
+
+    applyAssembledValue(value);
     return true;
 }
 
+void GattCharacteristic::applyAssembledValue(const ByteValue& value) {
+    storeWrittenValue(ValueSnapshot(value));
+    std::cout << "Characteristic value updated by long write (" << value.size() << " bytes)" << std::endl;
+}
+
 void GattCharacteristic::handleStartNotify(const std::string& device_path) {
     std::cout << "StartNotify called on characteristic: " << uuid_
               << " from device: " << device_path << std::endl;
 
-    notifying_ = true;
-    notified_devices_.push_back(device_path);
+    // 信号由BlueZ扇出到所有设备，只有第一个信号订阅者才能单独回放
+    bool first_signal_subscriber = true;
+    for (const auto& entry : subscribers_) {
+        if (!entry.second->hasSocket()) {
+            first_signal_subscriber = false;
+            break;
+        }
+    }
 
-    if (notify_callback_) {
-        notify_callback_(device_path, true);
+    bool is_new = subscribers_.find(device_path) == subscribers_.end();
+    SubscriberSession* session = addSubscriber(device_path);
+    if (is_new && first_signal_subscriber) {
+        replayHistory(session);
     }
 }
 
@@ -218,68 +1665,150 @@ void GattCharacteristic::handleStopNotify(const std::string& device_path) {
     std::cout << "StopNotify called on characteristic: " << uuid_
               << " from device: " << device_path << std::endl;
 
-    auto it = std::find(notified_devices_.begin(), notified_devices_.end(), device_path);
-    if (it != notified_devices_.end()) {
-        notified_devices_.erase(it);
+    removeSubscriber(device_path);
+}
+
+void GattCharacteristic::handleConfirm(const std::string& caller) {
+    if (indication_queue_) {
+        indication_queue_->confirm(caller);
+    }
+}
+
+void GattCharacteristic::handleAcquireNotify(GVariant* options, GDBusMethodInvocation* invocation) {
+    if (!hasFlag(CharacteristicFlags::NOTIFY)) {
+        g_dbus_method_invocation_return_dbus_error(invocation,
+            "org.bluez.Error.NotSupported", "Characteristic does not support notifications");
+        return;
     }
 
-    if (notified_devices_.empty()) {
-        notifying_ = false;
+    const gchar* device = nullptr;
+    guint16 mtu = DEFAULT_ATT_MTU;
+    g_variant_lookup(options, "device", "&o", &device);
+    g_variant_lookup(options, "mtu", "q", &mtu);
+
+    std::string device_path = device ? device : "";
+    int remote_fd = acquireNotify(device_path, mtu);
+    if (remote_fd < 0) {
+        g_dbus_method_invocation_return_dbus_error(invocation,
+            "org.bluez.Error.Failed", "Notify socket unavailable");
+        return;
     }
 
-    if (notify_callback_) {
-        notify_callback_(device_path, false);
+    if (!returnAcquiredSocket(invocation, remote_fd, getNotifyMtu(device_path))) {
+        releaseNotify(device_path);
+        return;
+    }
+
+    // 套接字对在BlueZ取走描述符前也能缓存数据，回放可以立即入队
+    auto it = subscribers_.find(device_path);
+    if (it != subscribers_.end()) {
+        replayHistory(it->second.get());
     }
 }
 
-void GattCharacteristic::emitPropertyChanged(const std::string& property_name, GVariant* value) {
-    if (!connection_) {
+void GattCharacteristic::handleAcquireWrite(GVariant* options, GDBusMethodInvocation* invocation) {
+    if (!hasFlag(CharacteristicFlags::WRITE_WITHOUT_RESPONSE)) {
+        g_dbus_method_invocation_return_dbus_error(invocation,
+            "org.bluez.Error.NotSupported", "Characteristic does not support write without response");
         return;
     }
 
-    GError* error = nullptr;
-    GDBusMessage* message = g_dbus_message_new_signal(
-        object_path_.c_str(),
-        "org.freedesktop.DBus.Properties",
-        "PropertiesChanged"
-    );
+    const gchar* device = nullptr;
+    guint16 mtu = DEFAULT_ATT_MTU;
+    g_variant_lookup(options, "device", "&o", &device);
+    g_variant_lookup(options, "mtu", "q", &mtu);
+
+    std::string device_path = device ? device : "";
+    int remote_fd = acquireWrite(device_path, mtu);
+    if (remote_fd < 0) {
+        g_dbus_method_invocation_return_dbus_error(invocation,
+            "org.bluez.Error.Failed", "Write socket unavailable");
+        return;
+    }
 
-    GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
-    g_variant_builder_add(builder, "{sv}", property_name.c_str(), value);
-    GVariant* properties = g_variant_new("a{sv}", builder);
-    g_variant_builder_unref(builder);
+    if (!returnAcquiredSocket(invocation, remote_fd, write_mtu_)) {
+        releaseWrite();
+    }
+}
 
-    GVariant* parameters = g_variant_new("(sa{sv}as)",
-        "org.bluez.GattCharacteristic1", properties, nullptr);
+bool GattCharacteristic::returnAcquiredSocket(GDBusMethodInvocation* invocation, int remote_fd, uint16_t mtu) {
+    // fd列表复制了描述符，本地副本可以立即关闭
+    GError* error = nullptr;
+    GUnixFDList* fd_list = g_unix_fd_list_new();
+    gint handle = g_unix_fd_list_append(fd_list, remote_fd, &error);
+    close(remote_fd);
 
-    g_dbus_message_set_body(message, parameters);
+    if (handle < 0) {
+        std::cerr << "Failed to pass acquired socket: " << error->message << std::endl;
+        g_error_free(error);
+        g_object_unref(fd_list);
+        g_dbus_method_invocation_return_dbus_error(invocation,
+            "org.bluez.Error.Failed", "Socket unavailable");
+        return false;
+    }
 
-    gboolean sent = g_dbus_connection_send_message(connection_, message,
-        G_DBUS_SEND_MESSAGE_FLAGS_NONE, &error);
+    g_dbus_method_invocation_return_value_with_unix_fd_list(invocation,
+        g_variant_new("(hq)", handle, mtu), fd_list);
+    g_object_unref(fd_list);
+    return true;
+}
 
-    g_object_unref(message);
+bool GattCharacteristic::emitPropertyChanged(const std::string& property_name, GVariant* value) {
+    if (!connection_) {
+        g_variant_unref(g_variant_ref_sink(value));
+        return false;
+    }
 
-    if (!sent) {
-        std::cerr << "Failed to emit PropertyChanged signal: " << error->message << std::endl;
-        g_error_free(error);
+    // 每个属性的信号模板只构建一次
+    auto it = signal_templates_.find(property_name);
+    if (it == signal_templates_.end()) {
+        it = signal_templates_.emplace(property_name,
+            std::make_unique<PropertiesChangedTemplate>(object_path_, GATT_CHARACTERISTIC_INTERFACE,
+                                                        property_name)).first;
     }
+
+    return it->second->emit(connection_, value);
 }
 
-std::vector<uint8_t> GattCharacteristic::gvariantToBytes(GVariant* variant) {
-    std::vector<uint8_t> bytes;
+ByteValue GattCharacteristic::gvariantToBytes(GVariant* variant) {
+    ByteValue bytes;
     gsize n_elements;
     const uint8_t* data = static_cast<const uint8_t*>(g_variant_get_fixed_array(variant, &n_elements, sizeof(uint8_t)));
 
     if (data) {
-        bytes.assign(data, data + n_elements);
+        bytes.assign(data, n_elements);
     }
 
     return bytes;
 }
 
-GVariant* GattCharacteristic::bytesToGvariant(const std::vector<uint8_t>& bytes) {
-    return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
-                                    bytes.data(), bytes.size(), sizeof(uint8_t));
+GVariant* GattCharacteristic::bytesToGvariant(const ValueSnapshot& bytes) {
+    // 与快照共享内存，并发读取和通知不再各自复制
+    return bytes.toVariant();
+}
+
+AccessOptions parseAccessOptions(GVariant* options) {
+    AccessOptions access;
+    if (!options) {
+        return access;
+    }
+
+    const gchar* device = nullptr;
+    if (g_variant_lookup(options, "device", "&o", &device) && device) {
+        access.device = device;
+    }
+    g_variant_lookup(options, "offset", "q", &access.offset);
+    g_variant_lookup(options, "mtu", "q", &access.mtu);
+
+    const gchar* type = nullptr;
+    if (g_variant_lookup(options, "type", "&s", &type) && type) {
+        access.type = type;
+    }
+
+    gboolean prepare_authorize = FALSE;
+    g_variant_lookup(options, "prepare-authorize", "b", &prepare_authorize);
+    access.prepare_authorize = prepare_authorize;
+    return access;
 }
 
 std::string characteristicFlagsToString(CharacteristicFlags flag) {
@@ -310,75 +1839,124 @@ void GattCharacteristic::methodCallHandler(GDBusConnection* connection,
                                            const gchar* interface_name,
                                            const gchar* method_name,
                                            GVariant* parameters,
-                                           gpointer user_data,
-                                           GDBusMethodInvocation* invocation) {
+                                           GDBusMethodInvocation* invocation,
+                                           gpointer user_data) {
     GattCharacteristic* characteristic = static_cast<GattCharacteristic*>(user_data);
 
-    if (g_strcmp0(method_name, "ReadValue") == 0) {
-        GVariant* options = g_variant_get_child_value(parameters, 0);
-        GVariant* result = characteristic->handleReadValue(options);
-        g_dbus_method_invocation_return_value(invocation, result);
-        g_variant_unref(result);
-        g_variant_unref(options);
-    } else if (g_strcmp0(method_name, "WriteValue") == 0) {
-        GVariant* value = g_variant_get_child_value(parameters, 0);
-        GVariant* options = g_variant_get_child_value(parameters, 1);
-
-        bool success = characteristic->handleWriteValue(value, options);
-        if (success) {
-            g_dbus_method_invocation_return_value(invocation, nullptr);
-        } else {
-            g_dbus_method_invocation_return_error(invocation,
-                G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "Write operation failed");
-        }
-
-        g_variant_unref(value);
-        g_variant_unref(options);
-    } else if (g_strcmp0(method_name, "StartNotify") == 0) {
-        characteristic->handleStartNotify(sender);
-        g_dbus_method_invocation_return_value(invocation, nullptr);
-    } else if (g_strcmp0(method_name, "StopNotify") == 0) {
-        characteristic->handleStopNotify(sender);
-        g_dbus_method_invocation_return_value(invocation, nullptr);
-    } else {
+    CharacteristicMethod method;
+    if (!CHARACTERISTIC_METHODS.find(method_name, method)) {
         g_dbus_method_invocation_return_error(invocation,
             G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD, "Unknown method");
+        return;
     }
 
-    return nullptr;
+    switch (method) {
+        case CharacteristicMethod::READ_VALUE: {
+            GVariant* options = g_variant_get_child_value(parameters, 0);
+            if (!characteristic->submitReadValue(options, invocation)) {
+                returnReadValue(invocation, characteristic->handleReadValue(options));
+            }
+            g_variant_unref(options);
+            break;
+        }
+        case CharacteristicMethod::WRITE_VALUE: {
+            // 服务事务进行中拒绝新的写入请求，客户端稍后重试
+            if (characteristic->staging_) {
+                g_dbus_method_invocation_return_dbus_error(invocation,
+                    "org.bluez.Error.InProgress", "Service transaction in progress");
+                break;
+            }
+
+            GVariant* value = g_variant_get_child_value(parameters, 0);
+            GVariant* options = g_variant_get_child_value(parameters, 1);
+
+            if (characteristic->submitWriteValue(value, options, invocation)) {
+                g_variant_unref(value);
+                g_variant_unref(options);
+                break;
+            }
+
+            bool success = characteristic->handleWriteValue(value, options);
+            if (success) {
+                g_dbus_method_invocation_return_value(invocation, nullptr);
+            } else if (characteristic->write_error_) {
+                g_dbus_method_invocation_return_dbus_error(invocation,
+                    characteristic->write_error_, "Write operation failed");
+            } else {
+                g_dbus_method_invocation_return_error(invocation,
+                    G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "Write operation failed");
+            }
+
+            g_variant_unref(value);
+            g_variant_unref(options);
+            break;
+        }
+        case CharacteristicMethod::START_NOTIFY:
+            characteristic->handleStartNotify(sender);
+            g_dbus_method_invocation_return_value(invocation, nullptr);
+            break;
+        case CharacteristicMethod::STOP_NOTIFY:
+            characteristic->handleStopNotify(sender);
+            g_dbus_method_invocation_return_value(invocation, nullptr);
+            break;
+        case CharacteristicMethod::CONFIRM:
+            characteristic->handleConfirm(sender);
+            g_dbus_method_invocation_return_value(invocation, nullptr);
+            break;
+        case CharacteristicMethod::ACQUIRE_WRITE: {
+            GVariant* options = g_variant_get_child_value(parameters, 0);
+            characteristic->handleAcquireWrite(options, invocation);
+            g_variant_unref(options);
+            break;
+        }
+        case CharacteristicMethod::ACQUIRE_NOTIFY: {
+            GVariant* options = g_variant_get_child_value(parameters, 0);
+            characteristic->handleAcquireNotify(options, invocation);
+            g_variant_unref(options);
+            break;
+        }
+    }
 }
 
-gboolean GattCharacteristic::onGetProperty(GDBusConnection* connection,
-                                         const gchar* sender,
-                                         const gchar* object_path,
-                                         const gchar* interface_name,
-                                         const gchar* property_name,
-                                         GVariant** value,
-                                         GError** error,
-                                         gpointer user_data) {
+GVariant* GattCharacteristic::onGetProperty(GDBusConnection* connection,
+                                            const gchar* sender,
+                                            const gchar* object_path,
+                                            const gchar* interface_name,
+                                            const gchar* property_name,
+                                            GError** error,
+                                            gpointer user_data) {
     GattCharacteristic* characteristic = static_cast<GattCharacteristic*>(user_data);
 
-    if (g_strcmp0(property_name, "UUID") == 0) {
-        *value = g_variant_new_string(characteristic->uuid_.c_str());
-        return TRUE;
-    } else if (g_strcmp0(property_name, "Flags") == 0) {
-        std::vector<std::string> flags = characteristic->getFlags();
-        GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("as"));
-        for (const auto& flag : flags) {
-            g_variant_builder_add(builder, "s", flag.c_str());
-        }
-        *value = g_variant_new("as", builder);
-        g_variant_builder_unref(builder);
-        return TRUE;
-    } else if (g_strcmp0(property_name, "Notifying") == 0) {
-        *value = g_variant_new_boolean(characteristic->notifying_);
-        return TRUE;
-    } else if (g_strcmp0(property_name, "Value") == 0) {
-        *value = characteristic->bytesToGvariant(characteristic->value_);
-        return TRUE;
-    }
-
-    return FALSE;
+    CharacteristicProperty property;
+    if (!CHARACTERISTIC_PROPERTIES.find(property_name, property)) {
+        g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY, "Unknown property: %s", property_name);
+        return nullptr;
+    }
+
+    switch (property) {
+        case CharacteristicProperty::UUID:
+            return g_variant_new_string(characteristic->uuid_.c_str());
+        case CharacteristicProperty::FLAGS: {
+            std::vector<std::string> flags = characteristic->getFlags();
+            GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("as"));
+            for (const auto& flag : flags) {
+                g_variant_builder_add(builder, "s", flag.c_str());
+            }
+            GVariant* value = g_variant_new("as", builder);
+            g_variant_builder_unref(builder);
+            return value;
+        }
+        case CharacteristicProperty::NOTIFYING:
+            return g_variant_new_boolean(characteristic->isNotifying());
+        case CharacteristicProperty::VALUE:
+            return characteristic->bytesToGvariant(characteristic->value_);
+        case CharacteristicProperty::WRITE_ACQUIRED:
+            return g_variant_new_boolean(characteristic->write_fd_ >= 0);
+        case CharacteristicProperty::NOTIFY_ACQUIRED:
+            return g_variant_new_boolean(characteristic->isNotifyAcquired());
+    }
+
+    return nullptr;
 }
 
 } // namespace Bluetooth
\ No newline at end of file
@@ -1,37 +1,49 @@
 #include "gatt_service.h"
 #include "gatt_characteristic.h"
+#include "dbus_dispatch.h"
 #include <iostream>
 #include <glib-2.0/glib.h>
 
 namespace Bluetooth {
 
-// D-Bus接口静态成员定义
-const GDBusPropertyInfo GattService::interface_properties[] = {
-    { "UUID", "s", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "Primary", "b", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { "Characteristics", "ao", G_DBUS_PROPERTY_INFO_FLAGS_READABLE },
-    { nullptr, nullptr, G_DBUS_PROPERTY_INFO_FLAGS_NONE }
-};
-
-const GDBusInterfaceInfo GattService::interface_info_ = {
-    -1,
-    "org.bluez.GattService1",
-    nullptr,
-    nullptr,
-    interface_properties,
-    nullptr
-};
+// D-Bus接口定义
+static const gchar* const SERVICE_INTROSPECTION_XML =
+    "<node>"
+    "  <interface name='org.bluez.GattService1'>"
+    "    <property name='UUID' type='s' access='read'/>"
+    "    <property name='Primary' type='b' access='read'/>"
+    "    <property name='Characteristics' type='ao' access='read'/>"
+    "  </interface>"
+    "</node>";
 
 const GDBusInterfaceVTable GattService::interface_vtable_ = {
-    nullptr,
     nullptr,
     onGetProperty,
-    nullptr,
     nullptr
 };
 
+GDBusInterfaceInfo* GattService::interfaceInfo() {
+    // 内省数据只解析一次，所有服务共享
+    static GDBusNodeInfo* node_info = g_dbus_node_info_new_for_xml(SERVICE_INTROSPECTION_XML, nullptr);
+    return node_info ? node_info->interfaces[0] : nullptr;
+}
+
+// 属性名的分派表，编译期生成完美哈希
+enum class ServiceProperty {
+    UUID,
+    PRIMARY,
+    CHARACTERISTICS
+};
+
+constexpr auto SERVICE_PROPERTIES = makeNameTable<ServiceProperty>({
+    { "UUID", ServiceProperty::UUID },
+    { "Primary", ServiceProperty::PRIMARY },
+    { "Characteristics", ServiceProperty::CHARACTERISTICS }
+});
+static_assert(SERVICE_PROPERTIES.isValid(), "No perfect hash seed for service properties");
+
 GattService::GattService(const std::string& uuid, bool primary, const std::string& object_path_prefix)
-    : uuid_(uuid), primary_(primary), connection_(nullptr), registration_id_(0) {
+    : uuid_(uuid), primary_(primary), connection_(nullptr), registration_id_(0), transaction_depth_(0) {
 
     // 生成唯一对象路径
     static int service_counter = 0;
@@ -53,8 +65,8 @@ bool GattService::exportInterface(GDBusConnection* connection, const std::string
     registration_id_ = g_dbus_connection_register_object(
         connection,
         object_path_.c_str(),
-        const_cast<GDBusInterfaceInfo*>(&interface_info_),
-        const_cast<GDBusInterfaceVTable*>(&interface_vtable_),
+        interfaceInfo(),
+        &interface_vtable_,
         this,
         nullptr,
         &error
@@ -92,12 +104,63 @@ bool GattService::addCharacteristic(std::shared_ptr<GattCharacteristic> characte
         return false;
     }
 
+    // 事务中加入的特征值同样参与暂存
+    if (transaction_depth_ > 0) {
+        characteristic->beginStaging();
+    }
+
     characteristics_.push_back(characteristic);
     std::cout << "Added characteristic: " << characteristic->getUUID()
               << " to service: " << uuid_ << std::endl;
     return true;
 }
 
+void GattService::beginTransaction() {
+    if (transaction_depth_++ > 0) {
+        return;
+    }
+
+    for (const auto& characteristic : characteristics_) {
+        characteristic->beginStaging();
+    }
+}
+
+bool GattService::commitTransaction() {
+    if (transaction_depth_ == 0) {
+        return false;
+    }
+
+    if (--transaction_depth_ > 0) {
+        return true;
+    }
+
+    // 第一阶段：替换所有值，任何通知发出前读取者已能看到完整的新快照
+    std::vector<GattCharacteristic*> changed;
+    for (const auto& characteristic : characteristics_) {
+        if (characteristic->commitStaging()) {
+            changed.push_back(characteristic.get());
+        }
+    }
+
+    // 第二阶段：PropertiesChanged无法跨对象合并，在同一轮分发中连续发出
+    for (GattCharacteristic* characteristic : changed) {
+        characteristic->flushStagedNotification();
+    }
+
+    return true;
+}
+
+void GattService::rollbackTransaction() {
+    if (transaction_depth_ == 0) {
+        return;
+    }
+
+    transaction_depth_ = 0;
+    for (const auto& characteristic : characteristics_) {
+        characteristic->discardStaging();
+    }
+}
+
 GVariant* GattService::getCharacteristicList() {
     GVariantBuilder* builder = g_variant_builder_new(G_VARIANT_TYPE("ao"));
 
@@ -110,28 +173,31 @@ GVariant* GattService::getCharacteristicList() {
     return result;
 }
 
-gboolean GattService::onGetProperty(GDBusConnection* connection,
-                                   const gchar* sender,
-                                   const gchar* object_path,
-                                   const gchar* interface_name,
-                                   const gchar* property_name,
-                                   GVariant** value,
-                                   GError** error,
-                                   gpointer user_data) {
+GVariant* GattService::onGetProperty(GDBusConnection* connection,
+                                     const gchar* sender,
+                                     const gchar* object_path,
+                                     const gchar* interface_name,
+                                     const gchar* property_name,
+                                     GError** error,
+                                     gpointer user_data) {
     GattService* service = static_cast<GattService*>(user_data);
 
-    if (g_strcmp0(property_name, "UUID") == 0) {
-        *value = g_variant_new_string(service->uuid_.c_str());
-        return TRUE;
-    } else if (g_strcmp0(property_name, "Primary") == 0) {
-        *value = g_variant_new_boolean(service->primary_);
-        return TRUE;
-    } else if (g_strcmp0(property_name, "Characteristics") == 0) {
-        *value = service->getCharacteristicList();
-        return TRUE;
+    ServiceProperty property;
+    if (!SERVICE_PROPERTIES.find(property_name, property)) {
+        g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY, "Unknown property: %s", property_name);
+        return nullptr;
+    }
+
+    switch (property) {
+        case ServiceProperty::UUID:
+            return g_variant_new_string(service->uuid_.c_str());
+        case ServiceProperty::PRIMARY:
+            return g_variant_new_boolean(service->primary_);
+        case ServiceProperty::CHARACTERISTICS:
+            return service->getCharacteristicList();
     }
 
-    return FALSE;
+    return nullptr;
 }
 
 } // namespace Bluetooth
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "indication_queue.h"
+#include <iostream>
+#include <algorithm>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+// 没有接收方时发送的指示由任意调用者的Confirm完成
+static const std::string ANY_RECIPIENT;
+
+IndicationQueue::IndicationQueue(SendFunction send_function, RecipientsFunction recipients_function)
+    : send_function_(send_function), recipients_function_(recipients_function), next_id_(1), timer_id_(0) {
+}
+
+IndicationQueue::~IndicationQueue() {
+    if (timer_id_ != 0) {
+        g_source_remove(timer_id_);
+        timer_id_ = 0;
+    }
+}
+
+void IndicationQueue::setConfig(const IndicationConfig& config) {
+    config_ = config;
+    if (config_.window == 0) {
+        config_.window = 1;
+    }
+    if (config_.confirms_per_recipient == 0) {
+        config_.confirms_per_recipient = 1;
+    }
+
+    // 窗口扩大后立即发送等待中的指示
+    pump();
+    armTimer();
+}
+
+uint64_t IndicationQueue::submit(const ValueSnapshot& value, IndicationCallback callback, uint64_t reserved_id) {
+    if (in_flight_.size() >= config_.window && pending_.size() >= config_.max_pending) {
+        stats_.rejected++;
+        return 0;
+    }
+
+    Indication indication;
+    indication.id = reserved_id != 0 ? reserved_id : next_id_++;
+    indication.value = value;
+    indication.callback = callback;
+    indication.retries = 0;
+    indication.deadline = 0;
+    indication.partially_confirmed = false;
+
+    uint64_t id = indication.id;
+    pending_.push_back(std::move(indication));
+    pump();
+    armTimer();
+    return id;
+}
+
+bool IndicationQueue::confirm(const std::string& recipient) {
+    // 每个接收方按发送顺序确认，记入它最旧的未确认指示；未知调用者记入等待任意确认的指示
+    for (const std::string* key : { &recipient, &ANY_RECIPIENT }) {
+        for (auto& indication : in_flight_) {
+            auto it = indication.awaiting.find(*key);
+            if (it == indication.awaiting.end()) {
+                continue;
+            }
+
+            if (--it->second == 0) {
+                indication.awaiting.erase(it);
+            }
+            indication.partially_confirmed = true;
+            retireConfirmed();
+            return true;
+        }
+    }
+
+    std::cerr << "Confirm from " << recipient << " with no outstanding indication" << std::endl;
+    return false;
+}
+
+void IndicationQueue::removeRecipient(const std::string& recipient) {
+    bool changed = false;
+    for (auto& indication : in_flight_) {
+        changed = indication.awaiting.erase(recipient) > 0 || changed;
+    }
+
+    if (changed) {
+        retireConfirmed();
+    }
+}
+
+void IndicationQueue::retireConfirmed() {
+    std::deque<Indication> still_in_flight;
+    std::vector<Indication> confirmed;
+
+    for (auto& indication : in_flight_) {
+        if (indication.awaiting.empty()) {
+            confirmed.push_back(std::move(indication));
+        } else {
+            still_in_flight.push_back(std::move(indication));
+        }
+    }
+
+    in_flight_.swap(still_in_flight);
+    if (confirmed.empty()) {
+        return;
+    }
+
+    stats_.confirmed += confirmed.size();
+    pump();
+    armTimer();
+
+    for (auto& indication : confirmed) {
+        complete(std::move(indication), IndicationStatus::CONFIRMED);
+    }
+}
+
+void IndicationQueue::cancelAll() {
+    if (timer_id_ != 0) {
+        g_source_remove(timer_id_);
+        timer_id_ = 0;
+    }
+
+    std::deque<Indication> cancelled;
+    cancelled.swap(in_flight_);
+    for (auto& indication : pending_) {
+        cancelled.push_back(std::move(indication));
+    }
+    pending_.clear();
+
+    for (auto& indication : cancelled) {
+        complete(std::move(indication), IndicationStatus::CANCELLED);
+    }
+}
+
+IndicationStatistics IndicationQueue::getStatistics() const {
+    IndicationStatistics stats = stats_;
+    stats.in_flight = in_flight_.size();
+    stats.pending = pending_.size();
+    return stats;
+}
+
+void IndicationQueue::pump() {
+    while (in_flight_.size() < config_.window && !pending_.empty()) {
+        Indication& indication = pending_.front();
+
+        // 接收方在首次发送时确定，之后加入的订阅者不必确认此前的指示
+        std::vector<std::string> recipients = recipients_function_ ? recipients_function_()
+                                                                   : std::vector<std::string>();
+        if (recipients.empty()) {
+            recipients.push_back(ANY_RECIPIENT);
+        }
+        for (const auto& recipient : recipients) {
+            indication.awaiting[recipient] = config_.confirms_per_recipient;
+        }
+
+        in_flight_.push_back(std::move(indication));
+        pending_.pop_front();
+        transmit(in_flight_.back());
+    }
+}
+
+void IndicationQueue::transmit(Indication& indication) {
+    // 发送失败同样等待超时重发，链路恢复后仍可送达
+    send_function_(indication.value);
+    indication.deadline = g_get_monotonic_time() + static_cast<gint64>(config_.timeout_ms) * 1000;
+}
+
+void IndicationQueue::complete(Indication indication, IndicationStatus status) {
+    if (indication.callback) {
+        indication.callback(indication.id, status);
+    }
+}
+
+void IndicationQueue::armTimer() {
+    if (timer_id_ != 0) {
+        g_source_remove(timer_id_);
+        timer_id_ = 0;
+    }
+
+    if (in_flight_.empty()) {
+        return;
+    }
+
+    gint64 earliest = in_flight_.front().deadline;
+    for (const auto& indication : in_flight_) {
+        earliest = std::min(earliest, indication.deadline);
+    }
+
+    gint64 delay_us = std::max<gint64>(earliest - g_get_monotonic_time(), 0);
+    timer_id_ = g_timeout_add(static_cast<guint>(delay_us / 1000) + 1, onTimeout, this);
+}
+
+void IndicationQueue::handleTimeouts() {
+    gint64 now = g_get_monotonic_time();
+    std::deque<Indication> still_in_flight;
+    std::deque<Indication> retransmit;
+    std::vector<Indication> failed;
+
+    for (auto& indication : in_flight_) {
+        if (indication.deadline > now) {
+            still_in_flight.push_back(std::move(indication));
+        } else if (indication.retries < config_.max_retries) {
+            retransmit.push_back(std::move(indication));
+        } else {
+            failed.push_back(std::move(indication));
+        }
+    }
+
+    // 重发的指示排到窗口末尾，与BlueZ的确认顺序保持一致
+    for (auto& indication : retransmit) {
+        indication.retries++;
+        still_in_flight.push_back(std::move(indication));
+        Indication& retry = still_in_flight.back();
+
+        // 信号是广播：已有接收方确认时重发会让它们重复收到，只延长等待
+        if (retry.partially_confirmed) {
+            stats_.partial_timeouts++;
+            retry.deadline = now + static_cast<gint64>(config_.timeout_ms) * 1000;
+        } else {
+            stats_.retransmitted++;
+            transmit(retry);
+        }
+    }
+    in_flight_.swap(still_in_flight);
+
+    stats_.timed_out += failed.size();
+    pump();
+    armTimer();
+
+    for (auto& indication : failed) {
+        std::cerr << "Indication " << indication.id << " timed out after "
+                  << indication.retries << " retries" << std::endl;
+        complete(std::move(indication), IndicationStatus::TIMED_OUT);
+    }
+}
+
+gboolean IndicationQueue::onTimeout(gpointer user_data) {
+    IndicationQueue* queue = static_cast<IndicationQueue*>(user_data);
+
+    // 源在返回G_SOURCE_REMOVE后自动销毁，handleTimeouts会按需重新安排
+    queue->timer_id_ = 0;
+    queue->handleTimeouts();
+    return G_SOURCE_REMOVE;
+}
+
+} // namespace Bluetooth
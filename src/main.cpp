@@ -3,6 +3,10 @@
 #include "gatt_service.h"
 #include "gatt_characteristic.h"
 #include "advertisement_manager.h"
+#include "notification_scheduler.h"
+#include "notification_dispatcher.h"
+#include "value_store.h"
+#include "callback_executor.h"
 #include <iostream>
 #include <signal.h>
 #include <unistd.h>
@@ -22,7 +26,7 @@ void signalHandler(int signal) {
 }
 
 // 电池电量特征值读取回调
-std::vector<uint8_t> readBatteryLevel(const std::string& device_path) {
+Bluetooth::ByteValue readBatteryLevel(const std::string& device_path) {
     // 模拟电池电量（实际应用中可以从系统获取）
     static uint8_t battery_level = 85;
     battery_level = (battery_level % 100) + 1; // 循环变化
@@ -31,8 +35,16 @@ std::vector<uint8_t> readBatteryLevel(const std::string& device_path) {
     return {battery_level};
 }
 
+#ifdef BLUETOOTH_COROUTINES
+// 协程版电量读取：等待模拟的传感器采样时间，期间主循环继续处理其他请求
+Bluetooth::CoTask readBatteryLevelAsync(Bluetooth::AccessOptions options, Bluetooth::ReadCompletion completion) {
+    co_await Bluetooth::sleepFor(20);
+    completion.complete(readBatteryLevel(options.device));
+}
+#endif
+
 // 电池电量写入回调
-bool writeBatteryLevel(const std::string& device_path, const std::vector<uint8_t>& value) {
+bool writeBatteryLevel(const std::string& device_path, const Bluetooth::ByteValue& value) {
     if (!value.empty()) {
         std::cout << "Battery level set to: " << (int)value[0] << "%" << std::endl;
         return true;
@@ -50,14 +62,14 @@ void batteryNotifyCallback(const std::string& device_path, bool subscribing) {
 }
 
 // 计数器特征值读取回调
-std::vector<uint8_t> readCounter(const std::string& device_path) {
+Bluetooth::ByteValue readCounter(const std::string& device_path) {
     static uint32_t counter = 0;
     counter++;
 
     std::cout << "Counter value requested: " << counter << std::endl;
 
     // 将32位计数器转换为字节数组
-    std::vector<uint8_t> result(4);
+    Bluetooth::ByteValue result(4);
     result[0] = counter & 0xFF;
     result[1] = (counter >> 8) & 0xFF;
     result[2] = (counter >> 16) & 0xFF;
@@ -67,7 +79,7 @@ std::vector<uint8_t> readCounter(const std::string& device_path) {
 }
 
 // 计数器写入回调
-bool writeCounter(const std::string& device_path, const std::vector<uint8_t>& value) {
+bool writeCounter(const Bluetooth::ByteView& value, const Bluetooth::AccessOptions& options) {
     if (value.size() >= 4) {
         uint32_t counter = value[0] | (value[1] << 8) | (value[2] << 16) | (value[3] << 24);
         std::cout << "Counter set to: " << counter << std::endl;
@@ -82,7 +94,11 @@ gboolean updateBatteryLevel(gpointer user_data) {
     battery_level = (battery_level % 100) + 1;
 
     if (battery_characteristic) {
-        battery_characteristic->setValue({battery_level});
+        // 特征值属于D-Bus分发上下文，经无锁队列交给它更新
+        Bluetooth::ByteValue value{battery_level};
+        bluez_interface->post([value]() {
+            battery_characteristic->setValue(value);
+        });
         std::cout << "Battery level updated: " << (int)battery_level << "%" << std::endl;
     }
 
@@ -96,19 +112,29 @@ gboolean updateCounter(gpointer user_data) {
 
     if (counter_characteristic) {
         // 将32位计数器转换为字节数组
-        std::vector<uint8_t> counter_bytes(4);
+        Bluetooth::ByteValue counter_bytes(4);
         counter_bytes[0] = counter & 0xFF;
         counter_bytes[1] = (counter >> 8) & 0xFF;
         counter_bytes[2] = (counter >> 16) & 0xFF;
         counter_bytes[3] = (counter >> 24) & 0xFF;
 
-        counter_characteristic->setValue(counter_bytes);
+        bluez_interface->post([counter_bytes]() {
+            counter_characteristic->setValue(counter_bytes);
+        });
         std::cout << "Counter updated: " << counter << std::endl;
     }
 
     return TRUE; // 继续定时器
 }
 
+// 在应用主循环上下文中添加秒级定时器
+void addApplicationTimer(GMainContext* context, guint interval_seconds, GSourceFunc callback) {
+    GSource* source = g_timeout_source_new_seconds(interval_seconds);
+    g_source_set_callback(source, callback, nullptr, nullptr);
+    g_source_attach(source, context);
+    g_source_unref(source);
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "=== Bluetooth GATT Server Demo ===" << std::endl;
     std::cout << "Starting BLE GATT Server with Battery Service..." << std::endl;
@@ -117,9 +143,19 @@ int main(int argc, char* argv[]) {
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
 
+    // --dispatch-thread：D-Bus在独立线程中分发，应用逻辑（定时更新、读写回调）运行在自己的主循环上下文，
+    // 应用线程的CPU负载不再延迟BlueZ请求
+    bool use_dispatch_thread = false;
+    for (int i = 1; i < argc; ++i) {
+        if (g_strcmp0(argv[i], "--dispatch-thread") == 0) {
+            use_dispatch_thread = true;
+        }
+    }
+    GMainContext* app_context = use_dispatch_thread ? g_main_context_new() : nullptr;
+
     // 初始化GLib
     g_main_loop_new(nullptr, FALSE);
-    main_loop = g_main_loop_new(nullptr, FALSE);
+    main_loop = g_main_loop_new(app_context, FALSE);
 
     try {
         // 创建BlueZ接口
@@ -146,6 +182,25 @@ int main(int argc, char* argv[]) {
         // 创建GATT应用
         auto app = std::make_shared<Bluetooth::GattApplication>("/org/bluez/example/gatt");
 
+        // 创建通知合并调度器：100ms窗口内的多次更新只通知最新值
+        auto notification_scheduler = std::make_shared<Bluetooth::NotificationScheduler>(100);
+
+        // 创建优先级分发器：交互类更新优先于批量遥测
+        auto notification_dispatcher = std::make_shared<Bluetooth::NotificationDispatcher>();
+
+        // 打开写入持久化存储，注册应用前恢复上次写入的值
+        auto value_store = std::make_shared<Bluetooth::ValueStore>(
+            std::string(g_get_user_data_dir()) + "/bluetooth-gatt-server");
+        if (!value_store->open()) {
+            std::cerr << "Failed to open value store, writes will not be persisted" << std::endl;
+        }
+
+        // 分发线程模式下读写回调在应用上下文中执行
+        std::shared_ptr<Bluetooth::CallbackExecutor> app_executor;
+        if (app_context) {
+            app_executor = std::make_shared<Bluetooth::CallbackExecutor>(app_context);
+        }
+
         // 创建电池服务
         auto battery_service = std::make_shared<Bluetooth::GattService>(
             "0000180f-0000-1000-8000-00805f9b34fb", // 电池服务UUID
@@ -165,6 +220,24 @@ int main(int argc, char* argv[]) {
         battery_characteristic->setReadCallback(readBatteryLevel);
         battery_characteristic->setWriteCallback(writeBatteryLevel);
         battery_characteristic->setNotifyCallback(batteryNotifyCallback);
+        battery_characteristic->setNotificationScheduler(notification_scheduler);
+        battery_characteristic->setNotificationDispatcher(notification_dispatcher);
+        battery_characteristic->setPriority(Bluetooth::NotificationPriority::BULK);
+
+#ifdef BLUETOOTH_COROUTINES
+        // 电量读取作为协程在主循环中执行，等待采样时挂起
+        battery_characteristic->setCoroutineReadHandler(readBatteryLevelAsync);
+#else
+        if (app_executor) {
+            battery_characteristic->setCallbackExecutor(app_executor);
+        } else {
+            // 电量读取在工作线程中执行，慢速的传感器访问不阻塞主循环；模拟读取不是线程安全的，只用一个线程
+            Bluetooth::ExecutorConfig battery_executor_config;
+            battery_executor_config.max_threads = 1;
+            battery_characteristic->setCallbackExecutor(
+                std::make_shared<Bluetooth::CallbackExecutor>(battery_executor_config));
+        }
+#endif
 
         // 设置初始值
         battery_characteristic->setValue({85});
@@ -187,10 +260,24 @@ int main(int argc, char* argv[]) {
 
         // 设置回调函数
         counter_characteristic->setReadCallback(readCounter);
-        counter_characteristic->setWriteCallback(writeCounter);
+        counter_characteristic->setWriteViewCallback(writeCounter);
+        counter_characteristic->setNotificationScheduler(notification_scheduler);
+        counter_characteristic->setNotificationDispatcher(notification_dispatcher);
+        if (app_executor) {
+            counter_characteristic->setCallbackExecutor(app_executor);
+        }
 
-        // 设置初始值
+        // 限制计数器通知速率：每秒最多2次，允许突发4次，超出时推迟发送最新值
+        Bluetooth::RateLimitConfig counter_rate_limit;
+        counter_rate_limit.rate = 2.0;
+        counter_rate_limit.burst = 4.0;
+        counter_characteristic->setRateLimit(counter_rate_limit);
+
+        // 设置初始值，存储中有上次写入的值时覆盖初始值
         counter_characteristic->setValue({0, 0, 0, 1});
+        if (value_store->isOpen()) {
+            counter_characteristic->setValueStore(value_store);
+        }
 
         // 将特征值添加到服务
         battery_service->addCharacteristic(battery_characteristic);
@@ -206,6 +293,11 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+        // 导出对象配置完成后再启动分发线程，此后主线程只通过post()访问它们
+        if (use_dispatch_thread) {
+            bluez_interface->startDispatchThread();
+        }
+
         // 注册GATT应用
         if (!bluez_interface->registerApplication(app.get())) {
             std::cerr << "Failed to register GATT application" << std::endl;
@@ -258,16 +350,21 @@ int main(int argc, char* argv[]) {
         std::cout << "Press Ctrl+C to stop the server..." << std::endl;
 
         // 启动定时器更新特征值
-        g_timeout_add_seconds(10, updateBatteryLevel, nullptr);
-        g_timeout_add_seconds(5, updateCounter, nullptr);
+        addApplicationTimer(app_context, 10, updateBatteryLevel);
+        addApplicationTimer(app_context, 5, updateCounter);
 
         // 运行主循环
         g_main_loop_run(main_loop);
 
         std::cout << "Shutting down GATT Server..." << std::endl;
 
-        // 清理
+        // 清理（先停止分发线程，再提交尚未落盘的写入）
+        bluez_interface->stopDispatchThread();
+        value_store->close();
         g_main_loop_unref(main_loop);
+        if (app_context) {
+            g_main_context_unref(app_context);
+        }
         delete bluez_interface;
 
     } catch (const std::exception& e) {
@@ -0,0 +1,184 @@
+#include "notification_dispatcher.h"
+#include "gatt_characteristic.h"
+#include <algorithm>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+NotificationDispatcher::NotificationDispatcher(const DispatcherConfig& config)
+    : config_(config), interactive_credits_(0), bulk_credits_(0),
+      source_id_(0), source_priority_(G_PRIORITY_DEFAULT) {
+    setConfig(config);
+}
+
+NotificationDispatcher::~NotificationDispatcher() {
+    cancelDispatch();
+
+    // 特征值可能比分发器存活更久，清除其排队标记
+    for (auto& queue : queues_) {
+        for (const Entry& entry : queue) {
+            entry.characteristic->dispatch_pending_ = false;
+        }
+        queue.clear();
+    }
+}
+
+void NotificationDispatcher::setConfig(const DispatcherConfig& config) {
+    config_ = config;
+
+    // 权重为0会让该类别永远得不到发送机会
+    config_.interactive_weight = std::max(config_.interactive_weight, 1u);
+    config_.bulk_weight = std::max(config_.bulk_weight, 1u);
+    config_.batch_limit = std::max<size_t>(config_.batch_limit, 1);
+
+    interactive_credits_ = config_.interactive_weight;
+    bulk_credits_ = config_.bulk_weight;
+}
+
+bool NotificationDispatcher::submit(GattCharacteristic* characteristic) {
+    if (!characteristic || characteristic->dispatch_pending_) {
+        return false;
+    }
+
+    size_t index = static_cast<size_t>(characteristic->getPriority());
+    characteristic->dispatch_pending_ = true;
+    queues_[index].push_back({ characteristic, g_get_monotonic_time() });
+
+    PriorityClassStatistics& stats = stats_[index];
+    stats.max_depth = std::max(stats.max_depth, queues_[index].size());
+
+    scheduleDispatch();
+    return true;
+}
+
+void NotificationDispatcher::cancel(GattCharacteristic* characteristic) {
+    if (!characteristic || !characteristic->dispatch_pending_) {
+        return;
+    }
+
+    characteristic->dispatch_pending_ = false;
+    for (auto& queue : queues_) {
+        queue.erase(std::remove_if(queue.begin(), queue.end(), [characteristic](const Entry& entry) {
+            return entry.characteristic == characteristic;
+        }), queue.end());
+    }
+}
+
+void NotificationDispatcher::flush() {
+    cancelDispatch();
+    while (dispatchOne()) {
+    }
+}
+
+PriorityClassStatistics NotificationDispatcher::getStatistics(NotificationPriority priority) const {
+    size_t index = static_cast<size_t>(priority);
+    PriorityClassStatistics stats = stats_[index];
+    stats.depth = queues_[index].size();
+    return stats;
+}
+
+void NotificationDispatcher::resetStatistics() {
+    for (size_t i = 0; i < NOTIFICATION_PRIORITY_COUNT; ++i) {
+        stats_[i] = PriorityClassStatistics();
+        stats_[i].max_depth = queues_[i].size();
+    }
+}
+
+bool NotificationDispatcher::dispatchOne() {
+    auto& critical = queues_[static_cast<size_t>(NotificationPriority::CRITICAL)];
+    auto& interactive = queues_[static_cast<size_t>(NotificationPriority::INTERACTIVE)];
+    auto& bulk = queues_[static_cast<size_t>(NotificationPriority::BULK)];
+
+    // CRITICAL每次都先检查，发送过程中新到的告警也能插到排队的批量数据之前
+    if (!critical.empty()) {
+        deliver(NotificationPriority::CRITICAL);
+        return true;
+    }
+
+    if (interactive.empty() && bulk.empty()) {
+        return false;
+    }
+
+    // 两个类别的额度都用完（或有额度的类别为空）时开始新的一轮
+    bool interactive_ready = interactive_credits_ > 0 && !interactive.empty();
+    bool bulk_ready = bulk_credits_ > 0 && !bulk.empty();
+    if (!interactive_ready && !bulk_ready) {
+        interactive_credits_ = config_.interactive_weight;
+        bulk_credits_ = config_.bulk_weight;
+        interactive_ready = !interactive.empty();
+    }
+
+    if (interactive_ready) {
+        interactive_credits_--;
+        deliver(NotificationPriority::INTERACTIVE);
+    } else {
+        bulk_credits_--;
+        deliver(NotificationPriority::BULK);
+    }
+    return true;
+}
+
+void NotificationDispatcher::dispatch(size_t limit) {
+    for (size_t sent = 0; sent < limit; ++sent) {
+        if (!dispatchOne()) {
+            return;
+        }
+    }
+
+    // 本次额度用完仍有排队，下一次主循环迭代继续
+    for (const auto& queue : queues_) {
+        if (!queue.empty()) {
+            scheduleDispatch();
+            return;
+        }
+    }
+}
+
+void NotificationDispatcher::deliver(NotificationPriority priority) {
+    size_t index = static_cast<size_t>(priority);
+    Entry entry = queues_[index].front();
+    queues_[index].pop_front();
+
+    gint64 latency = std::max<gint64>(g_get_monotonic_time() - entry.enqueued_at, 0);
+    PriorityClassStatistics& stats = stats_[index];
+    stats.dispatched++;
+    stats.total_latency_us += static_cast<uint64_t>(latency);
+    stats.max_latency_us = std::max(stats.max_latency_us, static_cast<uint64_t>(latency));
+
+    entry.characteristic->dispatch_pending_ = false;
+    entry.characteristic->deliverNotification();
+}
+
+void NotificationDispatcher::scheduleDispatch() {
+    bool has_critical = !queues_[static_cast<size_t>(NotificationPriority::CRITICAL)].empty();
+    gint priority = has_critical ? G_PRIORITY_HIGH : G_PRIORITY_DEFAULT;
+
+    if (source_id_ != 0) {
+        // 已安排的低优先级分发在告警到达时提升优先级
+        if (priority >= source_priority_) {
+            return;
+        }
+        cancelDispatch();
+    }
+
+    source_priority_ = priority;
+    source_id_ = g_idle_add_full(priority, onDispatch, this, nullptr);
+}
+
+void NotificationDispatcher::cancelDispatch() {
+    if (source_id_ != 0) {
+        g_source_remove(source_id_);
+        source_id_ = 0;
+    }
+}
+
+gboolean NotificationDispatcher::onDispatch(gpointer user_data) {
+    NotificationDispatcher* dispatcher = static_cast<NotificationDispatcher*>(user_data);
+
+    // 源在返回G_SOURCE_REMOVE后自动销毁，这里只需清除ID
+    dispatcher->source_id_ = 0;
+    dispatcher->dispatch(dispatcher->config_.batch_limit);
+    return G_SOURCE_REMOVE;
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,115 @@
+#include "notification_scheduler.h"
+#include "gatt_characteristic.h"
+#include <algorithm>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+NotificationScheduler::NotificationScheduler(guint flush_interval_ms)
+    : flush_interval_ms_(flush_interval_ms), source_id_(0), coalesced_count_(0), sent_count_(0) {
+}
+
+NotificationScheduler::~NotificationScheduler() {
+    cancelFlush();
+
+    // 特征值可能比调度器存活更久，清除其待发送标记
+    for (GattCharacteristic* characteristic : pending_) {
+        characteristic->notification_pending_ = false;
+    }
+    pending_.clear();
+}
+
+void NotificationScheduler::setFlushInterval(guint flush_interval_ms) {
+    if (flush_interval_ms_ == flush_interval_ms) {
+        return;
+    }
+
+    flush_interval_ms_ = flush_interval_ms;
+
+    // 按新窗口重新安排已有的刷新
+    if (source_id_ != 0) {
+        cancelFlush();
+        scheduleFlush();
+    }
+}
+
+bool NotificationScheduler::markDirty(GattCharacteristic* characteristic) {
+    if (!characteristic) {
+        return false;
+    }
+
+    if (characteristic->notification_pending_) {
+        // 已有待发送通知，刷新时只会发送最新值
+        coalesced_count_++;
+        characteristic->notification_stats_.coalesced_updates++;
+        return false;
+    }
+
+    characteristic->notification_pending_ = true;
+    pending_.push_back(characteristic);
+    scheduleFlush();
+    return true;
+}
+
+void NotificationScheduler::cancel(GattCharacteristic* characteristic) {
+    if (!characteristic || !characteristic->notification_pending_) {
+        return;
+    }
+
+    characteristic->notification_pending_ = false;
+    pending_.erase(std::remove(pending_.begin(), pending_.end(), characteristic), pending_.end());
+
+    if (pending_.empty()) {
+        cancelFlush();
+    }
+}
+
+void NotificationScheduler::flush() {
+    cancelFlush();
+
+    // 先取出列表，刷新过程中新的setValue会进入下一个窗口
+    std::vector<GattCharacteristic*> batch;
+    batch.swap(pending_);
+
+    for (GattCharacteristic* characteristic : batch) {
+        characteristic->notification_pending_ = false;
+        characteristic->notifyValueChanged();
+        sent_count_++;
+    }
+}
+
+void NotificationScheduler::resetStatistics() {
+    coalesced_count_ = 0;
+    sent_count_ = 0;
+}
+
+void NotificationScheduler::scheduleFlush() {
+    if (source_id_ != 0) {
+        return;
+    }
+
+    if (flush_interval_ms_ == 0) {
+        // 默认优先级的空闲源：下一次主循环迭代时刷新，不会被其他空闲任务饿死
+        source_id_ = g_idle_add_full(G_PRIORITY_DEFAULT, onFlush, this, nullptr);
+    } else {
+        source_id_ = g_timeout_add(flush_interval_ms_, onFlush, this);
+    }
+}
+
+void NotificationScheduler::cancelFlush() {
+    if (source_id_ != 0) {
+        g_source_remove(source_id_);
+        source_id_ = 0;
+    }
+}
+
+gboolean NotificationScheduler::onFlush(gpointer user_data) {
+    NotificationScheduler* scheduler = static_cast<NotificationScheduler*>(user_data);
+
+    // 源在返回G_SOURCE_REMOVE后自动销毁，这里只需清除ID
+    scheduler->source_id_ = 0;
+    scheduler->flush();
+    return G_SOURCE_REMOVE;
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,291 @@
+#include "payload_codec.h"
+#include <iostream>
+#include <algorithm>
+
+namespace Bluetooth {
+
+namespace {
+
+void appendVarint(ByteValue& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool readVarint(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (pos >= size) {
+            return false;
+        }
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// 小端读取一个字段，width不超过4
+uint32_t readWord(const uint8_t* data, size_t offset, size_t width) {
+    uint32_t word = 0;
+    for (size_t i = 0; i < width; ++i) {
+        word |= static_cast<uint32_t>(data[offset + i]) << (8 * i);
+    }
+    return word;
+}
+
+void writeWord(uint8_t* data, size_t offset, size_t width, uint32_t word) {
+    for (size_t i = 0; i < width; ++i) {
+        data[offset + i] = static_cast<uint8_t>(word >> (8 * i));
+    }
+}
+
+uint32_t widthMask(size_t width) {
+    return width >= 4 ? 0xFFFFFFFFu : ((1u << (8 * width)) - 1);
+}
+
+// 按字段宽度求带符号差值（模2^(8*width)回绕）
+int64_t signedDifference(uint32_t current, uint32_t previous, size_t width) {
+    uint32_t mask = widthMask(width);
+    uint32_t diff = (current - previous) & mask;
+    uint32_t sign_bit = 1u << (8 * width - 1);
+    if (diff & sign_bit) {
+        return static_cast<int64_t>(diff) - (static_cast<int64_t>(mask) + 1);
+    }
+    return static_cast<int64_t>(diff);
+}
+
+size_t unitSize(PayloadFrameType type, const PayloadEncodingConfig& config) {
+    return type == PayloadFrameType::DELTA ? config.word_size : 1;
+}
+
+// 编码异或帧或差分帧的区段
+void encodeRuns(PayloadFrameType type, size_t unit, const ByteValue& previous,
+                const ByteValue& current, ByteValue& out) {
+    size_t size = current.size();
+    size_t count = (size + unit - 1) / unit;
+
+    auto width = [&](size_t index) { return std::min(unit, size - index * unit); };
+    auto unchanged = [&](size_t index) {
+        return std::equal(current.begin() + index * unit, current.begin() + index * unit + width(index),
+                          previous.begin() + index * unit);
+    };
+
+    size_t index = 0;
+    while (index < count) {
+        size_t run_start = index;
+        while (index < count && unchanged(index)) {
+            ++index;
+        }
+        if (index == count) {
+            break;
+        }
+
+        size_t changed_start = index;
+        while (index < count && !unchanged(index)) {
+            ++index;
+        }
+
+        appendVarint(out, changed_start - run_start);
+        appendVarint(out, index - changed_start);
+        for (size_t i = changed_start; i < index; ++i) {
+            size_t offset = i * unit;
+            if (type == PayloadFrameType::XOR) {
+                out.push_back(current[offset] ^ previous[offset]);
+            } else {
+                size_t w = width(i);
+                appendVarint(out, zigzagEncode(signedDifference(readWord(current.data(), offset, w),
+                                                                readWord(previous.data(), offset, w), w)));
+            }
+        }
+    }
+}
+
+// 将区段应用到value上
+bool decodeRuns(PayloadFrameType type, size_t unit, const uint8_t* data, size_t size,
+                size_t pos, std::vector<uint8_t>& value) {
+    size_t count = (value.size() + unit - 1) / unit;
+    size_t index = 0;
+
+    while (pos < size) {
+        uint64_t skip = 0;
+        uint64_t changed = 0;
+        if (!readVarint(data, size, pos, skip) || !readVarint(data, size, pos, changed)) {
+            return false;
+        }
+        if (skip > count - index || changed > count - index - skip) {
+            return false;
+        }
+        index += skip;
+
+        for (uint64_t i = 0; i < changed; ++i, ++index) {
+            size_t offset = index * unit;
+            if (type == PayloadFrameType::XOR) {
+                if (pos >= size) {
+                    return false;
+                }
+                value[offset] ^= data[pos++];
+            } else {
+                uint64_t encoded = 0;
+                if (!readVarint(data, size, pos, encoded)) {
+                    return false;
+                }
+                size_t w = std::min(unit, value.size() - offset);
+                uint32_t word = readWord(value.data(), offset, w) + static_cast<uint32_t>(zigzagDecode(encoded));
+                writeWord(value.data(), offset, w, word & widthMask(w));
+            }
+        }
+    }
+
+    return true;
+}
+
+uint8_t makeHeader(PayloadFrameType type, uint8_t sequence) {
+    return static_cast<uint8_t>((static_cast<uint8_t>(type) << 6) | (sequence & PAYLOAD_FRAME_SEQUENCE_MASK));
+}
+
+PayloadEncodingConfig normalizeConfig(PayloadEncodingConfig config) {
+    if (config.word_size != 1 && config.word_size != 2 && config.word_size != 4) {
+        std::cerr << "Unsupported delta word size " << config.word_size << ", using 1" << std::endl;
+        config.word_size = 1;
+    }
+    return config;
+}
+
+} // namespace
+
+PayloadEncoder::PayloadEncoder(const PayloadEncodingConfig& config)
+    : config_(normalizeConfig(config)), has_previous_(false), keyframe_requested_(true),
+      sequence_(0), frames_since_keyframe_(0) {
+}
+
+ByteValue PayloadEncoder::encode(const ByteValue& value, size_t max_frame_size) {
+    stats_.raw_bytes += value.size();
+
+    if (config_.mode == PayloadEncoding::NONE) {
+        stats_.encoded_bytes += value.size();
+        return value;
+    }
+
+    // 关键帧放不下时不发送，也不推进序号和基准值
+    bool keyframe_fits = value.size() + PAYLOAD_FRAME_HEADER_SIZE <= max_frame_size;
+
+    bool need_keyframe = !has_previous_ || keyframe_requested_ ||
+                         previous_.size() != value.size() ||
+                         (config_.keyframe_interval != 0 && frames_since_keyframe_ >= config_.keyframe_interval);
+    if (need_keyframe) {
+        return keyframe_fits ? encodeKeyframe(value) : rejectOversized(value);
+    }
+
+    PayloadFrameType type = config_.mode == PayloadEncoding::XOR ? PayloadFrameType::XOR : PayloadFrameType::DELTA;
+    ByteValue frame;
+    frame.reserve(value.size() + PAYLOAD_FRAME_HEADER_SIZE);
+    frame.push_back(makeHeader(type, sequence_));
+    encodeRuns(type, unitSize(type, config_), previous_, value, frame);
+
+    // 变化太多时差分帧不再划算，直接发送关键帧；差分帧超过上限时同样改发关键帧
+    if (frame.size() >= value.size() + PAYLOAD_FRAME_HEADER_SIZE || frame.size() > max_frame_size) {
+        return keyframe_fits ? encodeKeyframe(value) : rejectOversized(value);
+    }
+
+    previous_ = value;
+    sequence_ = (sequence_ + 1) & PAYLOAD_FRAME_SEQUENCE_MASK;
+    frames_since_keyframe_++;
+    stats_.delta_frames++;
+    stats_.encoded_bytes += frame.size();
+    return frame;
+}
+
+ByteValue PayloadEncoder::encodeKeyframe(const ByteValue& value) {
+    ByteValue frame;
+    frame.reserve(value.size() + PAYLOAD_FRAME_HEADER_SIZE);
+    frame.push_back(makeHeader(PayloadFrameType::KEYFRAME, sequence_));
+    frame.append(value.data(), value.size());
+
+    previous_ = value;
+    has_previous_ = true;
+    keyframe_requested_ = false;
+    sequence_ = (sequence_ + 1) & PAYLOAD_FRAME_SEQUENCE_MASK;
+    frames_since_keyframe_ = 0;
+    stats_.keyframes++;
+    stats_.encoded_bytes += frame.size();
+    return frame;
+}
+
+ByteValue PayloadEncoder::rejectOversized(const ByteValue& value) {
+    if (stats_.oversized++ == 0) {
+        std::cerr << "Encoded notification of " << value.size() + PAYLOAD_FRAME_HEADER_SIZE
+                  << " bytes exceeds the frame limit, value not sent" << std::endl;
+    }
+    return ByteValue();
+}
+
+PayloadDecoder::PayloadDecoder(const PayloadEncodingConfig& config)
+    : config_(normalizeConfig(config)), synchronized_(false), last_sequence_(0) {
+}
+
+bool PayloadDecoder::decode(const uint8_t* data, size_t size, std::vector<uint8_t>& value) {
+    if (config_.mode == PayloadEncoding::NONE) {
+        value.assign(data, data + size);
+        return true;
+    }
+
+    if (size < PAYLOAD_FRAME_HEADER_SIZE) {
+        return false;
+    }
+
+    PayloadFrameType type = static_cast<PayloadFrameType>(data[0] >> 6);
+    uint8_t sequence = data[0] & PAYLOAD_FRAME_SEQUENCE_MASK;
+
+    if (type == PayloadFrameType::KEYFRAME) {
+        current_.assign(data + PAYLOAD_FRAME_HEADER_SIZE, data + size);
+        synchronized_ = true;
+        last_sequence_ = sequence;
+        value = current_;
+        return true;
+    }
+
+    if (type != PayloadFrameType::XOR && type != PayloadFrameType::DELTA) {
+        return false;
+    }
+
+    if (!synchronized_) {
+        return false;
+    }
+
+    // 指示重发会收到同一序号的帧，保持当前值不变
+    if (sequence == last_sequence_) {
+        value = current_;
+        return true;
+    }
+
+    if (sequence != ((last_sequence_ + 1) & PAYLOAD_FRAME_SEQUENCE_MASK)) {
+        synchronized_ = false;
+        return false;
+    }
+
+    std::vector<uint8_t> decoded = current_;
+    if (!decodeRuns(type, unitSize(type, config_), data, size, PAYLOAD_FRAME_HEADER_SIZE, decoded)) {
+        synchronized_ = false;
+        return false;
+    }
+
+    current_.swap(decoded);
+    last_sequence_ = sequence;
+    value = current_;
+    return true;
+}
+
+} // namespace Bluetooth
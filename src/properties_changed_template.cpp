@@ -0,0 +1,65 @@
+#include "properties_changed_template.h"
+#include <iostream>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+PropertiesChangedTemplate::PropertiesChangedTemplate(const std::string& object_path,
+                                                     const std::string& interface_name,
+                                                     const std::string& property_name)
+    : object_path_(object_path), property_name_(property_name) {
+
+    // 常量部分只构建一次，持有非浮动引用供每次发送共享
+    message_ = g_dbus_message_new_signal(object_path_.c_str(), "org.freedesktop.DBus.Properties",
+                                         "PropertiesChanged");
+    interface_name_ = g_variant_ref_sink(g_variant_new_string(interface_name.c_str()));
+    property_key_ = g_variant_ref_sink(g_variant_new_string(property_name.c_str()));
+    invalidated_ = g_variant_ref_sink(g_variant_new_array(G_VARIANT_TYPE_STRING, nullptr, 0));
+}
+
+PropertiesChangedTemplate::~PropertiesChangedTemplate() {
+    g_variant_unref(invalidated_);
+    g_variant_unref(property_key_);
+    g_variant_unref(interface_name_);
+    g_object_unref(message_);
+}
+
+GDBusMessage* PropertiesChangedTemplate::build(GVariant* value) const {
+    // 复制模板只复制已校验过的头部，不再逐项解析路径、接口和成员名
+    GError* error = nullptr;
+    GDBusMessage* message = g_dbus_message_copy(message_, &error);
+    if (!message) {
+        std::cerr << "Failed to copy PropertiesChanged template: " << error->message << std::endl;
+        g_error_free(error);
+        message = g_dbus_message_new_signal(object_path_.c_str(), "org.freedesktop.DBus.Properties",
+                                            "PropertiesChanged");
+    }
+
+    // 只有属性值是新的，其余子值复用模板中的实例
+    GVariant* entry = g_variant_new_dict_entry(property_key_, g_variant_new_variant(value));
+    GVariant* changed = g_variant_new_array(G_VARIANT_TYPE("{sv}"), &entry, 1);
+    GVariant* children[] = { interface_name_, changed, invalidated_ };
+
+    g_dbus_message_set_body(message, g_variant_new_tuple(children, 3));
+    return message;
+}
+
+bool PropertiesChangedTemplate::emit(GDBusConnection* connection, GVariant* value) const {
+    GError* error = nullptr;
+    GDBusMessage* message = build(value);
+
+    gboolean sent = g_dbus_connection_send_message(connection, message,
+        G_DBUS_SEND_MESSAGE_FLAGS_NONE, nullptr, &error);
+
+    g_object_unref(message);
+
+    if (!sent) {
+        std::cerr << "Failed to emit PropertiesChanged signal: " << error->message << std::endl;
+        g_error_free(error);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,136 @@
+#include "rate_limiter.h"
+#include <algorithm>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+TokenBucket::TokenBucket()
+    : tokens_(0.0), last_refill_us_(0) {
+}
+
+TokenBucket::TokenBucket(const RateLimitConfig& config)
+    : TokenBucket() {
+    configure(config);
+}
+
+void TokenBucket::configure(const RateLimitConfig& config) {
+    bool was_limited = isLimited();
+    config_ = config;
+    config_.burst = std::max(config_.burst, 1.0);
+
+    if (!was_limited) {
+        // 新启用的桶从满桶开始，允许一次完整突发
+        tokens_ = config_.burst;
+        last_refill_us_ = g_get_monotonic_time();
+    } else {
+        tokens_ = std::min(tokens_, config_.burst);
+    }
+}
+
+bool TokenBucket::tryConsume(gint64 now_us) {
+    if (!isLimited()) {
+        return true;
+    }
+
+    refill(now_us);
+    if (tokens_ < 1.0) {
+        return false;
+    }
+
+    tokens_ -= 1.0;
+    return true;
+}
+
+gint64 TokenBucket::getDelayUntilAvailable(gint64 now_us) {
+    if (!isLimited()) {
+        return 0;
+    }
+
+    refill(now_us);
+    if (tokens_ >= 1.0) {
+        return 0;
+    }
+
+    return static_cast<gint64>((1.0 - tokens_) / config_.rate * G_USEC_PER_SEC) + 1;
+}
+
+void TokenBucket::refill(gint64 now_us) {
+    if (now_us > last_refill_us_) {
+        double elapsed = static_cast<double>(now_us - last_refill_us_) / G_USEC_PER_SEC;
+        tokens_ = std::min(config_.burst, tokens_ + elapsed * config_.rate);
+    }
+    last_refill_us_ = now_us;
+}
+
+RateLimiter::RateLimiter(ReleaseCallback release_callback)
+    : release_callback_(release_callback), timer_id_(0) {
+}
+
+RateLimiter::~RateLimiter() {
+    cancel();
+}
+
+void RateLimiter::configure(const RateLimitConfig& config) {
+    bucket_.configure(config);
+
+    // 关闭限速或改为丢弃策略时立即释放推迟中的发送
+    if (timer_id_ != 0 && (!bucket_.isLimited() || config.policy == RateLimitPolicy::DROP)) {
+        cancel();
+        if (release_callback_) {
+            release_callback_();
+        }
+    }
+}
+
+bool RateLimiter::admit() {
+    gint64 now = g_get_monotonic_time();
+
+    if (timer_id_ != 0) {
+        // 已有推迟中的发送，届时会带上最新值，本次更新被合并
+        stats_.dropped++;
+        return false;
+    }
+
+    if (bucket_.tryConsume(now)) {
+        stats_.passed++;
+        return true;
+    }
+
+    if (bucket_.getConfig().policy == RateLimitPolicy::DROP) {
+        stats_.dropped++;
+        return false;
+    }
+
+    gint64 delay_us = bucket_.getDelayUntilAvailable(now);
+    timer_id_ = g_timeout_add(static_cast<guint>(delay_us / 1000) + 1, onRelease, this);
+    stats_.delayed++;
+    return false;
+}
+
+void RateLimiter::cancel() {
+    if (timer_id_ != 0) {
+        g_source_remove(timer_id_);
+        timer_id_ = 0;
+    }
+}
+
+gboolean RateLimiter::onRelease(gpointer user_data) {
+    RateLimiter* limiter = static_cast<RateLimiter*>(user_data);
+
+    limiter->timer_id_ = 0;
+    if (!limiter->bucket_.tryConsume(g_get_monotonic_time())) {
+        // 定时器精度误差，稍后重试
+        gint64 delay_us = limiter->bucket_.getDelayUntilAvailable(g_get_monotonic_time());
+        limiter->timer_id_ = g_timeout_add(static_cast<guint>(delay_us / 1000) + 1, onRelease, limiter);
+        return G_SOURCE_REMOVE;
+    }
+
+    // 回调可能销毁限速器，先复制回调，调用后不再访问成员
+    ReleaseCallback callback = limiter->release_callback_;
+    if (callback) {
+        callback();
+    }
+    return G_SOURCE_REMOVE;
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,446 @@
+#include "shared_value_table.h"
+#include "gatt_characteristic.h"
+#include "seqlock.h"
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <glib-unix.h>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+namespace {
+
+constexpr uint32_t TABLE_MAGIC = 0x42545654;  // "BTVT"
+constexpr uint32_t TABLE_VERSION = 1;
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// 共享内存头部，占一个缓存行
+struct TableHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    std::atomic<uint32_t> doorbell;  // 1表示已写过eventfd、服务端尚未处理
+};
+
+// 槽位头部，之后紧跟数据字
+struct SlotHeader {
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> size;
+};
+
+static_assert(sizeof(TableHeader) <= CACHE_LINE_SIZE, "table header must fit in one cache line");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared seqlock requires lock-free 64-bit atomics");
+
+size_t slotStride(size_t slot_size) {
+    size_t bytes = sizeof(SlotHeader) + Seqlock::wordCount(slot_size) * Seqlock::WORD_SIZE;
+    // 每个槽位独占缓存行，不同槽位的写者互不干扰
+    return (bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+// 映射区域的总长度；槽位数和槽位长度在头部中以32位保存，乘法溢出时返回false
+bool tableSize(size_t slot_count, size_t slot_size, size_t& size) {
+    if (slot_count > UINT32_MAX || slot_size > UINT32_MAX) {
+        return false;
+    }
+
+    size_t stride = slotStride(slot_size);
+    if (slot_count > (SIZE_MAX - CACHE_LINE_SIZE) / stride) {
+        return false;
+    }
+
+    size = CACHE_LINE_SIZE + slot_count * stride;
+    return true;
+}
+
+SlotHeader* slotHeader(uint8_t* address) {
+    return reinterpret_cast<SlotHeader*>(address);
+}
+
+std::atomic<uint64_t>* slotWords(uint8_t* address) {
+    return reinterpret_cast<std::atomic<uint64_t>*>(address + sizeof(SlotHeader));
+}
+
+} // namespace
+
+SharedValueTable::SharedValueTable()
+    : base_(nullptr), mapped_size_(0), fd_(-1), event_fd_(-1),
+      slot_count_(0), slot_size_(0), slot_stride_(0) {
+}
+
+SharedValueTable::~SharedValueTable() {
+    close();
+}
+
+bool SharedValueTable::create(const std::string& name, size_t slot_count, size_t slot_size) {
+    if (isOpen() || slot_count == 0) {
+        return false;
+    }
+
+    int fd = name.empty()
+        ? memfd_create("bluetooth-values", MFD_CLOEXEC)
+        : shm_open(("/" + name).c_str(), O_CREAT | O_RDWR | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        std::cerr << "Failed to create shared value table: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (!map(fd, true, slot_count, slot_size)) {
+        ::close(fd);
+        return false;
+    }
+
+    std::cout << "Shared value table created with " << slot_count << " slots" << std::endl;
+    return true;
+}
+
+bool SharedValueTable::open(const std::string& name) {
+    if (isOpen() || name.empty()) {
+        return false;
+    }
+
+    int fd = shm_open(("/" + name).c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Failed to open shared value table " << name << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (!map(fd, false, 0, 0)) {
+        ::close(fd);
+        return false;
+    }
+    return true;
+}
+
+bool SharedValueTable::attach(int fd) {
+    if (isOpen() || fd < 0) {
+        return false;
+    }
+
+    int own_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (own_fd < 0) {
+        std::cerr << "Failed to duplicate shared value table fd: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (!map(own_fd, false, 0, 0)) {
+        ::close(own_fd);
+        return false;
+    }
+    return true;
+}
+
+void SharedValueTable::close() {
+    if (base_) {
+        munmap(base_, mapped_size_);
+        base_ = nullptr;
+        mapped_size_ = 0;
+    }
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    if (event_fd_ >= 0) {
+        ::close(event_fd_);
+        event_fd_ = -1;
+    }
+
+    slot_count_ = 0;
+    slot_size_ = 0;
+    slot_stride_ = 0;
+}
+
+bool SharedValueTable::createEventFd() {
+    if (event_fd_ >= 0) {
+        return true;
+    }
+
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd_ < 0) {
+        std::cerr << "Failed to create eventfd: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SharedValueTable::setEventFd(int fd) {
+    if (event_fd_ >= 0) {
+        ::close(event_fd_);
+        event_fd_ = -1;
+    }
+
+    if (fd < 0) {
+        return true;
+    }
+
+    event_fd_ = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    return event_fd_ >= 0;
+}
+
+bool SharedValueTable::publish(size_t slot, const uint8_t* data, size_t size) {
+    if (!isOpen() || slot >= slot_count_ || size > slot_size_) {
+        return false;
+    }
+
+    uint8_t* address = slotAddress(slot);
+    SlotHeader* header = slotHeader(address);
+    Seqlock::write(header->sequence, header->size, slotWords(address), data, size);
+
+    // 门铃已响时服务端必然还会扫描一次，不必再写eventfd。
+    // 与acknowledgeWakeup()中的屏障配对：看到门铃未复位时，服务端复位后的扫描必然看到这次写入
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    TableHeader* table = static_cast<TableHeader*>(base_);
+    if (event_fd_ >= 0 && table->doorbell.exchange(1, std::memory_order_acq_rel) == 0) {
+        uint64_t one = 1;
+        if (write(event_fd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            std::cerr << "Failed to signal eventfd: " << strerror(errno) << std::endl;
+        }
+    }
+
+    return true;
+}
+
+bool SharedValueTable::tryRead(size_t slot, ByteValue& value, uint64_t& version) const {
+    if (!isOpen() || slot >= slot_count_) {
+        return false;
+    }
+
+    // 写者在其他进程中，不能无限等待它完成写入
+    uint8_t* address = slotAddress(slot);
+    SlotHeader* header = slotHeader(address);
+    return Seqlock::tryRead(header->sequence, header->size, slotWords(address), slot_size_, value,
+                            SHARED_TABLE_READ_ATTEMPTS, version);
+}
+
+uint64_t SharedValueTable::read(size_t slot, ByteValue& value) const {
+    uint64_t version = 0;
+    return tryRead(slot, value, version) ? version : 0;
+}
+
+uint64_t SharedValueTable::getVersion(size_t slot) const {
+    if (!isOpen() || slot >= slot_count_) {
+        return 0;
+    }
+
+    return slotHeader(slotAddress(slot))->sequence.load(std::memory_order_acquire) / 2;
+}
+
+void SharedValueTable::acknowledgeWakeup() {
+    if (!isOpen()) {
+        return;
+    }
+
+    if (event_fd_ >= 0) {
+        uint64_t count = 0;
+        while (::read(event_fd_, &count, sizeof(count)) > 0) {
+        }
+    }
+
+    // 先复位门铃再扫描，扫描期间的写入会再次唤醒；
+    // 屏障保证扫描中读取序号不会早于复位生效，否则生产者可能看到旧门铃而跳过唤醒
+    static_cast<TableHeader*>(base_)->doorbell.store(0, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+bool SharedValueTable::map(int fd, bool initialize, size_t slot_count, size_t slot_size) {
+    size_t size = 0;
+
+    if (initialize) {
+        if (!tableSize(slot_count, slot_size, size)) {
+            std::cerr << "Shared value table is too large: " << slot_count << " slots of "
+                      << slot_size << " bytes" << std::endl;
+            return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+            std::cerr << "Failed to size shared value table: " << strerror(errno) << std::endl;
+            return false;
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < CACHE_LINE_SIZE) {
+            std::cerr << "Shared value table is too small" << std::endl;
+            return false;
+        }
+        size = static_cast<size_t>(st.st_size);
+    }
+
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Failed to map shared value table: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    TableHeader* header = static_cast<TableHeader*>(base);
+    if (initialize) {
+        // ftruncate后内容全为0，所有槽位的序号和长度也都是0
+        header->version = TABLE_VERSION;
+        header->slot_count = static_cast<uint32_t>(slot_count);
+        header->slot_size = static_cast<uint32_t>(slot_size);
+        header->doorbell.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = TABLE_MAGIC;
+    } else {
+        slot_count = header->slot_count;
+        slot_size = header->slot_size;
+        size_t required = 0;
+        if (header->magic != TABLE_MAGIC || header->version != TABLE_VERSION ||
+            !tableSize(slot_count, slot_size, required) || size < required) {
+            std::cerr << "Invalid shared value table layout" << std::endl;
+            munmap(base, size);
+            return false;
+        }
+    }
+
+    base_ = base;
+    mapped_size_ = size;
+    fd_ = fd;
+    slot_count_ = slot_count;
+    slot_size_ = slot_size;
+    slot_stride_ = slotStride(slot_size);
+    return true;
+}
+
+uint8_t* SharedValueTable::slotAddress(size_t slot) const {
+    return static_cast<uint8_t*>(base_) + CACHE_LINE_SIZE + slot * slot_stride_;
+}
+
+SharedValueTableWatch::SharedValueTableWatch(std::shared_ptr<SharedValueTable> table)
+    : table_(table), polling_(false), poll_source_id_(0), event_source_id_(0) {
+    buffer_.reserve(table_->getSlotSize());
+}
+
+SharedValueTableWatch::~SharedValueTableWatch() {
+    stop();
+}
+
+bool SharedValueTableWatch::bindSlot(size_t slot, std::shared_ptr<GattCharacteristic> characteristic) {
+    if (slot >= table_->getSlotCount()) {
+        return false;
+    }
+
+    unbindSlot(slot);
+
+    // 版本从0开始，绑定前已写入的值也会在下一次检查时送达
+    bindings_.push_back({ slot, characteristic, 0, false, false });
+    return true;
+}
+
+void SharedValueTableWatch::unbindSlot(size_t slot) {
+    // poll()遍历期间只做标记，避免移动元素导致跳过下一个绑定
+    if (polling_) {
+        for (Binding& binding : bindings_) {
+            if (binding.slot == slot) {
+                binding.removed = true;
+            }
+        }
+        return;
+    }
+
+    bindings_.erase(std::remove_if(bindings_.begin(), bindings_.end(), [slot](const Binding& binding) {
+        return binding.slot == slot;
+    }), bindings_.end());
+}
+
+void SharedValueTableWatch::startPolling(guint interval_ms) {
+    if (poll_source_id_ != 0) {
+        g_source_remove(poll_source_id_);
+    }
+    poll_source_id_ = g_timeout_add(interval_ms, onPollTimer, this);
+}
+
+bool SharedValueTableWatch::startEventWatch() {
+    if (table_->getEventFd() < 0) {
+        return false;
+    }
+
+    if (event_source_id_ == 0) {
+        event_source_id_ = g_unix_fd_add(table_->getEventFd(), G_IO_IN, onEventFd, this);
+    }
+    return true;
+}
+
+void SharedValueTableWatch::stop() {
+    if (poll_source_id_ != 0) {
+        g_source_remove(poll_source_id_);
+        poll_source_id_ = 0;
+    }
+
+    if (event_source_id_ != 0) {
+        g_source_remove(event_source_id_);
+        event_source_id_ = 0;
+    }
+}
+
+size_t SharedValueTableWatch::poll() {
+    size_t changed = 0;
+
+    // setValue()的回调中可能绑定或解除绑定：按下标遍历，解除的绑定只做标记，遍历结束后移除
+    polling_ = true;
+    for (size_t i = 0; i < bindings_.size(); ++i) {
+        Binding& binding = bindings_[i];
+        if (binding.removed) {
+            continue;
+        }
+
+        // 只比较版本号，没有变化的槽位不读取数据
+        if (table_->getVersion(binding.slot) == binding.consumed_version) {
+            continue;
+        }
+
+        std::shared_ptr<GattCharacteristic> characteristic = binding.characteristic.lock();
+        if (!characteristic) {
+            continue;
+        }
+
+        // 生产者进程在写入中途退出时槽位一直停在写入中，跳过它，不阻塞其他槽位和主循环
+        uint64_t version = 0;
+        if (!table_->tryRead(binding.slot, buffer_, version)) {
+            if (!binding.stalled) {
+                std::cerr << "Shared value table slot " << binding.slot
+                          << " is stuck mid-write, skipping it" << std::endl;
+                binding.stalled = true;
+            }
+            continue;
+        }
+
+        if (binding.stalled) {
+            std::cout << "Shared value table slot " << binding.slot << " recovered" << std::endl;
+            binding.stalled = false;
+        }
+
+        binding.consumed_version = version;
+        characteristic->setValue(buffer_);
+        changed++;
+    }
+    polling_ = false;
+
+    bindings_.erase(std::remove_if(bindings_.begin(), bindings_.end(), [](const Binding& binding) {
+        return binding.removed;
+    }), bindings_.end());
+
+    return changed;
+}
+
+gboolean SharedValueTableWatch::onPollTimer(gpointer user_data) {
+    SharedValueTableWatch* watch = static_cast<SharedValueTableWatch*>(user_data);
+    watch->poll();
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean SharedValueTableWatch::onEventFd(gint fd, GIOCondition condition, gpointer user_data) {
+    SharedValueTableWatch* watch = static_cast<SharedValueTableWatch*>(user_data);
+    watch->table_->acknowledgeWakeup();
+    watch->poll();
+    return G_SOURCE_CONTINUE;
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,107 @@
+#include "stream_framing.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Bluetooth {
+
+StreamChunker::StreamChunker(StreamProducer producer, size_t chunk_payload_size)
+    : producer_(producer), payload_size_(std::max<size_t>(chunk_payload_size, 1)),
+      frame_(STREAM_HEADER_SIZE + payload_size_), lookahead_(payload_size_), lookahead_size_(0),
+      sequence_(0), started_(false), exhausted_(false), finished_(false), chunks_(0), bytes_(0) {
+}
+
+bool StreamChunker::next(ValueSnapshot& chunk) {
+    if (finished_) {
+        return false;
+    }
+
+    bool first = !started_;
+    if (first) {
+        lookahead_size_ = fill(lookahead_.data());
+        started_ = true;
+    }
+
+    // 当前块取自预读缓冲，再预读下一块以确定当前块是否为末块
+    size_t size = lookahead_size_;
+    std::memcpy(frame_.data() + STREAM_HEADER_SIZE, lookahead_.data(), size);
+    lookahead_size_ = fill(lookahead_.data());
+    bool last = lookahead_size_ == 0;
+
+    uint8_t header = sequence_ & STREAM_SEQUENCE_MASK;
+    if (first) {
+        header |= STREAM_FLAG_FIRST;
+    }
+    if (last) {
+        header |= STREAM_FLAG_LAST;
+        finished_ = true;
+    }
+    frame_[0] = header;
+
+    chunk = ValueSnapshot(frame_.data(), STREAM_HEADER_SIZE + size);
+    sequence_ = (sequence_ + 1) & STREAM_SEQUENCE_MASK;
+    chunks_++;
+    bytes_ += size;
+    return true;
+}
+
+size_t StreamChunker::fill(uint8_t* buffer) {
+    // 生产者一次可能只给出一部分，尽量填满一块
+    size_t filled = 0;
+    while (!exhausted_ && filled < payload_size_) {
+        size_t produced = producer_(buffer + filled, payload_size_ - filled);
+        if (produced == 0) {
+            exhausted_ = true;
+            break;
+        }
+        filled += std::min(produced, payload_size_ - filled);
+    }
+    return filled;
+}
+
+StreamReassembler::StreamReassembler(size_t max_message_size)
+    : max_message_size_(max_message_size), expected_sequence_(0), in_progress_(false), errors_(0) {
+}
+
+ReassemblyStatus StreamReassembler::push(const uint8_t* data, size_t size) {
+    if (size < STREAM_HEADER_SIZE) {
+        return fail();
+    }
+
+    uint8_t header = data[0];
+    uint8_t sequence = header & STREAM_SEQUENCE_MASK;
+
+    if (header & STREAM_FLAG_FIRST) {
+        // 首块总是开始新消息，未完成的旧消息被丢弃
+        message_.clear();
+        in_progress_ = true;
+    } else if (!in_progress_ || sequence != expected_sequence_) {
+        return fail();
+    }
+
+    size_t payload_size = size - STREAM_HEADER_SIZE;
+    if (message_.size() + payload_size > max_message_size_) {
+        return fail();
+    }
+
+    message_.append(data + STREAM_HEADER_SIZE, payload_size);
+    expected_sequence_ = (sequence + 1) & STREAM_SEQUENCE_MASK;
+
+    if (header & STREAM_FLAG_LAST) {
+        in_progress_ = false;
+        return ReassemblyStatus::COMPLETE;
+    }
+    return ReassemblyStatus::INCOMPLETE;
+}
+
+void StreamReassembler::reset() {
+    message_.clear();
+    in_progress_ = false;
+}
+
+ReassemblyStatus StreamReassembler::fail() {
+    reset();
+    errors_++;
+    return ReassemblyStatus::ERROR;
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,278 @@
+#include "subscriber_session.h"
+#include "gatt_characteristic.h"
+#include <iostream>
+#include <algorithm>
+#include <glib-2.0/glib.h>
+#include <glib-unix.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace Bluetooth {
+
+SubscriberSession::SubscriberSession(const std::string& device_path, const SubscriberQueueConfig& config)
+    : device_path_(device_path), config_(config), fd_(-1), mtu_(0),
+      watch_id_(0), writable_watch_id_(0), closed_(false), congested_(false),
+      rate_limiter_([this]() { releaseDelayed(); }), delayed_encode_(true), front_encoded_(false) {
+}
+
+SubscriberSession::~SubscriberSession() {
+    if (writable_watch_id_ != 0) {
+        g_source_remove(writable_watch_id_);
+    }
+    if (watch_id_ != 0) {
+        g_source_remove(watch_id_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+bool SubscriberSession::attachSocket(int fd, uint16_t mtu) {
+    if (fd_ >= 0 || fd < 0) {
+        return false;
+    }
+
+    fd_ = fd;
+    mtu_ = std::max<uint16_t>(mtu, DEFAULT_ATT_MTU);
+
+    // 对端关闭套接字即表示BlueZ释放了通知
+    watch_id_ = g_unix_fd_add(fd_, static_cast<GIOCondition>(G_IO_HUP | G_IO_ERR), onSocketEvent, this);
+    return true;
+}
+
+void SubscriberSession::setQueueConfig(const SubscriberQueueConfig& config) {
+    config_ = config;
+
+    // 缩小容量时按丢弃最旧处理超出部分
+    while (queue_.size() > config_.capacity) {
+        dropOldest();
+    }
+    updateWatermarks();
+}
+
+void SubscriberSession::setPayloadEncoding(const PayloadEncodingConfig& config) {
+    if (config.mode == PayloadEncoding::NONE) {
+        encoder_.reset();
+    } else {
+        encoder_ = std::make_unique<PayloadEncoder>(config);
+    }
+
+    // 已编码的队首按原格式写出，之后的帧由新编码器从关键帧开始
+    front_encoded_ = false;
+}
+
+PayloadEncodingStatistics SubscriberSession::getPayloadEncodingStatistics() const {
+    return encoder_ ? encoder_->getStatistics() : PayloadEncodingStatistics();
+}
+
+void SubscriberSession::setRateLimit(const RateLimitConfig& config) {
+    rate_limiter_.configure(config);
+}
+
+bool SubscriberSession::isBlockingProducer() const {
+    return config_.drop_policy == DropPolicy::BLOCK_PRODUCER && queue_.size() >= config_.capacity;
+}
+
+bool SubscriberSession::canAcceptWithoutLoss() const {
+    // 推迟期间再入队会覆盖待发的值
+    return !closed_ && queue_.size() < config_.high_watermark && !rate_limiter_.isDelaying();
+}
+
+bool SubscriberSession::enqueue(const NotificationPayload& payload, bool encode) {
+    if (closed_ || !payload) {
+        return false;
+    }
+
+    if (!rate_limiter_.admit()) {
+        // 推迟期间只保留最新值，令牌可用时发出；值尚未编码，替换不影响解码序列
+        if (rate_limiter_.isDelaying()) {
+            delayed_payload_ = payload;
+            delayed_encode_ = encode;
+        }
+        return false;
+    }
+
+    return push(payload, encode);
+}
+
+bool SubscriberSession::enqueueStreamChunk(const NotificationPayload& chunk) {
+    if (closed_ || !chunk) {
+        return false;
+    }
+    return push(chunk, false);
+}
+
+void SubscriberSession::releaseDelayed() {
+    NotificationPayload payload;
+    payload.swap(delayed_payload_);
+    if (!payload || closed_) {
+        return;
+    }
+
+    if (!push(payload, delayed_encode_) && closed_) {
+        notifyClosed();
+    }
+}
+
+void SubscriberSession::dropOldest() {
+    // 丢弃已编码的队首会让解码端丢帧，下一帧改发关键帧
+    if (front_encoded_ && encoder_) {
+        encoder_->requestKeyframe();
+    }
+    front_encoded_ = false;
+
+    queue_.pop_front();
+    stats_.dropped++;
+}
+
+bool SubscriberSession::push(const NotificationPayload& payload, bool encode) {
+    if (queue_.size() >= config_.capacity) {
+        switch (config_.drop_policy) {
+            case DropPolicy::DROP_OLDEST:
+                dropOldest();
+                break;
+            case DropPolicy::DROP_NEWEST:
+            case DropPolicy::BLOCK_PRODUCER:
+                stats_.dropped++;
+                return false;
+        }
+    }
+
+    queue_.push_back({ payload, encode });
+
+    // 套接字可写时立即发出；写满时等待可写事件，不阻塞其他订阅者
+    if (writable_watch_id_ == 0 && !flushQueue()) {
+        markClosed();
+        return false;
+    }
+
+    updateWatermarks();
+    return true;
+}
+
+SubscriberStatistics SubscriberSession::getStatistics() const {
+    SubscriberStatistics stats = stats_;
+    stats.queued = queue_.size();
+    stats.congested = congested_;
+    stats.mtu = fd_ >= 0 ? mtu_ : 0;
+    stats.rate_limit = rate_limiter_.getStatistics();
+    return stats;
+}
+
+bool SubscriberSession::flushQueue() {
+    if (fd_ < 0) {
+        return true;
+    }
+
+    // 单个通知最多携带MTU-3字节（ATT操作码和句柄占3字节）
+    size_t max_payload = mtu_ - ATT_NOTIFICATION_HEADER_SIZE;
+
+    while (!queue_.empty()) {
+        QueuedNotification& front = queue_.front();
+
+        // 在写出时编码：只有真正送到对端的帧进入该订阅者的编码序列
+        if (front.encode && encoder_) {
+            ByteValue frame = encoder_->encode(front.payload.toByteValue(), max_payload);
+            if (frame.empty()) {
+                // 关键帧超过MTU，截断会破坏解码端的基准值，不发送该值
+                queue_.pop_front();
+                stats_.dropped++;
+                continue;
+            }
+            front.payload = ValueSnapshot(frame);
+            front.encode = false;
+            front_encoded_ = true;
+        }
+
+        const ValueSnapshot& data = front.payload;
+        size_t size = std::min(data.size(), max_payload);
+        ssize_t written = send(fd_, data.data(), size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (writable_watch_id_ == 0) {
+                    writable_watch_id_ = g_unix_fd_add(fd_, G_IO_OUT, onSocketWritable, this);
+                }
+                return true;
+            }
+
+            std::cerr << "Failed to write notification to " << device_path_
+                      << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        // 与BlueZ经由D-Bus发送通知时一样截断超长的值，但计数并在首次发生时告警
+        if (size < data.size()) {
+            if (stats_.truncated++ == 0) {
+                std::cerr << "Notification truncated to " << size << " of " << data.size()
+                          << " bytes for " << device_path_ << " (MTU " << mtu_ << ")" << std::endl;
+            }
+        }
+
+        queue_.pop_front();
+        front_encoded_ = false;
+        stats_.sent++;
+    }
+
+    return true;
+}
+
+void SubscriberSession::updateWatermarks() {
+    if (!congested_ && queue_.size() >= config_.high_watermark) {
+        congested_ = true;
+        if (watermark_callback_) {
+            watermark_callback_(device_path_, true);
+        }
+    } else if (congested_ && queue_.size() <= config_.low_watermark) {
+        congested_ = false;
+        if (watermark_callback_) {
+            watermark_callback_(device_path_, false);
+        }
+    }
+}
+
+void SubscriberSession::markClosed() {
+    closed_ = true;
+    queue_.clear();
+    front_encoded_ = false;
+    delayed_payload_.reset();
+    rate_limiter_.cancel();
+}
+
+void SubscriberSession::notifyClosed() {
+    markClosed();
+
+    // 回调可能销毁会话，先复制回调和路径，调用后不再访问成员
+    ClosedCallback callback = closed_callback_;
+    std::string device_path = device_path_;
+    if (callback) {
+        callback(device_path);
+    }
+}
+
+gboolean SubscriberSession::onSocketWritable(gint fd, GIOCondition condition, gpointer user_data) {
+    SubscriberSession* session = static_cast<SubscriberSession*>(user_data);
+
+    session->writable_watch_id_ = 0;
+    if (!session->flushQueue()) {
+        session->notifyClosed();
+        return G_SOURCE_REMOVE;
+    }
+
+    session->updateWatermarks();
+
+    // flushQueue在仍然写满时重新注册了可写监视，当前源总是移除
+    return G_SOURCE_REMOVE;
+}
+
+gboolean SubscriberSession::onSocketEvent(gint fd, GIOCondition condition, gpointer user_data) {
+    SubscriberSession* session = static_cast<SubscriberSession*>(user_data);
+
+    // 返回G_SOURCE_REMOVE后源自动销毁，析构时无需再移除
+    session->watch_id_ = 0;
+    session->notifyClosed();
+    return G_SOURCE_REMOVE;
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,103 @@
+#include "value_history.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Bluetooth {
+
+ValueHistory::ValueHistory(size_t capacity, size_t max_value_size)
+    : capacity_(std::max<size_t>(capacity, 1)), max_value_size_(max_value_size),
+      storage_(capacity_ * max_value_size_), entries_(capacity_),
+      head_(0), count_(0), last_timestamp_(0) {
+}
+
+bool ValueHistory::append(const uint8_t* data, size_t size, gint64 timestamp_us) {
+    if (size > max_value_size_) {
+        stats_.oversized++;
+        return false;
+    }
+
+    // 保持时间戳单调，查询时才能二分查找
+    if (count_ > 0 && timestamp_us < last_timestamp_) {
+        timestamp_us = last_timestamp_;
+    }
+
+    if (count_ == capacity_) {
+        stats_.overwritten++;
+    } else {
+        count_++;
+    }
+
+    Entry& entry = entries_[head_];
+    entry.timestamp = timestamp_us;
+    entry.size = size;
+    if (size > 0) {
+        std::memcpy(storage_.data() + head_ * max_value_size_, data, size);
+    }
+
+    head_ = (head_ + 1) % capacity_;
+    last_timestamp_ = timestamp_us;
+    stats_.appended++;
+    return true;
+}
+
+size_t ValueHistory::query(gint64 from_us, gint64 to_us, const HistoryVisitor& visitor) const {
+    if (count_ == 0 || from_us > to_us) {
+        return 0;
+    }
+
+    // 逻辑下标0为最旧的样本，时间戳随下标单调不减
+    auto lowerBound = [this](gint64 timestamp) {
+        size_t low = 0;
+        size_t high = count_;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (entries_[physicalIndex(middle)].timestamp < timestamp) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    };
+
+    size_t first = lowerBound(from_us);
+    size_t last = to_us == G_MAXINT64 ? count_ : lowerBound(to_us + 1);
+    visit(first, last, visitor);
+    return last - first;
+}
+
+size_t ValueHistory::visitLatest(size_t count, const HistoryVisitor& visitor) const {
+    count = std::min(count, count_);
+    visit(count_ - count, count_, visitor);
+    return count;
+}
+
+void ValueHistory::clear() {
+    head_ = 0;
+    count_ = 0;
+    last_timestamp_ = 0;
+}
+
+HistoryStatistics ValueHistory::getStatistics() const {
+    HistoryStatistics stats = stats_;
+    stats.count = count_;
+    return stats;
+}
+
+size_t ValueHistory::physicalIndex(size_t logical_index) const {
+    return (head_ + capacity_ - count_ + logical_index) % capacity_;
+}
+
+void ValueHistory::visit(size_t first, size_t last, const HistoryVisitor& visitor) const {
+    if (!visitor) {
+        return;
+    }
+
+    for (size_t i = first; i < last; ++i) {
+        size_t index = physicalIndex(i);
+        const Entry& entry = entries_[index];
+        visitor(entry.timestamp, storage_.data() + index * max_value_size_, entry.size);
+    }
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,118 @@
+#include "value_slot.h"
+#include "seqlock.h"
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+ValueSlot::ValueSlot(size_t capacity)
+    : capacity_(capacity), words_(new std::atomic<uint64_t>[Seqlock::wordCount(capacity)]),
+      sequence_(0), size_(0), wakeup_context_(nullptr), wakeup_pending_(false) {
+    for (size_t i = 0; i < Seqlock::wordCount(capacity_); ++i) {
+        words_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool ValueSlot::publish(const uint8_t* data, size_t size) {
+    if (size > capacity_) {
+        return false;
+    }
+
+    Seqlock::write(sequence_, size_, words_.get(), data, size);
+
+    // 上一次唤醒尚未被处理时不再重复唤醒，连续发布只触发一次分发。
+    // 序号写入与读取标记之间的全屏障和主循环一侧成对：要么主循环看到新序号，要么这里看到已清除的标记
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!wakeup_pending_.exchange(true, std::memory_order_acq_rel)) {
+        GMainContext* context = wakeup_context_.load(std::memory_order_acquire);
+        if (context) {
+            g_main_context_wakeup(context);
+        }
+    }
+
+    return true;
+}
+
+uint64_t ValueSlot::read(ByteValue& value) const {
+    return Seqlock::read(sequence_, size_, words_.get(), capacity_, value);
+}
+
+void ValueSlot::setWakeupContext(GMainContext* context) {
+    wakeup_context_.store(context, std::memory_order_release);
+}
+
+GSourceFuncs ValueSlotWatch::source_funcs_ = {
+    onPrepare,
+    onCheck,
+    onDispatch,
+    nullptr,
+    nullptr,
+    nullptr
+};
+
+ValueSlotWatch::ValueSlotWatch(std::shared_ptr<ValueSlot> slot, ValueCallback callback, GMainContext* context)
+    : slot_(slot), callback_(callback), source_(nullptr), consumed_sequence_(0) {
+
+    if (!context) {
+        context = g_main_context_default();
+    }
+
+    source_ = g_source_new(&source_funcs_, sizeof(SlotSource));
+    reinterpret_cast<SlotSource*>(source_)->watch = this;
+    g_source_attach(source_, context);
+
+    buffer_.reserve(slot_->getCapacity());
+    slot_->setWakeupContext(context);
+
+    // 绑定前已发布的值也会在下一次主循环迭代中送达
+    g_main_context_wakeup(context);
+}
+
+ValueSlotWatch::~ValueSlotWatch() {
+    slot_->setWakeupContext(nullptr);
+    g_source_destroy(source_);
+    g_source_unref(source_);
+}
+
+bool ValueSlotWatch::hasNewValue() const {
+    if (slot_->getSequence() / 2 != consumed_sequence_) {
+        return true;
+    }
+
+    // 没有新值时标记可能来自已被消费的发布（发布在分发清除标记之后才置位），
+    // 不清除的话之后的发布都会认为唤醒仍未处理而不再唤醒。清除后重新检查，
+    // 覆盖在两次检查之间完成、看到旧标记而没有唤醒的发布
+    slot_->clearWakeup();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return slot_->getSequence() / 2 != consumed_sequence_;
+}
+
+void ValueSlotWatch::dispatch() {
+    // 先清除标记再读取，读取之后的发布会再次唤醒
+    slot_->clearWakeup();
+
+    uint64_t sequence = slot_->read(buffer_);
+    if (sequence == consumed_sequence_) {
+        return;
+    }
+
+    consumed_sequence_ = sequence;
+    if (callback_) {
+        callback_(buffer_);
+    }
+}
+
+gboolean ValueSlotWatch::onPrepare(GSource* source, gint* timeout) {
+    *timeout = -1;
+    return reinterpret_cast<SlotSource*>(source)->watch->hasNewValue();
+}
+
+gboolean ValueSlotWatch::onCheck(GSource* source) {
+    return reinterpret_cast<SlotSource*>(source)->watch->hasNewValue();
+}
+
+gboolean ValueSlotWatch::onDispatch(GSource* source, GSourceFunc callback, gpointer user_data) {
+    reinterpret_cast<SlotSource*>(source)->watch->dispatch();
+    return G_SOURCE_CONTINUE;
+}
+
+} // namespace Bluetooth
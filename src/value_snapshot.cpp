@@ -0,0 +1,91 @@
+#include "value_snapshot.h"
+#include <utility>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+ValueSnapshot::ValueSnapshot(const ByteValue& value)
+    : bytes_(g_bytes_new(value.data(), value.size())) {
+}
+
+ValueSnapshot::ValueSnapshot(const uint8_t* data, size_t size)
+    : bytes_(g_bytes_new(data, size)) {
+}
+
+ValueSnapshot::~ValueSnapshot() {
+    reset();
+}
+
+ValueSnapshot::ValueSnapshot(const ValueSnapshot& other)
+    : bytes_(other.bytes_ ? g_bytes_ref(other.bytes_) : nullptr) {
+}
+
+ValueSnapshot::ValueSnapshot(ValueSnapshot&& other) noexcept
+    : bytes_(other.bytes_) {
+    other.bytes_ = nullptr;
+}
+
+ValueSnapshot& ValueSnapshot::operator=(const ValueSnapshot& other) {
+    ValueSnapshot copy(other);
+    swap(copy);
+    return *this;
+}
+
+ValueSnapshot& ValueSnapshot::operator=(ValueSnapshot&& other) noexcept {
+    ValueSnapshot moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+ValueSnapshot ValueSnapshot::adopt(GBytes* bytes) {
+    ValueSnapshot snapshot;
+    snapshot.bytes_ = bytes;
+    return snapshot;
+}
+
+ValueSnapshot ValueSnapshot::fromVariant(GVariant* variant) {
+    // 返回的GBytes引用GVariant的存储，GVariant可以随后释放
+    return adopt(g_variant_get_data_as_bytes(variant));
+}
+
+const uint8_t* ValueSnapshot::data() const {
+    if (!bytes_) {
+        return nullptr;
+    }
+    return static_cast<const uint8_t*>(g_bytes_get_data(bytes_, nullptr));
+}
+
+size_t ValueSnapshot::size() const {
+    return bytes_ ? g_bytes_get_size(bytes_) : 0;
+}
+
+GVariant* ValueSnapshot::toVariant() const {
+    if (!bytes_) {
+        return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, nullptr, 0, sizeof(uint8_t));
+    }
+
+    // GVariant持有GBytes的引用，不复制数据；字节数组没有对齐要求，可信任其格式
+    return g_variant_new_from_bytes(G_VARIANT_TYPE_BYTESTRING, bytes_, TRUE);
+}
+
+ValueSnapshot ValueSnapshot::slice(size_t offset, size_t length) const {
+    if (!bytes_) {
+        return ValueSnapshot();
+    }
+
+    // 新GBytes引用原GBytes，截取整段时直接返回原GBytes的引用
+    return adopt(g_bytes_new_from_bytes(bytes_, offset, length));
+}
+
+void ValueSnapshot::reset() {
+    if (bytes_) {
+        g_bytes_unref(bytes_);
+        bytes_ = nullptr;
+    }
+}
+
+void ValueSnapshot::swap(ValueSnapshot& other) noexcept {
+    std::swap(bytes_, other.bytes_);
+}
+
+} // namespace Bluetooth
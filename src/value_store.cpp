@@ -0,0 +1,380 @@
+#include "value_store.h"
+#include <iostream>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+namespace {
+
+constexpr uint32_t LOG_MAGIC = 0x4C565442;       // "BTVL"
+constexpr uint32_t SNAPSHOT_MAGIC = 0x53565442;  // "BTVS"
+constexpr uint32_t STORE_VERSION = 1;
+constexpr size_t FILE_HEADER_SIZE = 8;    // magic + version
+constexpr size_t RECORD_HEADER_SIZE = 8;  // crc32 + 记录体长度
+
+// 记录体：[uint16 UUID长度][UUID][值]，CRC32覆盖整个记录体
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> CRC_TABLE = makeCrcTable();
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = CRC_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename T>
+void appendScalar(std::vector<uint8_t>& out, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T readScalar(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void appendFileHeader(std::vector<uint8_t>& out, uint32_t magic) {
+    appendScalar<uint32_t>(out, magic);
+    appendScalar<uint32_t>(out, STORE_VERSION);
+}
+
+void appendRecord(std::vector<uint8_t>& out, const std::string& uuid, const uint8_t* data, size_t size) {
+    size_t start = out.size();
+    uint32_t body_size = static_cast<uint32_t>(sizeof(uint16_t) + uuid.size() + size);
+
+    // 先占位记录头，写完记录体后回填CRC
+    appendScalar<uint32_t>(out, 0);
+    appendScalar<uint32_t>(out, body_size);
+    appendScalar<uint16_t>(out, static_cast<uint16_t>(uuid.size()));
+    out.insert(out.end(), uuid.begin(), uuid.end());
+    out.insert(out.end(), data, data + size);
+
+    uint32_t crc = crc32(out.data() + start + RECORD_HEADER_SIZE, body_size);
+    std::memcpy(out.data() + start, &crc, sizeof(crc));
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+ValueStore::ValueStore(const std::string& directory, const ValueStoreConfig& config)
+    : directory_(directory), config_(config), log_fd_(-1), log_size_(0), commit_source_id_(0) {
+}
+
+ValueStore::~ValueStore() {
+    close();
+}
+
+bool ValueStore::open() {
+    if (isOpen()) {
+        return true;
+    }
+
+    if (g_mkdir_with_parents(directory_.c_str(), 0700) < 0) {
+        std::cerr << "Failed to create value store directory " << directory_
+                  << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 先快照后日志，日志中的记录总是比快照新
+    size_t snapshot_size = 0;
+    size_t log_valid_size = 0;
+    replayFile(snapshotPath(), false, snapshot_size);
+    replayFile(logPath(), true, log_valid_size);
+
+    if (!openLog(log_valid_size == 0)) {
+        return false;
+    }
+
+    // 截掉崩溃时写到一半的尾部，之后的追加才不会接在损坏的记录后面
+    if (log_valid_size > 0 && ftruncate(log_fd_, static_cast<off_t>(log_valid_size)) < 0) {
+        std::cerr << "Failed to truncate value log: " << strerror(errno) << std::endl;
+    }
+    if (log_valid_size > 0) {
+        log_size_ = log_valid_size;
+        lseek(log_fd_, static_cast<off_t>(log_size_), SEEK_SET);
+    }
+
+    std::cout << "Value store recovered " << latest_.size() << " values from " << directory_ << std::endl;
+    return true;
+}
+
+void ValueStore::close() {
+    if (!isOpen()) {
+        return;
+    }
+
+    commit();
+    cancelCommit();
+    ::close(log_fd_);
+    log_fd_ = -1;
+    log_size_ = 0;
+}
+
+bool ValueStore::lookup(const std::string& uuid, ByteValue& value) const {
+    auto it = latest_.find(uuid);
+    if (it == latest_.end()) {
+        return false;
+    }
+
+    value = it->second;
+    return true;
+}
+
+bool ValueStore::append(const std::string& uuid, const uint8_t* data, size_t size) {
+    if (!isOpen() || uuid.size() > UINT16_MAX) {
+        return false;
+    }
+
+    latest_[uuid] = ByteValue(data, size);
+    appendRecord(pending_, uuid, data, size);
+    stats_.appended++;
+
+    if (pending_.size() >= config_.max_batch_bytes) {
+        return commit();
+    }
+
+    scheduleCommit();
+    return true;
+}
+
+bool ValueStore::commit() {
+    cancelCommit();
+
+    if (!writePending()) {
+        scheduleCommit();
+        return false;
+    }
+
+    if (log_size_ > config_.compaction_threshold_bytes) {
+        compact();
+    }
+
+    return true;
+}
+
+bool ValueStore::writePending() {
+    if (!isOpen() || pending_.empty()) {
+        return true;
+    }
+
+    // 一次写入整批记录，一次fdatasync
+    if (!writeAll(log_fd_, pending_.data(), pending_.size()) || fdatasync(log_fd_) < 0) {
+        std::cerr << "Failed to commit value log: " << strerror(errno) << std::endl;
+
+        // 去掉写到一半的记录，保留缓冲等待下次提交
+        if (ftruncate(log_fd_, static_cast<off_t>(log_size_)) == 0) {
+            lseek(log_fd_, static_cast<off_t>(log_size_), SEEK_SET);
+        }
+        return false;
+    }
+
+    log_size_ += pending_.size();
+    pending_.clear();
+    stats_.commits++;
+    return true;
+}
+
+bool ValueStore::compact() {
+    if (!isOpen()) {
+        return false;
+    }
+
+    // 先把缓冲中的记录提交到日志：快照失败时这些写入仍已落盘，
+    // 快照成功时它覆盖的正是日志中已持久化的全部记录
+    cancelCommit();
+    if (!writePending()) {
+        scheduleCommit();
+        return false;
+    }
+
+    std::vector<uint8_t> snapshot;
+    appendFileHeader(snapshot, SNAPSHOT_MAGIC);
+    for (const auto& entry : latest_) {
+        appendRecord(snapshot, entry.first, entry.second.data(), entry.second.size());
+    }
+
+    std::string temp_path = snapshotPath() + ".tmp";
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        std::cerr << "Failed to create value snapshot: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    bool written = writeAll(fd, snapshot.data(), snapshot.size()) && fsync(fd) == 0;
+    ::close(fd);
+    if (!written || rename(temp_path.c_str(), snapshotPath().c_str()) < 0) {
+        std::cerr << "Failed to write value snapshot: " << strerror(errno) << std::endl;
+        unlink(temp_path.c_str());
+        return false;
+    }
+
+    // 目录项也要落盘，否则崩溃后可能仍看到旧快照
+    int dir_fd = ::open(directory_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        fsync(dir_fd);
+        ::close(dir_fd);
+    }
+
+    // 快照已落盘，此时崩溃只会重放一遍与快照相同的日志
+    ::close(log_fd_);
+    log_fd_ = -1;
+    stats_.compactions++;
+    return openLog(true);
+}
+
+std::string ValueStore::logPath() const {
+    return directory_ + "/values.log";
+}
+
+std::string ValueStore::snapshotPath() const {
+    return directory_ + "/values.snapshot";
+}
+
+bool ValueStore::replayFile(const std::string& path, bool is_log, size_t& valid_size) {
+    valid_size = 0;
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno == ENOENT;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Failed to map " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(mapped);
+    uint32_t expected_magic = is_log ? LOG_MAGIC : SNAPSHOT_MAGIC;
+    if (size < FILE_HEADER_SIZE || readScalar<uint32_t>(data) != expected_magic ||
+        readScalar<uint32_t>(data + 4) != STORE_VERSION) {
+        std::cerr << "Ignoring invalid value store file: " << path << std::endl;
+        stats_.discarded_bytes += size;
+        munmap(mapped, size);
+        return false;
+    }
+
+    // 遇到不完整或校验失败的记录即停止，之后的内容视为崩溃留下的尾部
+    size_t pos = FILE_HEADER_SIZE;
+    while (pos + RECORD_HEADER_SIZE <= size) {
+        uint32_t crc = readScalar<uint32_t>(data + pos);
+        uint32_t body_size = readScalar<uint32_t>(data + pos + 4);
+        const uint8_t* body = data + pos + RECORD_HEADER_SIZE;
+
+        if (body_size < sizeof(uint16_t) || body_size > size - pos - RECORD_HEADER_SIZE ||
+            crc32(body, body_size) != crc) {
+            break;
+        }
+
+        uint16_t uuid_size = readScalar<uint16_t>(body);
+        if (uuid_size > body_size - sizeof(uint16_t)) {
+            break;
+        }
+
+        std::string uuid(reinterpret_cast<const char*>(body + sizeof(uint16_t)), uuid_size);
+        const uint8_t* value = body + sizeof(uint16_t) + uuid_size;
+        latest_[uuid] = ByteValue(value, body_size - sizeof(uint16_t) - uuid_size);
+        stats_.recovered++;
+        pos += RECORD_HEADER_SIZE + body_size;
+    }
+
+    if (pos < size) {
+        std::cerr << "Discarding " << (size - pos) << " trailing bytes of " << path << std::endl;
+        stats_.discarded_bytes += size - pos;
+    }
+
+    valid_size = pos;
+    munmap(mapped, size);
+    return true;
+}
+
+bool ValueStore::openLog(bool truncate) {
+    int flags = O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0);
+    log_fd_ = ::open(logPath().c_str(), flags, 0600);
+    if (log_fd_ < 0) {
+        std::cerr << "Failed to open value log: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (truncate) {
+        std::vector<uint8_t> header;
+        appendFileHeader(header, LOG_MAGIC);
+        if (!writeAll(log_fd_, header.data(), header.size()) || fdatasync(log_fd_) < 0) {
+            std::cerr << "Failed to initialize value log: " << strerror(errno) << std::endl;
+            ::close(log_fd_);
+            log_fd_ = -1;
+            return false;
+        }
+    }
+
+    log_size_ = FILE_HEADER_SIZE;
+    return true;
+}
+
+void ValueStore::scheduleCommit() {
+    if (commit_source_id_ == 0) {
+        commit_source_id_ = g_timeout_add(config_.commit_interval_ms, onCommit, this);
+    }
+}
+
+void ValueStore::cancelCommit() {
+    if (commit_source_id_ != 0) {
+        g_source_remove(commit_source_id_);
+        commit_source_id_ = 0;
+    }
+}
+
+gboolean ValueStore::onCommit(gpointer user_data) {
+    ValueStore* store = static_cast<ValueStore*>(user_data);
+
+    // 源在返回G_SOURCE_REMOVE后自动销毁，这里只需清除ID
+    store->commit_source_id_ = 0;
+    store->commit();
+    return G_SOURCE_REMOVE;
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,212 @@
+#include "write_assembler.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <glib-2.0/glib.h>
+
+namespace Bluetooth {
+
+WriteAssembler::WriteAssembler()
+    : timer_id_(0) {
+}
+
+WriteAssembler::~WriteAssembler() {
+    if (timer_id_ != 0) {
+        g_source_remove(timer_id_);
+        timer_id_ = 0;
+    }
+}
+
+void WriteAssembler::setConfig(const WriteAssemblyConfig& config) {
+    config_ = config;
+    armTimer();
+}
+
+WriteFragmentStatus WriteAssembler::addFragment(const std::string& device_path, uint16_t offset,
+                                                const uint8_t* data, size_t size) {
+    gint64 now = g_get_monotonic_time();
+
+    if (offset == 0) {
+        Assembly assembly;
+        assembly.started = now;
+        assembly.executing = false;
+        assembly.executed_size = 0;
+        assemblies_[device_path] = std::move(assembly);
+        armTimer();
+    }
+
+    // 执行到一半的长写不再接受预备片段，新的长写从偏移0开始
+    auto it = assemblies_.find(device_path);
+    if (it == assemblies_.end() || it->second.executing || offset > it->second.buffer.size()) {
+        stats_.rejected++;
+        return WriteFragmentStatus::INVALID_OFFSET;
+    }
+
+    Assembly& assembly = it->second;
+    if (isExpired(assembly, now)) {
+        abandon(it);
+        return WriteFragmentStatus::ABANDONED;
+    }
+
+    if (static_cast<size_t>(offset) + size > config_.max_value_size) {
+        stats_.rejected++;
+        return WriteFragmentStatus::INVALID_LENGTH;
+    }
+
+    // 允许覆盖已收到的数据，但不允许留下空洞
+    if (offset + size > assembly.buffer.size()) {
+        assembly.buffer.resize(offset + size);
+    }
+    if (size > 0) {
+        std::memcpy(assembly.buffer.data() + offset, data, size);
+    }
+
+    stats_.fragments++;
+    return WriteFragmentStatus::ACCEPTED;
+}
+
+WriteFragmentStatus WriteAssembler::executeFragment(const std::string& device_path, uint16_t offset,
+                                                    const uint8_t* data, size_t size, ByteValue& value) {
+    auto it = assemblies_.find(device_path);
+
+    // 没有预备阶段：BlueZ把连续的预备片段合并后一次交给应用，偏移为0的片段就是完整的值
+    if (it == assemblies_.end()) {
+        if (offset != 0) {
+            stats_.rejected++;
+            return WriteFragmentStatus::INVALID_OFFSET;
+        }
+        if (size > config_.max_value_size) {
+            stats_.rejected++;
+            return WriteFragmentStatus::INVALID_LENGTH;
+        }
+
+        value.assign(data, size);
+        stats_.fragments++;
+        stats_.committed++;
+        return WriteFragmentStatus::COMPLETE;
+    }
+
+    Assembly& assembly = it->second;
+    if (isExpired(assembly, g_get_monotonic_time())) {
+        abandon(it);
+        return WriteFragmentStatus::ABANDONED;
+    }
+
+    // 执行的片段与预备时相同，超出预备范围说明两者不一致
+    if (static_cast<size_t>(offset) + size > assembly.buffer.size()) {
+        stats_.rejected++;
+        assemblies_.erase(it);
+        armTimer();
+        return WriteFragmentStatus::INVALID_OFFSET;
+    }
+
+    if (size > 0) {
+        std::memcpy(assembly.buffer.data() + offset, data, size);
+    }
+    stats_.fragments++;
+    assembly.executed_size = std::max(assembly.executed_size, static_cast<size_t>(offset) + size);
+
+    WriteFragmentStatus status = WriteFragmentStatus::ACCEPTED;
+    if (!assembly.executing) {
+        // 首个执行片段：完整的值在回复这个片段之前交给调用者校验
+        assembly.executing = true;
+        value = assembly.buffer;
+        stats_.committed++;
+        status = WriteFragmentStatus::COMPLETE;
+    }
+
+    if (assembly.executed_size >= assembly.buffer.size()) {
+        assemblies_.erase(it);
+        armTimer();
+    }
+    return status;
+}
+
+void WriteAssembler::discard(const std::string& device_path) {
+    if (assemblies_.erase(device_path) > 0) {
+        armTimer();
+    }
+}
+
+bool WriteAssembler::isAssembling(const std::string& device_path) const {
+    return assemblies_.find(device_path) != assemblies_.end();
+}
+
+void WriteAssembler::discardAll() {
+    if (timer_id_ != 0) {
+        g_source_remove(timer_id_);
+        timer_id_ = 0;
+    }
+
+    stats_.abandoned += assemblies_.size();
+    assemblies_.clear();
+}
+
+WriteAssemblyStatistics WriteAssembler::getStatistics() const {
+    WriteAssemblyStatistics stats = stats_;
+    stats.active = assemblies_.size();
+    return stats;
+}
+
+bool WriteAssembler::isExpired(const Assembly& assembly, gint64 now) const {
+    return now - assembly.started > static_cast<gint64>(config_.abandon_ms) * 1000;
+}
+
+void WriteAssembler::abandon(std::map<std::string, Assembly>::iterator it) {
+    std::cerr << "Long write from " << it->first << " abandoned after "
+              << config_.abandon_ms << "ms" << std::endl;
+    assemblies_.erase(it);
+    stats_.abandoned++;
+    armTimer();
+}
+
+void WriteAssembler::armTimer() {
+    if (timer_id_ != 0) {
+        g_source_remove(timer_id_);
+        timer_id_ = 0;
+    }
+
+    if (assemblies_.empty()) {
+        return;
+    }
+
+    // 客户端取消执行（Execute Write标志为0）时BlueZ不通知应用，只能由超时回收缓冲
+    gint64 earliest = G_MAXINT64;
+    for (const auto& entry : assemblies_) {
+        earliest = std::min(earliest, entry.second.started);
+    }
+
+    gint64 deadline = earliest + static_cast<gint64>(config_.abandon_ms) * 1000;
+    gint64 delay_us = std::max<gint64>(deadline - g_get_monotonic_time(), 0);
+    timer_id_ = g_timeout_add(static_cast<guint>(delay_us / 1000) + 1, onTimeout, this);
+}
+
+void WriteAssembler::handleTimeouts() {
+    gint64 now = g_get_monotonic_time();
+
+    // 超时的长写只丢弃，不提交：客户端没有收到执行结果，提交会让它不知道的值生效
+    for (auto it = assemblies_.begin(); it != assemblies_.end();) {
+        if (isExpired(it->second, now)) {
+            std::cerr << "Long write from " << it->first << " abandoned after "
+                      << config_.abandon_ms << "ms" << std::endl;
+            it = assemblies_.erase(it);
+            stats_.abandoned++;
+        } else {
+            ++it;
+        }
+    }
+
+    armTimer();
+}
+
+gboolean WriteAssembler::onTimeout(gpointer user_data) {
+    WriteAssembler* assembler = static_cast<WriteAssembler*>(user_data);
+
+    // 源在返回G_SOURCE_REMOVE后自动销毁，handleTimeouts会按需重新安排
+    assembler->timer_id_ = 0;
+    assembler->handleTimeouts();
+    return G_SOURCE_REMOVE;
+}
+
+} // namespace Bluetooth
@@ -0,0 +1,105 @@
+#include "gatt_characteristic.h"
+#include "test_support.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+
+using namespace Bluetooth;
+
+static const char* const DEVICE_PATH = "/org/bluez/hci0/dev_00_11_22_33_44_55";
+
+// 从BlueZ一端接收一个通知，等待不超过timeout_ms
+static bool receiveNotification(int fd, ByteValue& value, guint timeout_ms) {
+    uint8_t buffer[512];
+    ssize_t received = -1;
+    TestSupport::runUntil([&]() {
+        received = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        return received >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+    }, timeout_ms);
+
+    if (received < 0) {
+        return false;
+    }
+    value.assign(buffer, static_cast<size_t>(received));
+    return true;
+}
+
+// setValue经由AcquireNotify套接字送达，每次写入对应一个通知
+static void testRoundTrip() {
+    GattCharacteristic characteristic("0000aaaa-0000-1000-8000-00805f9b34fb",
+                                      { CharacteristicFlags::READ, CharacteristicFlags::NOTIFY });
+
+    int fd = characteristic.acquireNotify(DEVICE_PATH, 185);
+    CHECK(fd >= 0);
+    CHECK(characteristic.isNotifyAcquired());
+    CHECK(characteristic.getNotifyMtu(DEVICE_PATH) == 185);
+
+    // 同一设备不能重复获取
+    CHECK(characteristic.acquireNotify(DEVICE_PATH, 185) < 0);
+
+    for (uint8_t i = 0; i < 3; ++i) {
+        CHECK(characteristic.setValue(ByteValue{i, static_cast<uint8_t>(i + 1), 0x7f}));
+    }
+
+    for (uint8_t i = 0; i < 3; ++i) {
+        ByteValue received;
+        CHECK(receiveNotification(fd, received, 1000));
+        CHECK(received == (ByteValue{i, static_cast<uint8_t>(i + 1), 0x7f}));
+    }
+
+    SubscriberStatistics stats;
+    CHECK(characteristic.getSubscriberStatistics(DEVICE_PATH, stats));
+    CHECK(stats.sent == 3);
+    CHECK(stats.dropped == 0);
+    CHECK(stats.truncated == 0);
+
+    close(fd);
+}
+
+// BlueZ关闭套接字后会话被移除，特征值不再持有通知套接字
+static void testPeerHangup() {
+    GattCharacteristic characteristic("0000aaab-0000-1000-8000-00805f9b34fb",
+                                      { CharacteristicFlags::NOTIFY });
+
+    int fd = characteristic.acquireNotify(DEVICE_PATH, DEFAULT_ATT_MTU);
+    CHECK(fd >= 0);
+    close(fd);
+
+    CHECK(TestSupport::runUntil([&]() { return characteristic.getSubscribers().empty(); }, 1000));
+    CHECK(!characteristic.isNotifyAcquired());
+
+    // 会话已移除，可以重新获取
+    fd = characteristic.acquireNotify(DEVICE_PATH, DEFAULT_ATT_MTU);
+    CHECK(fd >= 0);
+    close(fd);
+}
+
+// 超过MTU-3的值截断发出并计数
+static void testTruncation() {
+    GattCharacteristic characteristic("0000aaac-0000-1000-8000-00805f9b34fb",
+                                      { CharacteristicFlags::NOTIFY });
+
+    int fd = characteristic.acquireNotify(DEVICE_PATH, DEFAULT_ATT_MTU);
+    CHECK(fd >= 0);
+
+    ByteValue value(40, 0x5a);
+    CHECK(characteristic.setValue(value));
+
+    ByteValue received;
+    CHECK(receiveNotification(fd, received, 1000));
+    CHECK(received.size() == DEFAULT_ATT_MTU - ATT_NOTIFICATION_HEADER_SIZE);
+
+    SubscriberStatistics stats;
+    CHECK(characteristic.getSubscriberStatistics(DEVICE_PATH, stats));
+    CHECK(stats.sent == 1);
+    CHECK(stats.truncated == 1);
+
+    close(fd);
+}
+
+int main() {
+    testRoundTrip();
+    testTruncation();
+    testPeerHangup();
+    return TEST_RESULT();
+}
@@ -0,0 +1,96 @@
+#include "byte_value.h"
+#include "test_support.h"
+#include <utility>
+
+using namespace Bluetooth;
+
+static ByteValue sequence(size_t size) {
+    ByteValue value;
+    for (size_t i = 0; i < size; ++i) {
+        value.push_back(static_cast<uint8_t>(i));
+    }
+    return value;
+}
+
+// 内联容量以内不分配堆内存，超过后转为堆存储且内容不变
+static void testInlineToHeap() {
+    ByteValue value = sequence(ByteValue::INLINE_CAPACITY);
+    CHECK(value.isInline());
+    CHECK(value.size() == ByteValue::INLINE_CAPACITY);
+
+    value.push_back(0xff);
+    CHECK(!value.isInline());
+    CHECK(value.size() == ByteValue::INLINE_CAPACITY + 1);
+    for (size_t i = 0; i < ByteValue::INLINE_CAPACITY; ++i) {
+        CHECK(value[i] == static_cast<uint8_t>(i));
+    }
+    CHECK(value[ByteValue::INLINE_CAPACITY] == 0xff);
+}
+
+// 拷贝与移动在内联和堆两种存储下都保持内容独立
+static void testCopyAndMove() {
+    for (size_t size : { size_t(4), size_t(64) }) {
+        ByteValue original = sequence(size);
+        ByteValue copy(original);
+        CHECK(copy == original);
+
+        copy[0] = 0xaa;
+        CHECK(copy != original);
+        CHECK(original[0] == 0);
+
+        ByteValue moved(std::move(copy));
+        CHECK(moved.size() == size);
+        CHECK(moved[0] == 0xaa);
+
+        ByteValue assigned;
+        assigned = original;
+        CHECK(assigned == original);
+        assigned = std::move(moved);
+        CHECK(assigned[0] == 0xaa);
+    }
+}
+
+// 追加自身的数据时扩容不会使源指针失效
+static void testAppendSelf() {
+    ByteValue value = sequence(20);
+    value.append(value.data(), value.size());
+    CHECK(value.size() == 40);
+    for (size_t i = 0; i < 20; ++i) {
+        CHECK(value[i] == value[i + 20]);
+    }
+}
+
+// 内联与堆存储之间交换
+static void testSwap() {
+    ByteValue small = sequence(3);
+    ByteValue large = sequence(100);
+    small.swap(large);
+    CHECK(small.size() == 100);
+    CHECK(large.size() == 3);
+    CHECK(small == sequence(100));
+    CHECK(large == sequence(3));
+}
+
+// resize补齐填充值，视图截取不越界
+static void testResizeAndView() {
+    ByteValue value{ 1, 2, 3 };
+    value.resize(6, 9);
+    CHECK(value == (ByteValue{ 1, 2, 3, 9, 9, 9 }));
+
+    ByteView view(value);
+    CHECK(view.size() == 6);
+    ByteView tail = view.subview(4, 10);
+    CHECK(tail.size() == 2);
+    CHECK(tail[0] == 9);
+    CHECK(tail.toByteValue() == (ByteValue{ 9, 9 }));
+    CHECK(value.toVector() == (std::vector<uint8_t>{ 1, 2, 3, 9, 9, 9 }));
+}
+
+int main() {
+    testInlineToHeap();
+    testCopyAndMove();
+    testAppendSelf();
+    testSwap();
+    testResizeAndView();
+    return TEST_RESULT();
+}
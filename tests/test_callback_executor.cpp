@@ -0,0 +1,87 @@
+#include "callback_executor.h"
+#include "test_support.h"
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace Bluetooth;
+
+// 排队数达到上限时拒绝提交，任务开始执行后才腾出位置
+static void testQueueLimit() {
+    GMainContext* work_context = g_main_context_new();
+    ExecutorConfig config;
+    config.max_queue_depth = 2;
+
+    std::vector<int> executed;
+    size_t completed = 0;
+    {
+        CallbackExecutor executor(work_context, config);
+        CHECK(executor.submit([&]() { executed.push_back(1); }, [&]() { ++completed; }));
+        CHECK(executor.submit([&]() { executed.push_back(2); }, [&]() { ++completed; }));
+        CHECK(!executor.submit([&]() { executed.push_back(3); }, [&]() { ++completed; }));
+
+        ExecutorStatistics stats = executor.getStatistics();
+        CHECK(stats.queued == 2);
+        CHECK(stats.peak_queued == 2);
+        CHECK(stats.rejected == 1);
+
+        while (g_main_context_iteration(work_context, FALSE)) {
+        }
+        CHECK(executed == (std::vector<int>{ 1, 2 }));
+        CHECK(executor.getStatistics().queued == 0);
+        CHECK(TestSupport::runUntil([&]() { return completed == 2; }, 1000));
+
+        // 队列排空后可以再次提交
+        CHECK(executor.submit([&]() { executed.push_back(4); }, nullptr));
+        while (g_main_context_iteration(work_context, FALSE)) {
+        }
+        CHECK(executed.back() == 4);
+        CHECK(executor.getStatistics().rejected == 1);
+    }
+
+    g_main_context_unref(work_context);
+}
+
+// 线程池模式：占满唯一的工作线程后，排队上限同样生效
+static void testThreadPoolQueueLimit() {
+    ExecutorConfig config;
+    config.max_threads = 1;
+    config.max_queue_depth = 1;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool started = false;
+    bool release = false;
+    size_t completed = 0;
+
+    CallbackExecutor executor(config);
+    CHECK(executor.submit([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        started = true;
+        cond.notify_all();
+        cond.wait(lock, [&]() { return release; });
+    }, [&]() { ++completed; }));
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&]() { return started; });
+    }
+
+    CHECK(executor.submit([]() {}, [&]() { ++completed; }));
+    CHECK(!executor.submit([]() {}, [&]() { ++completed; }));
+    CHECK(executor.getStatistics().rejected == 1);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    cond.notify_all();
+
+    CHECK(TestSupport::runUntil([&]() { return completed == 2; }, 1000));
+}
+
+int main() {
+    testQueueLimit();
+    testThreadPoolQueueLimit();
+    return TEST_RESULT();
+}
@@ -0,0 +1,112 @@
+#include "context_handoff.h"
+#include "test_support.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Bluetooth;
+
+// 同一生产者投递的任务按顺序执行，每次分发不超过批量上限
+static void testOrderAndBatchLimit() {
+    GMainContext* context = g_main_context_new();
+    ContextHandoff handoff(context);
+
+    const size_t count = CONTEXT_HANDOFF_BATCH_LIMIT * 3;
+    std::vector<size_t> executed;
+    for (size_t i = 0; i < count; ++i) {
+        handoff.post([&executed, i]() { executed.push_back(i); });
+    }
+    CHECK(handoff.getPendingCount() == count);
+
+    g_main_context_iteration(context, FALSE);
+    CHECK(executed.size() == CONTEXT_HANDOFF_BATCH_LIMIT);
+
+    CHECK(TestSupport::runUntil([&]() { return executed.size() == count; }, 1000, context));
+    bool ordered = true;
+    for (size_t i = 0; i < executed.size(); ++i) {
+        ordered = ordered && executed[i] == i;
+    }
+    CHECK(ordered);
+    CHECK(handoff.getPendingCount() == 0);
+
+    g_main_context_unref(context);
+}
+
+// 析构时丢弃尚未执行的任务
+static void testDestroyDropsPendingTasks() {
+    GMainContext* context = g_main_context_new();
+    auto token = std::make_shared<int>(0);
+    bool executed = false;
+    {
+        ContextHandoff handoff(context);
+        handoff.post([token, &executed]() { executed = true; });
+        CHECK(token.use_count() == 2);
+    }
+    CHECK(token.use_count() == 1);
+
+    while (g_main_context_iteration(context, FALSE)) {
+    }
+    CHECK(!executed);
+
+    g_main_context_unref(context);
+}
+
+// 多个生产者线程投递任务，任务执行后才投递下一个（一问一答）。
+// 每一轮都需要一次唤醒，没有周期定时器兜底，丢失的唤醒会让某个生产者停住直到期限
+static void testPingPongWakeups() {
+    const size_t producer_count = 4;
+    const uint64_t rounds = 50000;
+
+    GMainContext* context = g_main_context_new();
+    ContextHandoff handoff(context);
+    std::unique_ptr<std::atomic<uint64_t>[]> acknowledged(new std::atomic<uint64_t>[producer_count]);
+    std::atomic<bool> stop(false);
+    for (size_t i = 0; i < producer_count; ++i) {
+        acknowledged[i].store(0);
+    }
+
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producer_count; ++i) {
+        producers.emplace_back([&, i]() {
+            for (uint64_t round = 1; round <= rounds && !stop.load(); ++round) {
+                handoff.post([&acknowledged, i, round]() {
+                    acknowledged[i].store(round, std::memory_order_release);
+                });
+                while (acknowledged[i].load(std::memory_order_acquire) != round && !stop.load()) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    bool finished = TestSupport::runUntil([&]() {
+        for (size_t i = 0; i < producer_count; ++i) {
+            if (acknowledged[i].load(std::memory_order_acquire) != rounds) {
+                return false;
+            }
+        }
+        return true;
+    }, 30000, context);
+    CHECK(finished);
+
+    stop.store(true);
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    if (!finished) {
+        for (size_t i = 0; i < producer_count; ++i) {
+            std::cerr << "producer " << i << " stalled at round " << acknowledged[i].load() << std::endl;
+        }
+    }
+
+    // 生产者停止后投递的任务仍在队列中，随handoff析构丢弃
+    g_main_context_unref(context);
+}
+
+int main() {
+    testOrderAndBatchLimit();
+    testDestroyDropsPendingTasks();
+    testPingPongWakeups();
+    return TEST_RESULT();
+}
@@ -0,0 +1,136 @@
+#include "coroutine_support.h"
+#include "async_completion.h"
+#include "test_support.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Bluetooth;
+
+// 模拟协程读取处理函数：等待一段时间后以给定字节完成
+static CoTask delayedRead(guint delay_ms, uint8_t byte, ReadCompletion completion) {
+    co_await sleepFor(delay_ms);
+    completion.complete(ByteValue{byte});
+}
+
+// 记录完成是否生效的读取处理函数
+static CoTask delayedReadTracked(guint delay_ms, ReadCompletion completion, int* state) {
+    co_await sleepFor(delay_ms);
+    *state = completion.complete(ByteValue{0x01}) ? 1 : 2;
+}
+
+// 模拟协程写入处理函数：等待外设应答后接受，超时则拒绝
+static CoTask writeAfterAck(int fd, guint timeout_ms, WriteCompletion completion) {
+    GIOCondition ready = co_await waitForFd(fd, G_IO_IN, timeout_ms);
+    uint8_t ack = 0;
+    if ((ready & G_IO_IN) && read(fd, &ack, 1) == 1 && ack == 0x06) {
+        completion.accept();
+    } else {
+        completion.reject(AttError::FAILED);
+    }
+}
+
+// 挂起中的处理函数互不阻塞：总耗时接近单个处理函数的等待时间
+static void testConcurrentReads() {
+    const int HANDLER_COUNT = 20;
+    const guint DELAY_MS = 100;
+
+    std::vector<CompletionResult> results(HANDLER_COUNT);
+    int finished = 0;
+
+    gint64 start = g_get_monotonic_time();
+    for (int i = 0; i < HANDLER_COUNT; ++i) {
+        auto state = CompletionState::create([&results, &finished, i](const CompletionResult& result) {
+            results[i] = result;
+            ++finished;
+        }, ASYNC_CALLBACK_DEFAULT_TIMEOUT_MS);
+        delayedRead(DELAY_MS, static_cast<uint8_t>(i), ReadCompletion(state));
+    }
+
+    CHECK(finished == 0);
+    CHECK(TestSupport::runUntil([&]() { return finished == HANDLER_COUNT; }, 5000));
+    gint64 elapsed_ms = (g_get_monotonic_time() - start) / 1000;
+
+    CHECK(elapsed_ms < HANDLER_COUNT * DELAY_MS / 2);
+    for (int i = 0; i < HANDLER_COUNT; ++i) {
+        CHECK(results[i].success);
+        CHECK(!results[i].timed_out);
+        CHECK(results[i].value == ByteValue{static_cast<uint8_t>(i)});
+    }
+}
+
+// fd就绪时恢复协程并接受写入
+static void testWriteResumedByFd() {
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+
+    bool done = false;
+    CompletionResult outcome;
+    auto state = CompletionState::create([&](const CompletionResult& result) {
+        outcome = result;
+        done = true;
+    }, ASYNC_CALLBACK_DEFAULT_TIMEOUT_MS);
+    writeAfterAck(fds[0], 1000, WriteCompletion(state));
+
+    // 处理函数挂起等待应答，此时还没有完成
+    g_main_context_iteration(nullptr, FALSE);
+    CHECK(!done);
+
+    uint8_t ack = 0x06;
+    CHECK(write(fds[1], &ack, 1) == 1);
+    CHECK(TestSupport::runUntil([&]() { return done; }, 2000));
+    CHECK(outcome.success);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// fd超时时协程同样恢复，写入被拒绝
+static void testWriteFdTimeout() {
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+
+    bool done = false;
+    CompletionResult outcome;
+    auto state = CompletionState::create([&](const CompletionResult& result) {
+        outcome = result;
+        done = true;
+    }, ASYNC_CALLBACK_DEFAULT_TIMEOUT_MS);
+    writeAfterAck(fds[0], 50, WriteCompletion(state));
+
+    CHECK(TestSupport::runUntil([&]() { return done; }, 2000));
+    CHECK(!outcome.success);
+    CHECK(!outcome.timed_out);
+    CHECK(outcome.error == AttError::FAILED);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// 处理函数超过异步回调超时仍未完成时，请求以超时结束，之后的完成不再生效
+static void testHandlerTimeout() {
+    bool done = false;
+    CompletionResult outcome;
+    auto state = CompletionState::create([&](const CompletionResult& result) {
+        outcome = result;
+        done = true;
+    }, 50);
+    int late_completion = 0;
+    delayedReadTracked(300, ReadCompletion(state), &late_completion);
+
+    CHECK(TestSupport::runUntil([&]() { return done; }, 2000));
+    CHECK(outcome.timed_out);
+    CHECK(late_completion == 0);
+
+    // 处理函数恢复后的完成被忽略
+    CHECK(TestSupport::runUntil([&]() { return late_completion != 0; }, 2000));
+    CHECK(late_completion == 2);
+}
+
+int main() {
+    testConcurrentReads();
+    testWriteResumedByFd();
+    testWriteFdTimeout();
+    testHandlerTimeout();
+    return TEST_RESULT();
+}
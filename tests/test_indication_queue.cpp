@@ -0,0 +1,112 @@
+#include "indication_queue.h"
+#include "test_support.h"
+#include <map>
+
+using namespace Bluetooth;
+
+// 模拟发送端：记录发送次数，接收方列表可在测试中修改
+struct Harness {
+    std::vector<std::string> recipients;
+    int sends = 0;
+    std::map<uint64_t, IndicationStatus> results;
+    std::vector<uint64_t> order;
+    IndicationQueue queue;
+
+    explicit Harness(std::vector<std::string> initial)
+        : recipients(initial),
+          queue([this](const ValueSnapshot&) { ++sends; return true; },
+                [this]() { return recipients; }) {}
+
+    uint64_t submit(uint8_t byte) {
+        return queue.submit(ValueSnapshot(ByteValue{byte}), [this](uint64_t id, IndicationStatus status) {
+            results[id] = status;
+            order.push_back(id);
+        });
+    }
+};
+
+// 每个接收方按各自的顺序确认，所有接收方都确认后指示才完成
+static void testPerRecipientConfirm() {
+    Harness harness({ ":1.10", ":1.11" });
+    uint64_t first = harness.submit(1);
+    uint64_t second = harness.submit(2);
+    CHECK(harness.sends == 2);
+
+    // 同一接收方连续确认两个指示，另一方尚未确认，两个都不能完成
+    CHECK(harness.queue.confirm(":1.10"));
+    CHECK(harness.queue.confirm(":1.10"));
+    CHECK(harness.results.empty());
+
+    CHECK(harness.queue.confirm(":1.11"));
+    CHECK(harness.results.size() == 1);
+    CHECK(harness.results[first] == IndicationStatus::CONFIRMED);
+
+    CHECK(harness.queue.confirm(":1.11"));
+    CHECK(harness.results[second] == IndicationStatus::CONFIRMED);
+    CHECK(harness.order == (std::vector<uint64_t>{ first, second }));
+
+    // 多余的Confirm不会记入任何指示
+    CHECK(!harness.queue.confirm(":1.11"));
+    CHECK(harness.queue.getStatistics().confirmed == 2);
+}
+
+// BlueZ为每个设备各转发一次Confirm：按配置的次数记账
+static void testConfirmsPerRecipient() {
+    Harness harness({ ":1.5" });
+    IndicationConfig config;
+    config.confirms_per_recipient = 3;
+    harness.queue.setConfig(config);
+
+    uint64_t id = harness.submit(1);
+    CHECK(harness.queue.confirm(":1.5"));
+    CHECK(harness.queue.confirm(":1.5"));
+    CHECK(harness.results.empty());
+    CHECK(harness.queue.confirm(":1.5"));
+    CHECK(harness.results[id] == IndicationStatus::CONFIRMED);
+}
+
+// 取消订阅的接收方不再需要确认
+static void testRemoveRecipient() {
+    Harness harness({ ":1.10", ":1.11" });
+    uint64_t id = harness.submit(1);
+
+    CHECK(harness.queue.confirm(":1.10"));
+    CHECK(harness.results.empty());
+    harness.queue.removeRecipient(":1.11");
+    CHECK(harness.results[id] == IndicationStatus::CONFIRMED);
+}
+
+// 无人确认时超时重发；已有接收方确认时不再广播，只延长等待直至超时失败
+static void testRetransmission() {
+    IndicationConfig config;
+    config.timeout_ms = 20;
+    config.max_retries = 2;
+
+    Harness silent({ ":1.10" });
+    silent.queue.setConfig(config);
+    uint64_t lost = silent.submit(1);
+    CHECK(TestSupport::runUntil([&]() { return silent.results.count(lost) > 0; }, 2000));
+    CHECK(silent.results[lost] == IndicationStatus::TIMED_OUT);
+    CHECK(silent.sends == 3);
+    CHECK(silent.queue.getStatistics().retransmitted == 2);
+
+    Harness partial({ ":1.10", ":1.11" });
+    partial.queue.setConfig(config);
+    uint64_t id = partial.submit(1);
+    CHECK(partial.queue.confirm(":1.10"));
+    CHECK(TestSupport::runUntil([&]() { return partial.results.count(id) > 0; }, 2000));
+    CHECK(partial.results[id] == IndicationStatus::TIMED_OUT);
+    CHECK(partial.sends == 1);
+
+    IndicationStatistics stats = partial.queue.getStatistics();
+    CHECK(stats.retransmitted == 0);
+    CHECK(stats.partial_timeouts == 2);
+}
+
+int main() {
+    testPerRecipientConfirm();
+    testConfirmsPerRecipient();
+    testRemoveRecipient();
+    testRetransmission();
+    return TEST_RESULT();
+}
@@ -0,0 +1,76 @@
+#include "gatt_characteristic.h"
+#include "test_support.h"
+
+using namespace Bluetooth;
+
+static const char* const DEVICE_PATH = "/org/bluez/hci0/dev_00_11_22_33_44_66";
+
+static ByteValue makeValue(size_t size, uint8_t seed) {
+    ByteValue value(size);
+    for (size_t i = 0; i < size; ++i) {
+        value[i] = static_cast<uint8_t>(seed + i);
+    }
+    return value;
+}
+
+// 公开受保护的ReadValue处理入口，mtu为0表示BlueZ未提供MTU
+class TestCharacteristic : public GattCharacteristic {
+public:
+    TestCharacteristic()
+        : GattCharacteristic("0000eef2-0000-1000-8000-00805f9b34fb", { CharacteristicFlags::READ }) {
+    }
+
+    ByteValue read(uint16_t offset, uint16_t mtu) {
+        GVariantBuilder builder;
+        g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sv}"));
+        g_variant_builder_add(&builder, "{sv}", "device", g_variant_new_object_path(DEVICE_PATH));
+        g_variant_builder_add(&builder, "{sv}", "offset", g_variant_new_uint16(offset));
+        if (mtu > 0) {
+            g_variant_builder_add(&builder, "{sv}", "mtu", g_variant_new_uint16(mtu));
+        }
+        GVariant* options = g_variant_ref_sink(g_variant_builder_end(&builder));
+
+        ByteValue result;
+        GVariant* value = handleReadValue(options);
+        if (value) {
+            g_variant_ref_sink(value);
+            gsize size = 0;
+            const uint8_t* data = static_cast<const uint8_t*>(
+                g_variant_get_fixed_array(value, &size, sizeof(uint8_t)));
+            result = ByteValue(data, size);
+            g_variant_unref(value);
+        }
+        g_variant_unref(options);
+        return result;
+    }
+};
+
+// Read Blob沿用首次读取的快照，读取期间的新值不会混入
+static void testBlobReadsUseSnapshot() {
+    TestCharacteristic characteristic;
+    ByteValue first = makeValue(100, 0);
+    ByteValue second = makeValue(100, 100);
+    CHECK(characteristic.setValue(first));
+
+    CHECK(characteristic.read(0, 23) == ByteValue(first.data(), 22));
+    CHECK(characteristic.setValue(second));
+    CHECK(characteristic.read(22, 23) == ByteValue(first.data() + 22, 22));
+}
+
+// 未提供MTU时一次返回全部数据，不保留快照：之后的Read Blob读到当前值
+static void testFullReadReleasesSnapshot() {
+    TestCharacteristic characteristic;
+    ByteValue first = makeValue(100, 0);
+    ByteValue second = makeValue(100, 100);
+    CHECK(characteristic.setValue(first));
+
+    CHECK(characteristic.read(0, 0) == first);
+    CHECK(characteristic.setValue(second));
+    CHECK(characteristic.read(50, 0) == ByteValue(second.data() + 50, 50));
+}
+
+int main() {
+    testBlobReadsUseSnapshot();
+    testFullReadReleasesSnapshot();
+    return TEST_RESULT();
+}
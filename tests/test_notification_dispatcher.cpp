@@ -0,0 +1,175 @@
+#include "notification_dispatcher.h"
+#include "gatt_characteristic.h"
+#include "test_support.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Bluetooth;
+
+// 每个优先级若干特征值；没有订阅者，发送只更新分发器的统计
+struct Harness {
+    std::vector<std::unique_ptr<GattCharacteristic>> characteristics;
+    NotificationDispatcher dispatcher;
+
+    explicit Harness(const DispatcherConfig& config) : dispatcher(config) {}
+
+    GattCharacteristic* add(NotificationPriority priority) {
+        char uuid[40];
+        std::snprintf(uuid, sizeof(uuid), "0000%04zx-0000-1000-8000-00805f9b34fb", 0xd000 + characteristics.size());
+        characteristics.push_back(std::make_unique<GattCharacteristic>(
+            uuid, std::vector<CharacteristicFlags>{ CharacteristicFlags::NOTIFY }));
+        characteristics.back()->setPriority(priority);
+        return characteristics.back().get();
+    }
+
+    void submit(NotificationPriority priority, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            CHECK(dispatcher.submit(add(priority)));
+        }
+    }
+
+    uint64_t dispatched(NotificationPriority priority) const {
+        return dispatcher.getStatistics(priority).dispatched;
+    }
+
+    // 运行一次主循环迭代，batch_limit为1时恰好发送一个通知，返回其类别：C/I/B，没有发送时为空
+    std::string step() {
+        uint64_t before[NOTIFICATION_PRIORITY_COUNT];
+        for (size_t i = 0; i < NOTIFICATION_PRIORITY_COUNT; ++i) {
+            before[i] = dispatched(static_cast<NotificationPriority>(i));
+        }
+        g_main_context_iteration(nullptr, FALSE);
+
+        std::string sent;
+        const char names[] = { 'C', 'I', 'B' };
+        for (size_t i = 0; i < NOTIFICATION_PRIORITY_COUNT; ++i) {
+            uint64_t delta = dispatched(static_cast<NotificationPriority>(i)) - before[i];
+            sent.append(delta, names[i]);
+        }
+        return sent;
+    }
+
+    std::string drain() {
+        std::string order;
+        std::string sent;
+        while (!(sent = step()).empty()) {
+            order += sent;
+        }
+        return order;
+    }
+};
+
+static DispatcherConfig singleStepConfig() {
+    DispatcherConfig config;
+    config.interactive_weight = 4;
+    config.bulk_weight = 1;
+    config.batch_limit = 1;
+    return config;
+}
+
+// INTERACTIVE与BULK按4:1轮流发送；一个类别排空后另一类别每次重新开始一轮，不会停住
+static void testWeightedRotation() {
+    Harness harness(singleStepConfig());
+    harness.submit(NotificationPriority::INTERACTIVE, 8);
+    harness.submit(NotificationPriority::BULK, 4);
+
+    CHECK(harness.drain() == "IIIIBIIIIBBB");
+    CHECK(harness.dispatched(NotificationPriority::INTERACTIVE) == 8);
+    CHECK(harness.dispatched(NotificationPriority::BULK) == 4);
+}
+
+// 额度在两个类别都无法发送时才重置：INTERACTIVE未用完的额度在BULK到达后继续使用
+static void testCreditReset() {
+    Harness harness(singleStepConfig());
+    harness.submit(NotificationPriority::INTERACTIVE, 2);
+    CHECK(harness.drain() == "II");
+
+    // 剩余2个INTERACTIVE额度，BULK额度1：先用完剩余额度，再发BULK，然后新的一轮
+    harness.submit(NotificationPriority::INTERACTIVE, 6);
+    harness.submit(NotificationPriority::BULK, 2);
+    CHECK(harness.drain() == "IIBIIIIB");
+
+    // 只有BULK排队时每次重置后都能发送
+    harness.submit(NotificationPriority::BULK, 3);
+    CHECK(harness.drain() == "BBB");
+}
+
+// CRITICAL插到已排队的其他类别之前，之后轮转从中断处继续
+static void testCriticalPreemption() {
+    Harness harness(singleStepConfig());
+    harness.submit(NotificationPriority::INTERACTIVE, 6);
+    harness.submit(NotificationPriority::BULK, 2);
+
+    CHECK(harness.step() == "I");
+    CHECK(harness.step() == "I");
+    harness.submit(NotificationPriority::CRITICAL, 2);
+    CHECK(harness.drain() == "CCIIBIIB");
+    CHECK(harness.dispatched(NotificationPriority::CRITICAL) == 2);
+}
+
+// 同一特征值排队期间只占一个位置；取消后不再发送
+static void testSubmitOncePerCharacteristic() {
+    Harness harness(singleStepConfig());
+    GattCharacteristic* first = harness.add(NotificationPriority::INTERACTIVE);
+    GattCharacteristic* second = harness.add(NotificationPriority::INTERACTIVE);
+    CHECK(harness.dispatcher.submit(first));
+    CHECK(!harness.dispatcher.submit(first));
+    CHECK(harness.dispatcher.submit(second));
+    CHECK(harness.dispatcher.getStatistics(NotificationPriority::INTERACTIVE).depth == 2);
+
+    harness.dispatcher.cancel(second);
+    CHECK(harness.dispatcher.getStatistics(NotificationPriority::INTERACTIVE).depth == 1);
+    CHECK(harness.drain() == "I");
+    CHECK(harness.dispatcher.submit(first));
+    harness.dispatcher.flush();
+}
+
+// 每个类别的排队数、最大排队数和排队时延
+static void testClassStatistics() {
+    Harness harness(DispatcherConfig{});
+    harness.submit(NotificationPriority::BULK, 3);
+    harness.submit(NotificationPriority::CRITICAL, 1);
+
+    PriorityClassStatistics bulk = harness.dispatcher.getStatistics(NotificationPriority::BULK);
+    CHECK(bulk.depth == 3);
+    CHECK(bulk.max_depth == 3);
+    CHECK(bulk.dispatched == 0);
+    CHECK(harness.dispatcher.getStatistics(NotificationPriority::INTERACTIVE).max_depth == 0);
+
+    g_usleep(5000);
+    harness.dispatcher.flush();
+
+    bulk = harness.dispatcher.getStatistics(NotificationPriority::BULK);
+    CHECK(bulk.depth == 0);
+    CHECK(bulk.max_depth == 3);
+    CHECK(bulk.dispatched == 3);
+    CHECK(bulk.max_latency_us >= 5000);
+    CHECK(bulk.total_latency_us >= 3 * 5000);
+    CHECK(bulk.total_latency_us <= 3 * bulk.max_latency_us);
+
+    PriorityClassStatistics critical = harness.dispatcher.getStatistics(NotificationPriority::CRITICAL);
+    CHECK(critical.dispatched == 1);
+    CHECK(critical.max_latency_us >= 5000);
+
+    // 清零后最大排队数从当前排队数开始
+    harness.submit(NotificationPriority::BULK, 2);
+    harness.dispatcher.resetStatistics();
+    bulk = harness.dispatcher.getStatistics(NotificationPriority::BULK);
+    CHECK(bulk.depth == 2);
+    CHECK(bulk.max_depth == 2);
+    CHECK(bulk.dispatched == 0);
+    CHECK(bulk.total_latency_us == 0);
+    CHECK(bulk.max_latency_us == 0);
+    harness.dispatcher.flush();
+}
+
+int main() {
+    testWeightedRotation();
+    testCreditReset();
+    testCriticalPreemption();
+    testSubmitOncePerCharacteristic();
+    testClassStatistics();
+    return TEST_RESULT();
+}
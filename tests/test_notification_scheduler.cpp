@@ -0,0 +1,115 @@
+#include "notification_scheduler.h"
+#include "gatt_characteristic.h"
+#include "test_support.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <memory>
+#include <vector>
+
+using namespace Bluetooth;
+
+static const char* const DEVICE_PATH = "/org/bluez/hci0/dev_00_11_22_33_44_88";
+
+// 读出BlueZ一端已收到的所有通知
+static std::vector<ByteValue> drainNotifications(int fd) {
+    std::vector<ByteValue> values;
+    uint8_t buffer[512];
+    ssize_t received;
+    while ((received = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+        values.emplace_back(buffer, static_cast<size_t>(received));
+    }
+    return values;
+}
+
+// 同一窗口内的多次setValue合并为一次通知，发送的是最新值；计数分别记在调度器和特征值上
+static void testCoalescedWithinWindow() {
+    auto scheduler = std::make_shared<NotificationScheduler>(20);
+    GattCharacteristic characteristic("0000c001-0000-1000-8000-00805f9b34fb",
+                                      { CharacteristicFlags::READ, CharacteristicFlags::NOTIFY });
+    characteristic.setNotificationScheduler(scheduler);
+    int fd = characteristic.acquireNotify(DEVICE_PATH, 64);
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < 10; ++i) {
+        CHECK(characteristic.setValue(ByteValue{ i }));
+    }
+    CHECK(scheduler->getCoalescedCount() == 9);
+    CHECK(scheduler->getSentCount() == 0);
+
+    std::vector<ByteValue> received;
+    CHECK(TestSupport::runUntil([&]() {
+        for (const ByteValue& value : drainNotifications(fd)) {
+            received.push_back(value);
+        }
+        return !received.empty();
+    }, 1000));
+    CHECK(received.size() == 1);
+    CHECK(!received.empty() && received.back() == ByteValue{ 9 });
+
+    CHECK(scheduler->getSentCount() == 1);
+    CHECK(characteristic.getNotificationStatistics().coalesced_updates == 9);
+    CHECK(characteristic.getNotificationStatistics().sent_updates == 1);
+
+    // 下一个窗口重新开始合并
+    CHECK(characteristic.setValue(ByteValue{ 10 }));
+    CHECK(characteristic.setValue(ByteValue{ 11 }));
+    scheduler->flush();
+    CHECK(scheduler->getCoalescedCount() == 10);
+    CHECK(scheduler->getSentCount() == 2);
+
+    scheduler->resetStatistics();
+    CHECK(scheduler->getCoalescedCount() == 0);
+    CHECK(scheduler->getSentCount() == 0);
+
+    close(fd);
+}
+
+// 每个特征值每个窗口各发送一次；取消的特征值不发送也不计数
+static void testSentPerCharacteristic() {
+    auto scheduler = std::make_shared<NotificationScheduler>(0);
+    GattCharacteristic first("0000c002-0000-1000-8000-00805f9b34fb", { CharacteristicFlags::NOTIFY });
+    GattCharacteristic second("0000c003-0000-1000-8000-00805f9b34fb", { CharacteristicFlags::NOTIFY });
+    GattCharacteristic third("0000c004-0000-1000-8000-00805f9b34fb", { CharacteristicFlags::NOTIFY });
+
+    std::vector<int> fds;
+    for (GattCharacteristic* characteristic : { &first, &second, &third }) {
+        characteristic->setNotificationScheduler(scheduler);
+        int fd = characteristic->acquireNotify(DEVICE_PATH, 64);
+        CHECK(fd >= 0);
+        fds.push_back(fd);
+    }
+
+    CHECK(first.setValue(ByteValue{ 1 }));
+    CHECK(second.setValue(ByteValue{ 2 }));
+    CHECK(second.setValue(ByteValue{ 3 }));
+    CHECK(third.setValue(ByteValue{ 4 }));
+    scheduler->cancel(&third);
+
+    // 间隔为0时下一次主循环迭代刷新
+    CHECK(TestSupport::runUntil([&]() { return scheduler->getSentCount() == 2; }, 1000));
+    CHECK(scheduler->getCoalescedCount() == 1);
+    CHECK(first.getNotificationStatistics().sent_updates == 1);
+    CHECK(second.getNotificationStatistics().sent_updates == 1);
+    CHECK(second.getNotificationStatistics().coalesced_updates == 1);
+    CHECK(third.getNotificationStatistics().sent_updates == 0);
+
+    // 刷新后没有待发送的特征值，再次迭代不会重复发送
+    while (g_main_context_iteration(nullptr, FALSE)) {
+    }
+    CHECK(scheduler->getSentCount() == 2);
+
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+int main() {
+    testCoalescedWithinWindow();
+    testSentPerCharacteristic();
+    return TEST_RESULT();
+}
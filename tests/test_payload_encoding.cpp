@@ -0,0 +1,184 @@
+#include "gatt_characteristic.h"
+#include "payload_codec.h"
+#include "test_support.h"
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace Bluetooth;
+
+static const char* const DEVICE_PATH = "/org/bluez/hci0/dev_00_11_22_33_44_66";
+
+static ByteValue sample(uint32_t counter) {
+    // 固定格式采样：前几个字段缓慢变化，其余不变
+    ByteValue value(16, 0x20);
+    value[0] = static_cast<uint8_t>(counter);
+    value[1] = static_cast<uint8_t>(counter >> 8);
+    value[4] = static_cast<uint8_t>(counter / 3);
+    return value;
+}
+
+// 读取套接字中的全部帧并解码，返回最后一个成功解码的值
+static size_t drainAndDecode(int fd, PayloadDecoder& decoder, std::vector<uint8_t>& last, size_t& failures) {
+    uint8_t buffer[256];
+    size_t frames = 0;
+    ssize_t received;
+    while ((received = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+        frames++;
+        std::vector<uint8_t> value;
+        if (decoder.decode(buffer, static_cast<size_t>(received), value)) {
+            last = value;
+        } else {
+            failures++;
+        }
+    }
+    return frames;
+}
+
+// 订阅者队列溢出丢弃时，解码端最终与最新值保持同步
+static void testDropsKeepDecoderInSync() {
+    PayloadEncodingConfig config;
+    config.mode = PayloadEncoding::XOR;
+    config.keyframe_interval = 0;
+
+    GattCharacteristic characteristic("0000bbbb-0000-1000-8000-00805f9b34fb",
+                                      { CharacteristicFlags::NOTIFY });
+    characteristic.setPayloadEncoding(config);
+
+    SubscriberQueueConfig queue_config;
+    queue_config.capacity = 4;
+    queue_config.high_watermark = 3;
+    queue_config.low_watermark = 1;
+    queue_config.drop_policy = DropPolicy::DROP_OLDEST;
+    characteristic.setSubscriberQueueConfig(queue_config);
+
+    int fd = characteristic.acquireNotify(DEVICE_PATH, 64);
+    CHECK(fd >= 0);
+
+    // 对端不读取，直到套接字写满并开始丢弃
+    uint32_t counter = 0;
+    SubscriberStatistics stats;
+    while (counter < 200000) {
+        CHECK(characteristic.setValue(sample(counter++)));
+        CHECK(characteristic.getSubscriberStatistics(DEVICE_PATH, stats));
+        if (stats.dropped >= 20) {
+            break;
+        }
+    }
+    CHECK(stats.dropped >= 20);
+
+    PayloadDecoder decoder(config);
+    std::vector<uint8_t> last;
+    size_t failures = 0;
+    size_t frames = 0;
+    TestSupport::runUntil([&]() {
+        frames += drainAndDecode(fd, decoder, last, failures);
+        return characteristic.getSubscriberStatistics(DEVICE_PATH, stats) && stats.queued == 0;
+    }, 2000);
+    frames += drainAndDecode(fd, decoder, last, failures);
+
+    // 只有被丢弃的已编码队首会造成一次丢帧，随后的关键帧立即恢复同步
+    CHECK(frames == stats.sent);
+    CHECK(failures == 0);
+    CHECK(decoder.isSynchronized());
+    CHECK(last == sample(counter - 1).toVector());
+
+    PayloadEncodingStatistics encoding = characteristic.getPayloadEncodingStatistics();
+    CHECK(encoding.encoded_bytes < encoding.raw_bytes);
+
+    close(fd);
+}
+
+// 帧长上限：差分帧超过上限时改发关键帧，关键帧也放不下时不发送且不改变编码状态
+static void testEncoderFrameLimit() {
+    PayloadEncodingConfig config;
+    config.mode = PayloadEncoding::XOR;
+    config.keyframe_interval = 0;
+    const size_t max_frame_size = DEFAULT_ATT_MTU - ATT_NOTIFICATION_HEADER_SIZE;
+
+    PayloadEncoder encoder(config);
+    PayloadDecoder decoder(config);
+    std::vector<uint8_t> decoded;
+
+    ByteValue base(max_frame_size - PAYLOAD_FRAME_HEADER_SIZE, 0x11);
+    ByteValue frame = encoder.encode(base, max_frame_size);
+    CHECK(frame.size() == max_frame_size);
+    CHECK(decoder.decode(frame.data(), frame.size(), decoded));
+
+    // 每个字节都变化，异或帧比关键帧更长，改发关键帧
+    ByteValue changed(base.size(), 0x22);
+    frame = encoder.encode(changed, max_frame_size);
+    CHECK(frame.size() <= max_frame_size);
+    CHECK((frame[0] >> 6) == static_cast<uint8_t>(PayloadFrameType::KEYFRAME));
+    CHECK(decoder.decode(frame.data(), frame.size(), decoded));
+    CHECK(decoded == changed.toVector());
+
+    // 填满MTU-3的值加上帧头放不下
+    ByteValue full(max_frame_size, 0x33);
+    CHECK(encoder.encode(full, max_frame_size).empty());
+    CHECK(encoder.getStatistics().oversized == 1);
+
+    // 编码状态未推进，之后的差分帧仍以上一个送达的值为基准
+    ByteValue next = changed;
+    next[3] = 0x44;
+    frame = encoder.encode(next, max_frame_size);
+    CHECK((frame[0] >> 6) == static_cast<uint8_t>(PayloadFrameType::XOR));
+    CHECK(decoder.decode(frame.data(), frame.size(), decoded));
+    CHECK(decoded == next.toVector());
+}
+
+// 默认MTU下的套接字订阅者：20字节的值不会以截断的关键帧送出，解码端从不解出错误的值
+static void testDefaultMtuSubscriber() {
+    PayloadEncodingConfig config;
+    config.mode = PayloadEncoding::DELTA;
+    config.keyframe_interval = 0;
+
+    GattCharacteristic characteristic("0000bbbc-0000-1000-8000-00805f9b34fb",
+                                      { CharacteristicFlags::NOTIFY });
+    characteristic.setPayloadEncoding(config);
+    int fd = characteristic.acquireNotify(DEVICE_PATH, DEFAULT_ATT_MTU);
+    CHECK(fd >= 0);
+
+    PayloadDecoder decoder(config);
+    uint8_t buffer[256];
+    auto receive = [&](std::vector<uint8_t>& value) {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (received <= 0) {
+            return false;
+        }
+        CHECK(static_cast<size_t>(received) <= DEFAULT_ATT_MTU - ATT_NOTIFICATION_HEADER_SIZE);
+        CHECK(decoder.decode(buffer, static_cast<size_t>(received), value));
+        return true;
+    };
+
+    std::vector<uint8_t> value;
+    for (uint8_t i = 0; i < 4; ++i) {
+        ByteValue full(DEFAULT_ATT_MTU - ATT_NOTIFICATION_HEADER_SIZE, i);
+        CHECK(characteristic.setValue(full));
+        CHECK(!receive(value));
+    }
+
+    ByteValue fitting(DEFAULT_ATT_MTU - ATT_NOTIFICATION_HEADER_SIZE - PAYLOAD_FRAME_HEADER_SIZE, 7);
+    CHECK(characteristic.setValue(fitting));
+    CHECK(receive(value));
+    CHECK(value == fitting.toVector());
+
+    fitting[0] = 8;
+    CHECK(characteristic.setValue(fitting));
+    CHECK(receive(value));
+    CHECK(value == fitting.toVector());
+
+    SubscriberStatistics stats;
+    CHECK(characteristic.getSubscriberStatistics(DEVICE_PATH, stats));
+    CHECK(stats.truncated == 0);
+    CHECK(stats.dropped == 4);
+    CHECK(characteristic.getPayloadEncodingStatistics().oversized == 4);
+
+    close(fd);
+}
+
+int main() {
+    testDropsKeepDecoderInSync();
+    testEncoderFrameLimit();
+    testDefaultMtuSubscriber();
+    return TEST_RESULT();
+}
@@ -0,0 +1,142 @@
+#include "rate_limiter.h"
+#include "test_support.h"
+
+using namespace Bluetooth;
+
+static RateLimitConfig makeConfig(double rate, double burst, RateLimitPolicy policy) {
+    RateLimitConfig config;
+    config.rate = rate;
+    config.burst = burst;
+    config.policy = policy;
+    return config;
+}
+
+// 满桶允许一次突发，之后按速率补充；运行时缩小容量截断已有令牌，关闭后不限速
+static void testTokenBucket() {
+    TokenBucket bucket(makeConfig(10.0, 3.0, RateLimitPolicy::DROP));
+    gint64 now = g_get_monotonic_time();
+
+    CHECK(bucket.tryConsume(now));
+    CHECK(bucket.tryConsume(now));
+    CHECK(bucket.tryConsume(now));
+    CHECK(!bucket.tryConsume(now));
+    CHECK(bucket.getDelayUntilAvailable(now) > 99000);
+    CHECK(bucket.getDelayUntilAvailable(now) <= 100001);
+
+    now += 100000;
+    CHECK(bucket.getDelayUntilAvailable(now) == 0);
+    CHECK(bucket.tryConsume(now));
+    CHECK(!bucket.tryConsume(now));
+
+    // 补满后缩小容量：只剩1个令牌
+    now += G_USEC_PER_SEC;
+    bucket.configure(makeConfig(10.0, 1.0, RateLimitPolicy::DROP));
+    CHECK(bucket.tryConsume(now));
+    CHECK(!bucket.tryConsume(now));
+
+    bucket.configure(makeConfig(0.0, 1.0, RateLimitPolicy::DROP));
+    CHECK(!bucket.isLimited());
+    for (int i = 0; i < 10; ++i) {
+        CHECK(bucket.tryConsume(now));
+    }
+}
+
+// 丢弃策略：突发之外的通知计入dropped，从不回调
+static void testDropAccounting() {
+    int releases = 0;
+    RateLimiter limiter([&]() { ++releases; });
+    limiter.configure(makeConfig(1.0, 2.0, RateLimitPolicy::DROP));
+
+    CHECK(limiter.admit());
+    CHECK(limiter.admit());
+    CHECK(!limiter.admit());
+    CHECK(!limiter.admit());
+    CHECK(!limiter.admit());
+    CHECK(!limiter.isDelaying());
+
+    const RateLimitStatistics& stats = limiter.getStatistics();
+    CHECK(stats.passed == 2);
+    CHECK(stats.dropped == 3);
+    CHECK(stats.delayed == 0);
+
+    while (g_main_context_iteration(nullptr, FALSE)) {
+    }
+    CHECK(releases == 0);
+}
+
+// 推迟策略：超出速率的第一次通知推迟，推迟期间的更新合并计入dropped，令牌可用时只回调一次
+static void testDelayAccounting() {
+    int releases = 0;
+    RateLimiter limiter([&]() { ++releases; });
+    limiter.configure(makeConfig(20.0, 1.0, RateLimitPolicy::DELAY_LATEST));
+
+    gint64 start = g_get_monotonic_time();
+    CHECK(limiter.admit());
+    CHECK(!limiter.admit());
+    CHECK(limiter.isDelaying());
+    CHECK(!limiter.admit());
+    CHECK(!limiter.admit());
+
+    const RateLimitStatistics& stats = limiter.getStatistics();
+    CHECK(stats.passed == 1);
+    CHECK(stats.delayed == 1);
+    CHECK(stats.dropped == 2);
+
+    CHECK(TestSupport::runUntil([&]() { return releases > 0; }, 1000));
+    CHECK(g_get_monotonic_time() - start >= 45000);
+    CHECK(!limiter.isDelaying());
+
+    // 回调消耗了令牌，紧接着的通知再次推迟
+    CHECK(!limiter.admit());
+    CHECK(limiter.isDelaying());
+    CHECK(stats.delayed == 2);
+    CHECK(TestSupport::runUntil([&]() { return releases == 2; }, 1000));
+    CHECK(stats.passed == 1);
+}
+
+// 推迟期间改为丢弃策略或关闭限速时立即回调；取消后不再回调
+static void testRuntimeLimitChanges() {
+    int releases = 0;
+    RateLimiter limiter([&]() { ++releases; });
+    limiter.configure(makeConfig(1.0, 1.0, RateLimitPolicy::DELAY_LATEST));
+
+    CHECK(limiter.admit());
+    CHECK(!limiter.admit());
+    CHECK(limiter.isDelaying());
+
+    limiter.configure(makeConfig(1.0, 1.0, RateLimitPolicy::DROP));
+    CHECK(releases == 1);
+    CHECK(!limiter.isDelaying());
+    CHECK(!limiter.admit());
+    CHECK(limiter.getStatistics().dropped == 1);
+
+    limiter.configure(makeConfig(1.0, 1.0, RateLimitPolicy::DELAY_LATEST));
+    CHECK(!limiter.admit());
+    CHECK(limiter.isDelaying());
+    limiter.configure(makeConfig(0.0, 1.0, RateLimitPolicy::DELAY_LATEST));
+    CHECK(releases == 2);
+    CHECK(!limiter.isDelaying());
+    for (int i = 0; i < 5; ++i) {
+        CHECK(limiter.admit());
+    }
+    CHECK(limiter.getStatistics().passed == 6);
+
+    // 重新启用时从满桶开始
+    limiter.configure(makeConfig(1.0, 2.0, RateLimitPolicy::DELAY_LATEST));
+    CHECK(limiter.admit());
+    CHECK(limiter.admit());
+    CHECK(!limiter.admit());
+    CHECK(limiter.isDelaying());
+    limiter.cancel();
+    CHECK(!limiter.isDelaying());
+    CHECK(!TestSupport::runUntil([&]() { return releases > 2; }, 50));
+    CHECK(limiter.getStatistics().delayed == 3);
+}
+
+int main() {
+    testTokenBucket();
+    testDropAccounting();
+    testDelayAccounting();
+    testRuntimeLimitChanges();
+    return TEST_RESULT();
+}
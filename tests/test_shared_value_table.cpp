@@ -0,0 +1,188 @@
+#include "shared_value_table.h"
+#include "gatt_characteristic.h"
+#include "test_support.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace Bluetooth;
+
+// 共享内存布局（跨进程协议）：64字节头部 {magic, version, slot_count, slot_size, ...}，
+// 之后每个槽位以 {sequence, size} 开头，槽位独占缓存行
+static const size_t HEADER_SIZE = 64;
+static const uint32_t TABLE_MAGIC = 0x42545654;
+
+static std::shared_ptr<GattCharacteristic> makeCharacteristic(const char* uuid) {
+    return std::make_shared<GattCharacteristic>(uuid, std::vector<CharacteristicFlags>{ CharacteristicFlags::READ });
+}
+
+// 生产者写入的值经poll()转换为setValue()
+static void testPublishAndPoll() {
+    auto table = std::make_shared<SharedValueTable>();
+    CHECK(table->create("", 4, 32));
+    CHECK(!table->publish(4, nullptr, 0));
+    CHECK(!table->publish(0, ByteValue(33, 0).data(), 33));
+
+    auto characteristic = makeCharacteristic("0000cccc-0000-1000-8000-00805f9b34fb");
+    SharedValueTableWatch watch(table);
+    CHECK(watch.bindSlot(1, characteristic));
+
+    ByteValue value{ 1, 2, 3 };
+    CHECK(table->publish(1, value.data(), value.size()));
+    CHECK(watch.poll() == 1);
+    CHECK(characteristic->getValue() == value);
+
+    // 版本未变化时不再送达
+    CHECK(watch.poll() == 0);
+}
+
+// 生产者进程在写入中途退出，序号停在奇数：poll()跳过该槽位而不卡住，其他槽位照常送达
+static void testStuckWriterIsSkipped() {
+    auto table = std::make_shared<SharedValueTable>();
+    CHECK(table->create("", 2, 32));
+
+    auto stuck = makeCharacteristic("0000cccd-0000-1000-8000-00805f9b34fb");
+    auto healthy = makeCharacteristic("0000ccce-0000-1000-8000-00805f9b34fb");
+    SharedValueTableWatch watch(table);
+    CHECK(watch.bindSlot(0, stuck));
+    CHECK(watch.bindSlot(1, healthy));
+
+    ByteValue first{ 0x10 };
+    CHECK(table->publish(0, first.data(), first.size()));
+    CHECK(watch.poll() == 1);
+
+    // 模拟生产者完成一次写入后又在下一次写入中途退出
+    ByteValue second{ 0x20 };
+    CHECK(table->publish(0, second.data(), second.size()));
+    size_t mapped_size = static_cast<size_t>(lseek(table->getFd(), 0, SEEK_END));
+    void* producer = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, table->getFd(), 0);
+    CHECK(producer != MAP_FAILED);
+    if (producer == MAP_FAILED) {
+        return;
+    }
+    auto* sequence = reinterpret_cast<std::atomic<uint64_t>*>(static_cast<uint8_t*>(producer) + HEADER_SIZE);
+    uint64_t committed = sequence->load();
+    sequence->store(committed + 1);
+
+    ByteValue other{ 0x30 };
+    CHECK(table->publish(1, other.data(), other.size()));
+    CHECK(watch.poll() == 1);
+    CHECK(stuck->getValue() == first);
+    CHECK(healthy->getValue() == other);
+
+    ByteValue output;
+    uint64_t version = 0;
+    CHECK(!table->tryRead(0, output, version));
+    CHECK(table->read(0, output) == 0);
+
+    // 槽位恢复后送达最新的完整值
+    sequence->store(committed + 2);
+    CHECK(watch.poll() == 1);
+    CHECK(stuck->getValue() == second);
+
+    munmap(producer, mapped_size);
+}
+
+// 头部中的槽位数和槽位长度相乘溢出时拒绝映射，而不是绕回到一个很小的长度
+static void testOverflowingLayoutRejected() {
+    int fd = memfd_create("test-values", MFD_CLOEXEC);
+    CHECK(fd >= 0);
+    CHECK(ftruncate(fd, HEADER_SIZE) == 0);
+
+    uint32_t header[4] = { TABLE_MAGIC, 1, UINT32_MAX, UINT32_MAX };
+    CHECK(pwrite(fd, header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)));
+
+    SharedValueTable table;
+    CHECK(!table.attach(fd));
+    CHECK(!table.isOpen());
+    close(fd);
+
+    SharedValueTable oversized;
+    CHECK(!oversized.create("", SIZE_MAX / 2, SHARED_TABLE_DEFAULT_SLOT_SIZE));
+    CHECK(!oversized.isOpen());
+}
+
+static uint64_t decodeCounter(const ByteValue& value) {
+    uint64_t counter = 0;
+    if (value.size() == sizeof(counter)) {
+        std::memcpy(&counter, value.data(), sizeof(counter));
+    }
+    return counter;
+}
+
+// 多个生产者线程在服务端扫描期间发布（一问一答），只靠eventfd唤醒，没有轮询定时器兜底。
+// 丢失的唤醒会让某个生产者停住直到期限
+static void testEventWakeupsNotLost() {
+    const size_t producer_count = 4;
+    const uint64_t rounds = 20000;
+
+    auto table = std::make_shared<SharedValueTable>();
+    CHECK(table->create("", producer_count, sizeof(uint64_t)));
+    CHECK(table->createEventFd());
+
+    std::vector<std::shared_ptr<GattCharacteristic>> characteristics;
+    SharedValueTableWatch watch(table);
+    for (size_t i = 0; i < producer_count; ++i) {
+        std::string uuid = "0000cd0" + std::to_string(i) + "-0000-1000-8000-00805f9b34fb";
+        characteristics.push_back(makeCharacteristic(uuid.c_str()));
+        CHECK(watch.bindSlot(i, characteristics.back()));
+    }
+    CHECK(watch.startEventWatch());
+
+    std::unique_ptr<std::atomic<uint64_t>[]> acknowledged(new std::atomic<uint64_t>[producer_count]);
+    std::atomic<bool> stop(false);
+    for (size_t i = 0; i < producer_count; ++i) {
+        acknowledged[i].store(0);
+    }
+
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producer_count; ++i) {
+        producers.emplace_back([&, i]() {
+            uint8_t buffer[sizeof(uint64_t)];
+            for (uint64_t round = 1; round <= rounds && !stop.load(); ++round) {
+                std::memcpy(buffer, &round, sizeof(round));
+                table->publish(i, buffer, sizeof(buffer));
+                while (acknowledged[i].load(std::memory_order_acquire) != round && !stop.load()) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // 条件在每次主循环迭代（即每次eventfd唤醒后的扫描）之后求值
+    bool finished = TestSupport::runUntil([&]() {
+        bool done = true;
+        for (size_t i = 0; i < producer_count; ++i) {
+            uint64_t counter = decodeCounter(characteristics[i]->getValue());
+            acknowledged[i].store(counter, std::memory_order_release);
+            done = done && counter == rounds;
+        }
+        return done;
+    }, 30000);
+    CHECK(finished);
+
+    stop.store(true);
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    if (!finished) {
+        for (size_t i = 0; i < producer_count; ++i) {
+            std::cerr << "producer " << i << " stalled at round " << acknowledged[i].load() << std::endl;
+        }
+    }
+    watch.stop();
+}
+
+
+int main() {
+    testPublishAndPoll();
+    testStuckWriterIsSkipped();
+    testOverflowingLayoutRejected();
+    testEventWakeupsNotLost();
+    return TEST_RESULT();
+}
@@ -0,0 +1,174 @@
+#include "stream_framing.h"
+#include "gatt_characteristic.h"
+#include "test_support.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Bluetooth;
+
+static ByteValue makeMessage(size_t size) {
+    ByteValue message(size);
+    for (size_t i = 0; i < size; ++i) {
+        message[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    return message;
+}
+
+// 生产者每次最多给出piece_size字节，模拟分段读取的数据源
+static StreamProducer makeProducer(const ByteValue& message, size_t piece_size) {
+    auto offset = std::make_shared<size_t>(0);
+    return [message, piece_size, offset](uint8_t* buffer, size_t capacity) {
+        size_t size = std::min({ capacity, piece_size, message.size() - *offset });
+        std::memcpy(buffer, message.data() + *offset, size);
+        *offset += size;
+        return size;
+    };
+}
+
+static std::vector<ValueSnapshot> chunkAll(const ByteValue& message, size_t payload_size, size_t piece_size) {
+    StreamChunker chunker(makeProducer(message, piece_size), payload_size);
+    std::vector<ValueSnapshot> chunks;
+    ValueSnapshot chunk;
+    while (chunker.next(chunk)) {
+        chunks.push_back(chunk);
+    }
+    CHECK(chunker.isFinished());
+    CHECK(chunker.getChunkCount() == chunks.size());
+    CHECK(chunker.getByteCount() == message.size());
+    return chunks;
+}
+
+// 各种长度（含空消息、整块边界和序号回绕）切分后重组得到原始数据
+static void testRoundTrip() {
+    const size_t payload_size = 19;
+    const size_t sizes[] = { 0, 1, payload_size - 1, payload_size, payload_size + 1,
+                             payload_size * 3, payload_size * 70 + 5 };
+
+    for (size_t size : sizes) {
+        ByteValue message = makeMessage(size);
+        std::vector<ValueSnapshot> chunks = chunkAll(message, payload_size, 7);
+        CHECK(chunks.size() == std::max<size_t>((size + payload_size - 1) / payload_size, 1));
+
+        StreamReassembler reassembler;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            const ValueSnapshot& chunk = chunks[i];
+            bool first = i == 0;
+            bool last = i + 1 == chunks.size();
+            uint8_t header = chunk.data()[0];
+            CHECK(((header & STREAM_FLAG_FIRST) != 0) == first);
+            CHECK(((header & STREAM_FLAG_LAST) != 0) == last);
+            CHECK((header & STREAM_SEQUENCE_MASK) == (i & STREAM_SEQUENCE_MASK));
+            if (!last) {
+                CHECK(chunk.size() == STREAM_HEADER_SIZE + payload_size);
+            }
+
+            ReassemblyStatus status = reassembler.push(chunk.data(), chunk.size());
+            CHECK(status == (last ? ReassemblyStatus::COMPLETE : ReassemblyStatus::INCOMPLETE));
+        }
+        CHECK(reassembler.getMessage() == message);
+        CHECK(reassembler.getErrorCount() == 0);
+    }
+}
+
+// 丢块时报告错误并丢弃当前消息，下一个首块开始的消息正常重组
+static void testMissingChunkRecovers() {
+    ByteValue message = makeMessage(100);
+    std::vector<ValueSnapshot> chunks = chunkAll(message, 20, 100);
+    CHECK(chunks.size() == 5);
+
+    StreamReassembler reassembler;
+    CHECK(reassembler.push(chunks[0].data(), chunks[0].size()) == ReassemblyStatus::INCOMPLETE);
+    CHECK(reassembler.push(chunks[2].data(), chunks[2].size()) == ReassemblyStatus::ERROR);
+    CHECK(reassembler.push(chunks[3].data(), chunks[3].size()) == ReassemblyStatus::ERROR);
+    CHECK(reassembler.getErrorCount() == 2);
+
+    ReassemblyStatus status = ReassemblyStatus::INCOMPLETE;
+    for (const ValueSnapshot& chunk : chunks) {
+        status = reassembler.push(chunk.data(), chunk.size());
+    }
+    CHECK(status == ReassemblyStatus::COMPLETE);
+    CHECK(reassembler.getMessage() == message);
+}
+
+// 超过长度上限的消息被丢弃
+static void testMaxMessageSize() {
+    ByteValue message = makeMessage(64);
+    std::vector<ValueSnapshot> chunks = chunkAll(message, 16, 64);
+
+    StreamReassembler reassembler(40);
+    std::vector<ReassemblyStatus> statuses;
+    for (const ValueSnapshot& chunk : chunks) {
+        statuses.push_back(reassembler.push(chunk.data(), chunk.size()));
+    }
+    CHECK(statuses[2] == ReassemblyStatus::ERROR);
+    CHECK(statuses.back() == ReassemblyStatus::ERROR);
+    CHECK(reassembler.getMessage().empty());
+}
+
+// 订阅者按丢弃策略限速时分块流仍然完整送达：分块不经过限速，流完成时接收端得到完整消息
+static void testStreamBypassesSubscriberRateLimit() {
+    const char* device = "/org/bluez/hci0/dev_00_11_22_33_44_77";
+    GattCharacteristic characteristic("0000abcd-0000-1000-8000-00805f9b34fb",
+                                      { CharacteristicFlags::NOTIFY });
+    int fd = characteristic.acquireNotify(device, 64);
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+
+    RateLimitConfig limit;
+    limit.rate = 1.0;
+    limit.burst = 1.0;
+    limit.policy = RateLimitPolicy::DROP;
+    CHECK(characteristic.setSubscriberRateLimit(device, limit));
+
+    StreamConfig stream_config;
+    stream_config.interval_ms = 1;
+    characteristic.setStreamConfig(stream_config);
+
+    ByteValue message = makeMessage(1000);
+    bool finished = false;
+    bool completed = false;
+    CHECK(characteristic.streamValue(message, [&](bool result) {
+        finished = true;
+        completed = result;
+    }));
+
+    StreamReassembler reassembler;
+    ReassemblyStatus status = ReassemblyStatus::INCOMPLETE;
+    uint8_t buffer[256];
+    auto drain = [&]() {
+        ssize_t received;
+        while ((received = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+            status = reassembler.push(buffer, static_cast<size_t>(received));
+        }
+    };
+    CHECK(TestSupport::runUntil([&]() {
+        drain();
+        return finished;
+    }, 5000));
+    drain();
+
+    CHECK(completed);
+    CHECK(status == ReassemblyStatus::COMPLETE);
+    CHECK(reassembler.getErrorCount() == 0);
+    CHECK(reassembler.getMessage() == message);
+
+    SubscriberStatistics stats;
+    CHECK(characteristic.getSubscriberStatistics(device, stats));
+    CHECK(stats.rate_limit.dropped == 0);
+
+    close(fd);
+}
+
+int main() {
+    testRoundTrip();
+    testMissingChunkRecovers();
+    testMaxMessageSize();
+    testStreamBypassesSubscriberRateLimit();
+    return TEST_RESULT();
+}
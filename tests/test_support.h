@@ -0,0 +1,59 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <glib.h>
+#include <iostream>
+
+// 测试辅助：不依赖测试框架，每个测试是独立的可执行文件，失败计数非零时返回1
+
+namespace TestSupport {
+
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+inline gboolean onDeadline(gpointer user_data) {
+    *static_cast<bool*>(user_data) = true;
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief 迭代主上下文直到条件满足或超过期限
+ * 期限是唯一的定时器，迭代总是阻塞等待，丢失的唤醒会表现为超时而不会被周期定时器掩盖
+ * @param done 完成条件，每次迭代前求值一次
+ * @param timeout_ms 期限（毫秒）
+ * @param context 主上下文，nullptr表示默认上下文
+ * @return 条件是否满足
+ */
+template <typename Predicate>
+bool runUntil(Predicate done, guint timeout_ms, GMainContext* context = nullptr) {
+    bool expired = false;
+    GSource* deadline = g_timeout_source_new(timeout_ms);
+    g_source_set_callback(deadline, onDeadline, &expired, nullptr);
+    g_source_attach(deadline, context);
+
+    bool satisfied = false;
+    while (!(satisfied = done()) && !expired) {
+        g_main_context_iteration(context, TRUE);
+    }
+
+    g_source_destroy(deadline);
+    g_source_unref(deadline);
+    return satisfied;
+}
+
+} // namespace TestSupport
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition \
+                      << std::endl;                                                   \
+            ++TestSupport::failureCount();                                            \
+        }                                                                             \
+    } while (0)
+
+#define TEST_RESULT() (TestSupport::failureCount() == 0 ? 0 : 1)
+
+#endif // TEST_SUPPORT_H
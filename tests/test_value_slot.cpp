@@ -0,0 +1,107 @@
+#include "value_slot.h"
+#include "test_support.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Bluetooth;
+
+static ByteValue encodeCounter(uint64_t counter) {
+    ByteValue value(sizeof(counter), 0);
+    std::memcpy(value.data(), &counter, sizeof(counter));
+    return value;
+}
+
+static uint64_t decodeCounter(const ByteValue& value) {
+    uint64_t counter = 0;
+    if (value.size() == sizeof(counter)) {
+        std::memcpy(&counter, value.data(), sizeof(counter));
+    }
+    return counter;
+}
+
+// 连续发布只保证送达最新值
+static void testLatestValueDelivered() {
+    GMainContext* context = g_main_context_new();
+    auto slot = std::make_shared<ValueSlot>(16);
+    uint64_t latest = 0;
+    size_t callbacks = 0;
+    ValueSlotWatch watch(slot, [&](const ByteValue& value) {
+        latest = decodeCounter(value);
+        ++callbacks;
+    }, context);
+
+    for (uint64_t i = 1; i <= 100; ++i) {
+        CHECK(slot->publish(encodeCounter(i)));
+    }
+    CHECK(!slot->publish(ByteValue(17, 0)));
+
+    CHECK(TestSupport::runUntil([&]() { return latest == 100; }, 1000, context));
+    CHECK(callbacks >= 1 && callbacks <= 100);
+
+    g_main_context_unref(context);
+}
+
+// 多个生产者线程各自向一个值槽发布，主循环确认后才发布下一个值（一问一答）。
+// 每一轮都需要一次唤醒，没有周期定时器兜底，丢失的唤醒会让某个生产者停住直到期限
+static void testPingPongWakeups() {
+    const size_t producer_count = 4;
+    const uint64_t rounds = 50000;
+
+    GMainContext* context = g_main_context_new();
+    std::vector<std::shared_ptr<ValueSlot>> slots;
+    std::vector<std::unique_ptr<ValueSlotWatch>> watches;
+    std::unique_ptr<std::atomic<uint64_t>[]> acknowledged(new std::atomic<uint64_t>[producer_count]);
+    std::atomic<bool> stop(false);
+
+    for (size_t i = 0; i < producer_count; ++i) {
+        acknowledged[i].store(0);
+        slots.push_back(std::make_shared<ValueSlot>(sizeof(uint64_t)));
+        watches.push_back(std::make_unique<ValueSlotWatch>(slots[i], [&acknowledged, i](const ByteValue& value) {
+            acknowledged[i].store(decodeCounter(value), std::memory_order_release);
+        }, context));
+    }
+
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producer_count; ++i) {
+        producers.emplace_back([&, i]() {
+            for (uint64_t round = 1; round <= rounds && !stop.load(); ++round) {
+                slots[i]->publish(encodeCounter(round));
+                while (acknowledged[i].load(std::memory_order_acquire) != round && !stop.load()) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    bool finished = TestSupport::runUntil([&]() {
+        for (size_t i = 0; i < producer_count; ++i) {
+            if (acknowledged[i].load(std::memory_order_acquire) != rounds) {
+                return false;
+            }
+        }
+        return true;
+    }, 30000, context);
+    CHECK(finished);
+
+    stop.store(true);
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    if (!finished) {
+        for (size_t i = 0; i < producer_count; ++i) {
+            std::cerr << "producer " << i << " stalled at round " << acknowledged[i].load() << std::endl;
+        }
+    }
+
+    watches.clear();
+    g_main_context_unref(context);
+}
+
+int main() {
+    testLatestValueDelivered();
+    testPingPongWakeups();
+    return TEST_RESULT();
+}
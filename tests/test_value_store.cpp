@@ -0,0 +1,102 @@
+#include "value_store.h"
+#include "test_support.h"
+#include <unistd.h>
+#include <string>
+
+using namespace Bluetooth;
+
+static const char* const UUID_A = "0000dddd-0000-1000-8000-00805f9b34fb";
+static const char* const UUID_B = "0000ddde-0000-1000-8000-00805f9b34fb";
+
+static void removeStore(const std::string& directory) {
+    unlink((directory + "/values.log").c_str());
+    unlink((directory + "/values.snapshot").c_str());
+    rmdir(directory.c_str());
+}
+
+// 压缩前先提交缓冲中的记录，重新打开后所有写入都能恢复
+static void testCompactFlushesPending() {
+    gchar* temp = g_dir_make_tmp("value-store-XXXXXX", nullptr);
+    CHECK(temp != nullptr);
+    if (!temp) {
+        return;
+    }
+    std::string directory(temp);
+    g_free(temp);
+
+    ValueStoreConfig config;
+    config.commit_interval_ms = 60000;
+    {
+        ValueStore store(directory, config);
+        CHECK(store.open());
+
+        ByteValue first{ 1, 2, 3 };
+        CHECK(store.append(UUID_A, first.data(), first.size()));
+        CHECK(store.commit());
+
+        // 只在缓冲中，尚未提交
+        ByteValue second{ 4, 5 };
+        ByteValue other{ 6 };
+        CHECK(store.append(UUID_A, second.data(), second.size()));
+        CHECK(store.append(UUID_B, other.data(), other.size()));
+        CHECK(store.getStatistics().commits == 1);
+
+        CHECK(store.compact());
+        CHECK(store.getStatistics().commits == 2);
+        CHECK(store.getStatistics().compactions == 1);
+    }
+
+    ValueStore reopened(directory, config);
+    CHECK(reopened.open());
+    ByteValue value;
+    CHECK(reopened.lookup(UUID_A, value));
+    CHECK(value == (ByteValue{ 4, 5 }));
+    CHECK(reopened.lookup(UUID_B, value));
+    CHECK(value == (ByteValue{ 6 }));
+    CHECK(reopened.getStatistics().discarded_bytes == 0);
+    reopened.close();
+
+    removeStore(directory);
+}
+
+// 日志超过阈值时提交后自动压缩，压缩不会递归提交
+static void testCommitTriggersCompaction() {
+    gchar* temp = g_dir_make_tmp("value-store-XXXXXX", nullptr);
+    CHECK(temp != nullptr);
+    if (!temp) {
+        return;
+    }
+    std::string directory(temp);
+    g_free(temp);
+
+    ValueStoreConfig config;
+    config.commit_interval_ms = 60000;
+    config.compaction_threshold_bytes = 256;
+    {
+        ValueStore store(directory, config);
+        CHECK(store.open());
+
+        ByteValue payload(64, 0x5a);
+        for (uint8_t i = 0; i < 8; ++i) {
+            payload[0] = i;
+            CHECK(store.append(UUID_A, payload.data(), payload.size()));
+            CHECK(store.commit());
+        }
+        CHECK(store.getStatistics().compactions >= 1);
+    }
+
+    ValueStore reopened(directory, config);
+    CHECK(reopened.open());
+    ByteValue value;
+    CHECK(reopened.lookup(UUID_A, value));
+    CHECK(value.size() == 64 && value[0] == 7);
+    reopened.close();
+
+    removeStore(directory);
+}
+
+int main() {
+    testCompactFlushesPending();
+    testCommitTriggersCompaction();
+    return TEST_RESULT();
+}
@@ -0,0 +1,181 @@
+#include "write_assembler.h"
+#include "gatt_characteristic.h"
+#include "test_support.h"
+#include <algorithm>
+
+using namespace Bluetooth;
+
+static const char* const DEVICE_PATH = "/org/bluez/hci0/dev_00_11_22_33_44_55";
+
+// 预备阶段组装，执行阶段首个片段交出完整的值，之后的片段只确认
+static void testPrepareThenExecute() {
+    WriteAssembler assembler;
+    ByteValue first{ 1, 2, 3, 4 };
+    ByteValue second{ 5, 6 };
+
+    CHECK(assembler.addFragment(DEVICE_PATH, 0, first.data(), first.size()) == WriteFragmentStatus::ACCEPTED);
+    CHECK(assembler.addFragment(DEVICE_PATH, 4, second.data(), second.size()) == WriteFragmentStatus::ACCEPTED);
+
+    ByteValue value;
+    CHECK(assembler.executeFragment(DEVICE_PATH, 0, first.data(), first.size(), value) ==
+          WriteFragmentStatus::COMPLETE);
+    CHECK(value == (ByteValue{ 1, 2, 3, 4, 5, 6 }));
+    CHECK(assembler.isAssembling(DEVICE_PATH));
+
+    ByteValue unused;
+    CHECK(assembler.executeFragment(DEVICE_PATH, 4, second.data(), second.size(), unused) ==
+          WriteFragmentStatus::ACCEPTED);
+    CHECK(!assembler.isAssembling(DEVICE_PATH));
+
+    WriteAssemblyStatistics stats = assembler.getStatistics();
+    CHECK(stats.committed == 1);
+    CHECK(stats.fragments == 4);
+}
+
+// 空洞和超长在预备阶段即被拒绝
+static void testInvalidFragments() {
+    WriteAssemblyConfig config;
+    config.max_value_size = 8;
+    WriteAssembler assembler;
+    assembler.setConfig(config);
+
+    ByteValue data(4, 0xaa);
+    CHECK(assembler.addFragment(DEVICE_PATH, 2, data.data(), data.size()) == WriteFragmentStatus::INVALID_OFFSET);
+    CHECK(assembler.addFragment(DEVICE_PATH, 0, data.data(), data.size()) == WriteFragmentStatus::ACCEPTED);
+    CHECK(assembler.addFragment(DEVICE_PATH, 6, data.data(), data.size()) == WriteFragmentStatus::INVALID_OFFSET);
+    CHECK(assembler.addFragment(DEVICE_PATH, 4, data.data(), data.size()) == WriteFragmentStatus::ACCEPTED);
+    CHECK(assembler.addFragment(DEVICE_PATH, 8, data.data(), 1) == WriteFragmentStatus::INVALID_LENGTH);
+    CHECK(assembler.getStatistics().rejected == 3);
+
+    // 执行的片段超出预备范围时丢弃整个长写
+    ByteValue value;
+    CHECK(assembler.executeFragment(DEVICE_PATH, 6, data.data(), data.size(), value) ==
+          WriteFragmentStatus::INVALID_OFFSET);
+    CHECK(!assembler.isAssembling(DEVICE_PATH));
+}
+
+// 没有预备阶段时偏移为0的执行片段就是完整的值
+static void testExecuteWithoutPrepare() {
+    WriteAssembler assembler;
+    ByteValue data{ 9, 8, 7 };
+    ByteValue value;
+
+    CHECK(assembler.executeFragment(DEVICE_PATH, 0, data.data(), data.size(), value) ==
+          WriteFragmentStatus::COMPLETE);
+    CHECK(value == data);
+    CHECK(!assembler.isAssembling(DEVICE_PATH));
+    CHECK(assembler.executeFragment(DEVICE_PATH, 3, data.data(), data.size(), value) ==
+          WriteFragmentStatus::INVALID_OFFSET);
+}
+
+// 超时由定时器回收，不等待下一个片段，也从不提交
+static void testAbandonedByTimer() {
+    WriteAssemblyConfig config;
+    config.abandon_ms = 50;
+    WriteAssembler assembler;
+    assembler.setConfig(config);
+
+    ByteValue data{ 1 };
+    CHECK(assembler.addFragment(DEVICE_PATH, 0, data.data(), data.size()) == WriteFragmentStatus::ACCEPTED);
+    CHECK(TestSupport::runUntil([&]() { return !assembler.isAssembling(DEVICE_PATH); }, 1000));
+
+    WriteAssemblyStatistics stats = assembler.getStatistics();
+    CHECK(stats.abandoned == 1);
+    CHECK(stats.committed == 0);
+}
+
+// 公开受保护的WriteValue处理入口
+class TestCharacteristic : public GattCharacteristic {
+public:
+    TestCharacteristic()
+        : GattCharacteristic("0000eeee-0000-1000-8000-00805f9b34fb",
+                             { CharacteristicFlags::READ, CharacteristicFlags::WRITE,
+                               CharacteristicFlags::RELIABLE_WRITE }) {
+    }
+
+    bool write(const ByteValue& data, uint16_t offset, bool prepare) {
+        GVariantBuilder builder;
+        g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sv}"));
+        g_variant_builder_add(&builder, "{sv}", "device", g_variant_new_object_path(DEVICE_PATH));
+        g_variant_builder_add(&builder, "{sv}", "offset", g_variant_new_uint16(offset));
+        g_variant_builder_add(&builder, "{sv}", "type", g_variant_new_string("reliable"));
+        if (prepare) {
+            g_variant_builder_add(&builder, "{sv}", "prepare-authorize", g_variant_new_boolean(TRUE));
+        }
+        GVariant* options = g_variant_ref_sink(g_variant_builder_end(&builder));
+        GVariant* value = g_variant_ref_sink(
+            g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, data.data(), data.size(), sizeof(uint8_t)));
+
+        bool result = handleWriteValue(value, options);
+        g_variant_unref(value);
+        g_variant_unref(options);
+        return result;
+    }
+};
+
+// 回调在回复执行片段之前校验完整的值，拒绝时该片段返回错误，值不变
+static void testCallbackRejectionReachesClient() {
+    TestCharacteristic characteristic;
+    std::vector<std::string> flags = characteristic.getFlags();
+    CHECK(std::find(flags.begin(), flags.end(), "authorize") != flags.end());
+
+    bool accept = false;
+    size_t calls = 0;
+    characteristic.setWriteCallback([&](const std::string&, const ByteValue& value) {
+        ++calls;
+        CHECK(value.size() == 6);
+        return accept;
+    });
+
+    ByteValue first{ 1, 2, 3, 4 };
+    ByteValue second{ 5, 6 };
+    CHECK(characteristic.write(first, 0, true));
+    CHECK(characteristic.write(second, 4, true));
+    CHECK(calls == 0);
+    CHECK(!characteristic.write(first, 0, false));
+    CHECK(calls == 1);
+    CHECK(characteristic.getValue().empty());
+
+    accept = true;
+    CHECK(characteristic.write(first, 0, true));
+    CHECK(characteristic.write(second, 4, true));
+    CHECK(characteristic.write(first, 0, false));
+    CHECK(characteristic.write(second, 4, false));
+    CHECK(calls == 2);
+    CHECK(characteristic.getValue() == (ByteValue{ 1, 2, 3, 4, 5, 6 }));
+}
+
+static bool hasAuthorize(const GattCharacteristic& characteristic) {
+    std::vector<std::string> flags = characteristic.getFlags();
+    return std::find(flags.begin(), flags.end(), "authorize") != flags.end();
+}
+
+// 普通可写特征值默认不组装，Flags不带authorize；配置组装后才启用
+static void testAuthorizeOptIn() {
+    GattCharacteristic writable("0000eeef-0000-1000-8000-00805f9b34fb",
+                                { CharacteristicFlags::READ, CharacteristicFlags::WRITE });
+    CHECK(!hasAuthorize(writable));
+
+    WriteAssemblyConfig config;
+    config.max_value_size = 128;
+    writable.setWriteAssemblyConfig(config);
+    CHECK(hasAuthorize(writable));
+
+    GattCharacteristic reliable("0000eef0-0000-1000-8000-00805f9b34fb",
+                                { CharacteristicFlags::WRITE, CharacteristicFlags::RELIABLE_WRITE });
+    CHECK(hasAuthorize(reliable));
+
+    GattCharacteristic readonly("0000eef1-0000-1000-8000-00805f9b34fb", { CharacteristicFlags::READ });
+    readonly.setWriteAssemblyConfig(config);
+    CHECK(!hasAuthorize(readonly));
+}
+
+int main() {
+    testPrepareThenExecute();
+    testInvalidFragments();
+    testExecuteWithoutPrepare();
+    testAbandonedByTimer();
+    testCallbackRejectionReachesClient();
+    testAuthorizeOptIn();
+    return TEST_RESULT();
+}
@@ -0,0 +1,124 @@
+#include "gatt_characteristic.h"
+#include "test_support.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Bluetooth;
+
+static const char* const DEVICE_PATH = "/org/bluez/hci0/dev_00_11_22_33_44_55";
+
+static std::shared_ptr<GattCharacteristic> makeCharacteristic() {
+    return std::make_shared<GattCharacteristic>("0000ffff-0000-1000-8000-00805f9b34fb",
+        std::vector<CharacteristicFlags>{ CharacteristicFlags::READ,
+                                          CharacteristicFlags::WRITE_WITHOUT_RESPONSE });
+}
+
+static bool sendDatagram(int fd, const ByteValue& value) {
+    return send(fd, value.data(), value.size(), 0) == static_cast<ssize_t>(value.size());
+}
+
+// 套接字写入交给异步写入回调，接受后才保存；拒绝的写入和较晚完成的旧写入不改变值
+static void testAsyncCallbackReceivesSocketWrites() {
+    auto characteristic = makeCharacteristic();
+    size_t sync_calls = 0;
+    characteristic->setWriteCallback([&](const std::string&, const ByteValue&) {
+        ++sync_calls;
+        return true;
+    });
+
+    std::vector<WriteCompletion> completions;
+    std::vector<ByteValue> received;
+    characteristic->setAsyncWriteCallback([&](const ByteView& value, const AccessOptions& options,
+                                              WriteCompletion completion) {
+        CHECK(options.device == DEVICE_PATH);
+        CHECK(options.type == "command");
+        received.push_back(value.toByteValue());
+        completions.push_back(completion);
+    });
+
+    int fd = characteristic->acquireWrite(DEVICE_PATH, 64);
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+
+    CHECK(sendDatagram(fd, ByteValue{ 1 }));
+    CHECK(sendDatagram(fd, ByteValue{ 2 }));
+    CHECK(TestSupport::runUntil([&]() { return completions.size() == 2; }, 1000));
+    CHECK(received.size() == 2 && received[0] == (ByteValue{ 1 }) && received[1] == (ByteValue{ 2 }));
+    CHECK(characteristic->getValue().empty());
+
+    CHECK(completions[1].accept());
+    CHECK(TestSupport::runUntil([&]() { return characteristic->getValue() == (ByteValue{ 2 }); }, 1000));
+
+    // 较早的数据报较晚完成，不覆盖较新的值
+    CHECK(completions[0].accept());
+    while (g_main_context_iteration(nullptr, FALSE)) {
+    }
+    CHECK(characteristic->getValue() == (ByteValue{ 2 }));
+
+    CHECK(sendDatagram(fd, ByteValue{ 3 }));
+    CHECK(TestSupport::runUntil([&]() { return completions.size() == 3; }, 1000));
+    CHECK(completions[2].reject());
+    while (g_main_context_iteration(nullptr, FALSE)) {
+    }
+    CHECK(characteristic->getValue() == (ByteValue{ 2 }));
+    CHECK(sync_calls == 0);
+
+    close(fd);
+    characteristic->releaseWrite();
+}
+
+// 有执行器时套接字写入在执行器中调用回调，队列已满时整批丢弃，不在主循环中同步调用
+static void testExecutorReceivesSocketWrites() {
+    GMainContext* work_context = g_main_context_new();
+    ExecutorConfig config;
+    config.max_queue_depth = 2;
+    auto executor = std::make_shared<CallbackExecutor>(work_context, config);
+
+    auto characteristic = makeCharacteristic();
+    characteristic->setCallbackExecutor(executor);
+    std::vector<ByteValue> received;
+    characteristic->setWriteCallback([&](const std::string& device, const ByteValue& value) {
+        CHECK(device == DEVICE_PATH);
+        received.push_back(value);
+        return value[0] != 2;
+    });
+
+    int fd = characteristic->acquireWrite(DEVICE_PATH, 64);
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        g_main_context_unref(work_context);
+        return;
+    }
+
+    // 每批数据报提交为一个任务，应用上下文不迭代时任务一直排队
+    for (uint8_t i = 1; i <= 3; ++i) {
+        CHECK(sendDatagram(fd, ByteValue{ i }));
+        CHECK(TestSupport::runUntil([&]() {
+            ExecutorStatistics stats = executor->getStatistics();
+            return stats.queued + stats.rejected == i;
+        }, 1000));
+    }
+    CHECK(received.empty());
+    CHECK(executor->getStatistics().rejected == 1);
+
+    // 第一批被接受，第二批被拒绝，第三批已丢弃
+    while (g_main_context_iteration(work_context, FALSE)) {
+    }
+    CHECK(received.size() == 2);
+    CHECK(TestSupport::runUntil([&]() { return characteristic->getValue() == (ByteValue{ 1 }); }, 1000));
+
+    close(fd);
+    characteristic->releaseWrite();
+    characteristic.reset();
+    executor.reset();
+    g_main_context_unref(work_context);
+}
+
+int main() {
+    testAsyncCallbackReceivesSocketWrites();
+    testExecutorReceivesSocketWrites();
+    return TEST_RESULT();
+}